@@ -4,7 +4,7 @@ SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
 
 sudo apt-get update
 
-sudo DEBIAN_FRONTEND=noninteractive apt-get install -y build-essential cmake libmysqlcppconn-dev vim \
+sudo DEBIAN_FRONTEND=noninteractive apt-get install -y build-essential cmake libmysqlcppconn-dev zlib1g-dev vim \
     emacs tree tmux git gdb valgrind python3-dev libffi-dev libssl-dev mysql-server \
     clang-format clang-tidy iperf3 tshark iproute2 iputils-ping net-tools tcpdump cppcheck python-is-python3 \
     cloc siege libboost-all-dev curl llvm
@@ -14,8 +14,10 @@
 #include <cstdlib>
 #include <utility>
 
+#include "core/client_limiter.h"
 #include "core/connection.h"
 #include "core/looper.h"
+#include "core/metrics.h"
 #include "core/net_address.h"
 #include "core/poller.h"
 #include "core/socket.h"
@@ -23,6 +25,9 @@
 
 namespace TURTLE_SERVER {
 
+static const Counter connections_refused_total = MetricsRegistry::GetInstance().AddCounter(
+    "turtle_connections_refused_total", "Connections refused for the client being over its connection cap");
+
 Acceptor::Acceptor(Looper *listener, std::vector<Looper *> reactors, NetAddress server_address)
     : reactors_(std::move(reactors)) {
   auto acceptor_sock = std::make_unique<Socket>();
@@ -47,13 +52,33 @@ void Acceptor::BaseAcceptCallback(Connection *server_conn) {
     return;
   }
   auto client_sock = std::make_unique<Socket>(accept_fd);
+  auto client_ip = client_address.GetIp();
+  if (limiter_ != nullptr && !limiter_->TryConnect(client_ip)) {
+    // dropped before it ever reaches a reactor, and logged sparsely, since a flood of them is what the cap is for
+    connections_refused_total.Inc();
+    refused_unlogged_++;
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_refusal_log_ >= REFUSAL_LOG_INTERVAL) {
+      LOG_WARNING("{} connections over the cap refused, latest from client {}", refused_unlogged_, client_ip);
+      last_refusal_log_ = now;
+      refused_unlogged_ = 0;
+    }
+    return;
+  }
   client_sock->SetNonBlocking();
   auto client_connection = std::make_unique<Connection>(std::move(client_sock));
   client_connection->SetEvents(POLL_READ | POLL_ET);  // edge-trigger for client
-  client_connection->SetCallback(GetCustomHandleCallback());
+  client_connection->SetPeerIp(client_ip);
+  if (limiter_ != nullptr) {
+    // counted out once the connection is destroyed, however it ends
+    std::shared_ptr<void> slot(nullptr, [limiter = limiter_, client_ip](void *) { limiter->Disconnect(client_ip); });
+    client_connection->SetCallback([slot, callback = GetCustomHandleCallback()](Connection *conn) { callback(conn); });
+  } else {
+    client_connection->SetCallback(GetCustomHandleCallback());
+  }
   // randomized distribution. uniform in long term.
   int idx = rand() % reactors_.size();  // NOLINT
-  LOG_INFO("new client fd=" + std::to_string(client_connection->GetFd()) + " maps to reactor " + std::to_string(idx));
+  LOG_INFO("new client fd={} maps to reactor {}", client_connection->GetFd(), idx);
   client_connection->SetLooper(reactors_[idx]);
   reactors_[idx]->AddConnection(std::move(client_connection));
 }
@@ -88,6 +113,8 @@ auto Acceptor::GetCustomHandleCallback() const noexcept -> std::function<void(Co
   return custom_handle_callback_;
 }
 
+void Acceptor::SetClientLimiter(std::shared_ptr<ClientLimiter> limiter) { limiter_ = std::move(limiter); }
+
 auto Acceptor::GetAcceptorConnection() noexcept -> Connection * { return acceptor_conn.get(); }
 
 }  // namespace TURTLE_SERVER
@@ -0,0 +1,99 @@
+/**
+ * @file alloc_tracker.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the per-thread heap allocation
+ * counts, along with the counting operator new and delete under ALLOC_TRACKING
+ */
+
+#include "core/alloc_tracker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace TURTLE_SERVER {
+
+/* plain old data, so that it is never lazily constructed, which might allocate by itself */
+static thread_local AllocationStats local_allocation_stats;
+
+auto LocalAllocationStats() noexcept -> AllocationStats { return local_allocation_stats; }
+
+#ifdef ALLOC_TRACKING
+static auto Allocate(std::size_t size) -> void * {
+  size = size == 0 ? 1 : size;
+  while (true) {
+    void *ptr = std::malloc(size);  // NOLINT
+    if (ptr != nullptr) {
+      local_allocation_stats.allocations_++;
+      local_allocation_stats.bytes_ += size;
+      return ptr;
+    }
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+static auto AllocateAligned(std::size_t size, std::align_val_t alignment) -> void * {
+  size = size == 0 ? 1 : size;
+  while (true) {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, std::max(static_cast<std::size_t>(alignment), sizeof(void *)), size) == 0) {
+      local_allocation_stats.allocations_++;
+      local_allocation_stats.bytes_ += size;
+      return ptr;
+    }
+    auto handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+static void Deallocate(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    local_allocation_stats.deallocations_++;
+    std::free(ptr);  // NOLINT
+  }
+}
+#endif
+
+}  // namespace TURTLE_SERVER
+
+#ifdef ALLOC_TRACKING
+/* the replaceable global allocation functions, every other form of which forwards to these ones */
+auto operator new(std::size_t size) -> void * { return TURTLE_SERVER::Allocate(size); }
+
+auto operator new[](std::size_t size) -> void * { return TURTLE_SERVER::Allocate(size); }
+
+auto operator new(std::size_t size, std::align_val_t alignment) -> void * {
+  return TURTLE_SERVER::AllocateAligned(size, alignment);
+}
+
+auto operator new[](std::size_t size, std::align_val_t alignment) -> void * {
+  return TURTLE_SERVER::AllocateAligned(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete[](void *ptr) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete[](void *ptr, std::size_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete[](void *ptr, std::align_val_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept { TURTLE_SERVER::Deallocate(ptr); }
+#endif
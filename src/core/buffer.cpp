@@ -10,6 +10,9 @@
  */
 
 #include "core/buffer.h"
+
+#include <algorithm>
+
 namespace TURTLE_SERVER {
 
 Buffer::Buffer(size_t initial_capacity) { buf_.reserve(initial_capacity); }
@@ -18,8 +21,8 @@ void Buffer::Append(const unsigned char *new_char_data, size_t data_size) {
   buf_.insert(buf_.end(), new_char_data, new_char_data + data_size);
 }
 
-void Buffer::Append(const std::string &new_str_data) {
-  Append(reinterpret_cast<const unsigned char *>(new_str_data.c_str()), new_str_data.size());
+void Buffer::Append(std::string_view new_str_data) {
+  Append(reinterpret_cast<const unsigned char *>(new_str_data.data()), new_str_data.size());
 }
 
 void Buffer::Append(std::vector<unsigned char> &&other_buffer) {
@@ -30,8 +33,8 @@ void Buffer::AppendHead(const unsigned char *new_char_data, size_t data_size) {
   buf_.insert(buf_.begin(), new_char_data, new_char_data + data_size);
 }
 
-void Buffer::AppendHead(const std::string &new_str_data) {
-  AppendHead(reinterpret_cast<const unsigned char *>(new_str_data.c_str()), new_str_data.size());
+void Buffer::AppendHead(std::string_view new_str_data) {
+  AppendHead(reinterpret_cast<const unsigned char *>(new_str_data.data()), new_str_data.size());
 }
 
 auto Buffer::FindAndPopTill(const std::string &target) -> std::optional<std::string> {
@@ -45,6 +48,10 @@ auto Buffer::FindAndPopTill(const std::string &target) -> std::optional<std::str
   return res;
 }
 
+void Buffer::PopHead(size_t pop_size) noexcept {
+  buf_.erase(buf_.begin(), buf_.begin() + static_cast<ptrdiff_t>(std::min(pop_size, buf_.size())));
+}
+
 auto Buffer::Size() const noexcept -> size_t { return buf_.size(); }
 
 auto Buffer::Capacity() const noexcept -> size_t { return buf_.capacity(); }
@@ -26,6 +26,7 @@ Cache::CacheNode::CacheNode() noexcept { UpdateTimestamp(); }
 Cache::CacheNode::CacheNode(std::string identifier, const std::vector<unsigned char> &data)
     : identifier_(std::move(identifier)), data_(data) {
   UpdateTimestamp();
+  inserted_at_ = last_access_;
 }
 
 void Cache::CacheNode::SetIdentifier(const std::string &identifier) { identifier_ = identifier; }
@@ -45,20 +46,39 @@ void Cache::CacheNode::UpdateTimestamp() noexcept { last_access_ = GetTimeUtc();
 
 auto Cache::CacheNode::GetTimestamp() const noexcept -> uint64_t { return last_access_; }
 
-Cache::Cache(size_t capacity) noexcept
-    : capacity_(capacity), header_(std::make_unique<CacheNode>()), tailer_(std::make_unique<CacheNode>()) {
+auto Cache::CacheNode::GetInsertTimestamp() const noexcept -> uint64_t { return inserted_at_; }
+
+Cache::Cache(size_t capacity, uint64_t time_to_live, std::string_view name)
+    : capacity_(capacity),
+      time_to_live_(time_to_live),
+      header_(std::make_unique<CacheNode>()),
+      tailer_(std::make_unique<CacheNode>()) {
   header_->next_ = tailer_.get();
   tailer_->prev_ = header_.get();
+  auto &metrics = MetricsRegistry::GetInstance();
+  auto labels = "cache=\"" + std::string(name) + "\"";
+  hits_ = metrics.AddCounter("turtle_cache_hits_total", "Cache lookups served", labels);
+  misses_ = metrics.AddCounter("turtle_cache_misses_total", "Cache lookups absent or expired", labels);
+  evictions_ = metrics.AddCounter("turtle_cache_evictions_total", "Cache entries evicted for room", labels);
 }
 
 auto Cache::GetOccupancy() const noexcept -> size_t { return occupancy_; }
 
 auto Cache::GetCapacity() const noexcept -> size_t { return capacity_; }
 
+auto Cache::GetTimeToLive() const noexcept -> uint64_t { return time_to_live_; }
+
 auto Cache::TryLoad(const std::string &resource_url, std::vector<unsigned char> &destination) -> bool {
-  std::shared_lock<std::shared_mutex> lock(mtx_);
+  // exclusive, since a hit re-links the node and an expired one is dropped
+  UniqueLock<SharedMutex> lock(mtx_);
   auto iter = mapping_.find(resource_url);
+  if (iter != mapping_.end() && IsExpired(*iter->second)) {
+    RemoveNode(iter);
+    misses_.Inc();
+    return false;
+  }
   if (iter != mapping_.end()) {
+    hits_.Inc();
     iter->second->Serialize(destination);
     // move this node to the tailer as most recently accessed
     RemoveFromList(iter->second);
@@ -66,12 +86,18 @@ auto Cache::TryLoad(const std::string &resource_url, std::vector<unsigned char>
     iter->second->UpdateTimestamp();
     return true;
   }
+  misses_.Inc();
   return false;
 }
 
 auto Cache::TryInsert(const std::string &resource_url, const std::vector<unsigned char> &source) -> bool {
-  std::unique_lock<std::shared_mutex> lock(mtx_);
+  UniqueLock<SharedMutex> lock(mtx_);
   auto iter = mapping_.find(resource_url);
+  if (iter != mapping_.end() && IsExpired(*iter->second)) {
+    // replace the stale one
+    RemoveNode(iter);
+    iter = mapping_.end();
+  }
   if (iter != mapping_.end()) {
     // already exists
     return false;
@@ -100,12 +126,20 @@ void Cache::Clear() {
 
 void Cache::EvictOne() noexcept {
   auto *first_node = header_->next_;
-  auto resource_size = first_node->Size();
   auto iter = mapping_.find(first_node->identifier_);
   assert(iter != mapping_.end());
+  RemoveNode(iter);
+  evictions_.Inc();
+}
+
+void Cache::RemoveNode(std::unordered_map<std::string, std::shared_ptr<CacheNode>>::iterator iter) noexcept {
+  occupancy_ -= iter->second->Size();
   RemoveFromList(iter->second);
   mapping_.erase(iter);
-  occupancy_ -= resource_size;
+}
+
+auto Cache::IsExpired(const CacheNode &node) const noexcept -> bool {
+  return time_to_live_ != NO_EXPIRATION && GetTimeUtc() - node.GetInsertTimestamp() >= time_to_live_;
 }
 
 void Cache::RemoveFromList(const std::shared_ptr<CacheNode> &node) noexcept {
@@ -0,0 +1,113 @@
+/**
+ * @file client_limiter.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the ClientLimiter which caps
+ * the connections and rate limits the requests of each client address
+ */
+
+#include "core/client_limiter.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace TURTLE_SERVER {
+
+static constexpr char LOOPBACK_IPV4_PREFIX[] = {"127."};
+static constexpr char LOOPBACK_IPV6[] = {"::1"};
+
+ClientLimiter::ClientLimiter(ClientLimits limits) : limits_(limits) {}
+
+auto ClientLimiter::TryConnect(const std::string &ip) -> bool {
+  if (limits_.max_connections_per_ip_ == 0 || IsExempted(ip)) {
+    return true;
+  }
+  auto &shard = GetShard(ip);
+  std::unique_lock<std::mutex> lock(shard.mtx_);
+  auto &entry = GetEntry(shard, ip, Clock::now());
+  if (entry.connections_ >= limits_.max_connections_per_ip_) {
+    return false;
+  }
+  entry.connections_++;
+  return true;
+}
+
+void ClientLimiter::Disconnect(const std::string &ip) {
+  if (limits_.max_connections_per_ip_ == 0 || IsExempted(ip)) {
+    return;
+  }
+  auto &shard = GetShard(ip);
+  std::unique_lock<std::mutex> lock(shard.mtx_);
+  auto it = shard.entries_.find(ip);
+  if (it != shard.entries_.end() && it->second.connections_ > 0) {
+    it->second.connections_--;
+  }
+}
+
+auto ClientLimiter::TryRequest(const std::string &ip) -> bool {
+  if (limits_.requests_per_second_ == 0 || IsExempted(ip)) {
+    return true;
+  }
+  auto now = Clock::now();
+  auto &shard = GetShard(ip);
+  std::unique_lock<std::mutex> lock(shard.mtx_);
+  auto &entry = GetEntry(shard, ip, now);
+  Refill(entry, now);
+  if (entry.tokens_ < 1) {
+    return false;
+  }
+  entry.tokens_ -= 1;
+  return true;
+}
+
+auto ClientLimiter::GetConnectionCount(const std::string &ip) -> size_t {
+  auto &shard = GetShard(ip);
+  std::unique_lock<std::mutex> lock(shard.mtx_);
+  auto it = shard.entries_.find(ip);
+  return it == shard.entries_.end() ? 0 : it->second.connections_;
+}
+
+auto ClientLimiter::GetLimits() const noexcept -> const ClientLimits & { return limits_; }
+
+auto ClientLimiter::IsExempted(const std::string &ip) const noexcept -> bool {
+  return limits_.exempt_loopback_ && (ip.rfind(LOOPBACK_IPV4_PREFIX, 0) == 0 || ip == LOOPBACK_IPV6);
+}
+
+auto ClientLimiter::GetShard(const std::string &ip) noexcept -> Shard & {
+  return shards_[std::hash<std::string>{}(ip) & (CLIENT_LIMITER_SHARDS - 1)];
+}
+
+auto ClientLimiter::GetEntry(Shard &shard, const std::string &ip, Clock::time_point now) -> Entry & {
+  auto it = shard.entries_.find(ip);
+  if (it != shard.entries_.end()) {
+    return it->second;
+  }
+  if (shard.entries_.size() >= shard.sweep_at_) {
+    Sweep(shard, now);
+  }
+  return shard.entries_.emplace(ip, Entry{0, limits_.request_burst_, now}).first->second;
+}
+
+void ClientLimiter::Refill(Entry &entry, Clock::time_point now) const noexcept {
+  std::chrono::duration<double> elapsed = now - entry.refilled_at_;
+  entry.tokens_ = std::min(limits_.request_burst_, entry.tokens_ + elapsed.count() * limits_.requests_per_second_);
+  entry.refilled_at_ = now;
+}
+
+void ClientLimiter::Sweep(Shard &shard, Clock::time_point now) {
+  for (auto it = shard.entries_.begin(); it != shard.entries_.end();) {
+    Refill(it->second, now);
+    if (it->second.connections_ == 0 && it->second.tokens_ >= limits_.request_burst_) {
+      it = shard.entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // amortized, so that a shard full of busy clients is not swept upon every new one
+  shard.sweep_at_ = std::max(CLIENT_LIMITER_SWEEP_SIZE, 2 * shard.entries_.size());
+}
+
+}  // namespace TURTLE_SERVER
@@ -10,18 +10,61 @@
  */
 
 #include "core/connection.h"
+#include <fcntl.h>
 #include <sys/socket.h>
+#ifdef OS_LINUX
+#include <sys/sendfile.h>
+#elif OS_MAC
+#include <sys/uio.h>
+#endif
+#include <unistd.h>
+
+#include <algorithm>
 #include <cstring>
+#include <utility>
+
+#include "core/looper.h"
+#include "core/metrics.h"
+#include "core/poller.h"
 #include "log/logger.h"
 namespace TURTLE_SERVER {
 
+#ifdef OS_LINUX
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#elif OS_MAC
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+std::atomic<uint64_t> Connection::next_id{0};
+
+/* the bytes actually read from and written to the sockets, across all the connections */
+static const Counter bytes_in_total =
+    MetricsRegistry::GetInstance().AddCounter("turtle_bytes_in_total", "Bytes read from the connections");
+static const Counter bytes_out_total =
+    MetricsRegistry::GetInstance().AddCounter("turtle_bytes_out_total", "Bytes written to the connections");
+
 Connection::Connection(std::unique_ptr<Socket> socket)
-    : socket_(std::move(socket)), read_buffer_(std::make_unique<Buffer>()), write_buffer_(std::make_unique<Buffer>()) {}
+    : id_(next_id++),
+      socket_(std::move(socket)),
+      read_buffer_(std::make_unique<Buffer>()),
+      write_buffer_(std::make_unique<Buffer>()) {}
+
+Connection::~Connection() {
+  for (const auto &tail : file_tails_) {
+    close(tail.fd_);
+  }
+}
 
 auto Connection::GetFd() const noexcept -> int { return socket_->GetFd(); }
 
 auto Connection::GetSocket() noexcept -> Socket * { return socket_.get(); }
 
+auto Connection::GetId() const noexcept -> uint64_t { return id_; }
+
+void Connection::SetPeerIp(std::string peer_ip) { peer_ip_ = std::move(peer_ip); }
+
+auto Connection::GetPeerIp() const noexcept -> const std::string & { return peer_ip_; }
+
 void Connection::SetEvents(uint32_t events) { events_ = events; }
 
 auto Connection::GetEvents() const noexcept -> uint32_t { return events_; }
@@ -44,6 +87,8 @@ auto Connection::GetReadBufferSize() const noexcept -> size_t { return read_buff
 
 auto Connection::GetWriteBufferSize() const noexcept -> size_t { return write_buffer_->Size(); }
 
+auto Connection::GetPendingSize() const noexcept -> size_t { return write_buffer_->Size() + file_tails_size_; }
+
 void Connection::WriteToReadBuffer(const unsigned char *buf, size_t size) { read_buffer_->Append(buf, size); }
 
 void Connection::WriteToWriteBuffer(const unsigned char *buf, size_t size) { write_buffer_->Append(buf, size); }
@@ -56,6 +101,8 @@ void Connection::WriteToWriteBuffer(std::vector<unsigned char> &&other_buf) {
   write_buffer_->Append(std::move(other_buf));
 }
 
+auto Connection::GetWriteBuffer() noexcept -> Buffer * { return write_buffer_.get(); }
+
 auto Connection::Read() const noexcept -> const unsigned char * { return read_buffer_->Data(); }
 
 auto Connection::ReadAsString() const noexcept -> std::string {
@@ -70,8 +117,10 @@ auto Connection::Recv() -> std::pair<ssize_t, bool> {
   unsigned char buf[TEMP_BUF_SIZE + 1];
   memset(buf, 0, sizeof(buf));
   while (true) {
-    ssize_t curr_read = recv(from_fd, buf, TEMP_BUF_SIZE, 0);
+    // read() instead of recv(), so that a pipe could be monitored as a connection as well
+    ssize_t curr_read = ::read(from_fd, buf, TEMP_BUF_SIZE);
     if (curr_read > 0) {
+      bytes_in_total.Inc(curr_read);
       read += curr_read;
       WriteToReadBuffer(buf, curr_read);
       memset(buf, 0, sizeof(buf));
@@ -93,32 +142,193 @@ auto Connection::Recv() -> std::pair<ssize_t, bool> {
 }
 
 void Connection::Send() {
-  // robust write
-  ssize_t curr_write = 0;
-  ssize_t write;
-  const ssize_t to_write = GetWriteBufferSize();
-  const unsigned char *buf = write_buffer_->Data();
-  while (curr_write < to_write) {
-    write = send(GetFd(), buf + curr_write, to_write - curr_write, 0);
-    if (write <= 0) {
-      if (errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK) {
-        LOG_ERROR("Error in Connection::Send()");
-        ClearWriteBuffer();
-        return;
+  bool failed = false;
+  while (true) {
+    // the buffered bytes are sent up to the first file tail, which goes right after them
+    size_t to_write = file_tails_.empty() ? GetWriteBufferSize() : file_tails_.front().position_;
+    size_t curr_write = 0;
+    const unsigned char *buf = write_buffer_->Data();
+    while (curr_write < to_write) {
+      ssize_t write = send(GetFd(), buf + curr_write, to_write - curr_write, SEND_FLAGS);
+      if (write > 0) {
+        bytes_out_total.Inc(write);
+        curr_write += write;
+      } else if (write == -1 && errno == EINTR) {
+        // normal interrupt
+        continue;
+      } else if (write == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // the socket is full, never spin on it
+        break;
+      } else {
+        failed = true;
+        break;
       }
-      write = 0;
     }
-    curr_write += write;
+    write_buffer_->PopHead(curr_write);
+    bytes_sent_ += curr_write;
+    for (auto &tail : file_tails_) {
+      tail.position_ -= curr_write;
+    }
+    if (failed || curr_write < to_write || file_tails_.empty()) {
+      break;
+    }
+    auto &tail = file_tails_.front();
+    auto remaining = tail.remaining_;
+    failed = !SendFromFile(tail.fd_, tail.offset_, tail.remaining_);
+    file_tails_size_ -= remaining - tail.remaining_;
+    if (failed || tail.remaining_ > 0) {
+      break;
+    }
+    close(tail.fd_);
+    file_tails_.pop_front();
+  }
+  if (failed) {
+    // the client is gone, or a file is cut short, nothing pending could be delivered in order anymore
+    LOG_ERROR("Error in Connection::Send()");
+    DropPending();
+  }
+  UpdateWriteState();
+}
+
+auto Connection::SendFile(int file_fd, off_t offset, size_t count) -> bool {
+  // zero-copy write, straight away unless something is still pending before it
+  Send();
+  size_t remaining = count;
+  bool failed = GetPendingSize() == 0 && !SendFromFile(file_fd, offset, remaining);
+  if (!failed && remaining == 0) {
+    return true;
+  }
+  // a duplicate, since the caller closes its fd once the response is written
+  int tail_fd = failed ? -1 : fcntl(file_fd, F_DUPFD_CLOEXEC, 0);
+  if (tail_fd == -1) {
+    // a response cut short midway, the bytes written after it would be taken as its body
+    LOG_ERROR("Error in Connection::SendFile()");
+    DropPending();
+    UpdateWriteState();
+    SetClosing();
+    return false;
+  }
+  file_tails_.push_back({tail_fd, offset, remaining, GetWriteBufferSize()});
+  file_tails_size_ += remaining;
+  UpdateWriteState();
+  return true;
+}
+
+#ifdef OS_LINUX
+auto Connection::SendFromFile(int file_fd, off_t &offset, size_t &remaining) -> bool {  // NOLINT
+  while (remaining > 0) {
+    ssize_t write = sendfile(GetFd(), file_fd, &offset, remaining);
+    if (write > 0) {
+      bytes_out_total.Inc(write);
+      bytes_sent_ += write;
+      remaining -= write;
+    } else if (write == -1 && errno == EINTR) {
+      continue;
+    } else if (write == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      return false;
+    }
   }
+  return true;
+}
+#elif OS_MAC
+auto Connection::SendFromFile(int file_fd, off_t &offset, size_t &remaining) -> bool {  // NOLINT
+  while (remaining > 0) {
+    off_t write = static_cast<off_t>(remaining);
+    int ret = sendfile(file_fd, GetFd(), offset, &write, nullptr, 0);
+    // a partial write is reported even along with an error
+    offset += write;
+    remaining -= write;
+    bytes_out_total.Inc(write);
+    bytes_sent_ += write;
+    if (ret == -1 && errno == EINTR) {
+      continue;
+    }
+    if (ret == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (ret == -1 || write == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+void Connection::DropPending() noexcept {
+  // still accounted as handed to the write path
+  bytes_sent_ += GetPendingSize();
   ClearWriteBuffer();
 }
 
+void Connection::UpdateWriteState() {
+  bool pending = GetPendingSize() > 0;
+  if (owner_looper_ != nullptr && pending != ((events_ & POLL_WRITE) != 0)) {
+    events_ = pending ? (events_ | POLL_WRITE) : (events_ & ~POLL_WRITE);
+    owner_looper_->UpdateConnection(this);
+  }
+  if (!read_paused_ && GetPendingSize() >= high_watermark_) {
+    read_paused_ = true;
+    if (high_watermark_callback_) {
+      high_watermark_callback_(this);
+    }
+  } else if (read_paused_ && GetPendingSize() <= low_watermark_) {
+    read_paused_ = false;
+    if (low_watermark_callback_) {
+      low_watermark_callback_(this);
+    }
+  }
+}
+
 void Connection::ClearReadBuffer() noexcept { read_buffer_->Clear(); }
 
-void Connection::ClearWriteBuffer() noexcept { write_buffer_->Clear(); }
+void Connection::ClearWriteBuffer() noexcept {
+  write_buffer_->Clear();
+  for (const auto &tail : file_tails_) {
+    close(tail.fd_);
+  }
+  file_tails_.clear();
+  file_tails_size_ = 0;
+}
 
 void Connection::SetLooper(Looper *looper) noexcept { owner_looper_ = looper; }
 
 auto Connection::GetLooper() noexcept -> Looper * { return owner_looper_; }
 
+void Connection::Suspend() noexcept { suspended_ = true; }
+
+void Connection::Resume() noexcept { suspended_ = false; }
+
+auto Connection::IsSuspended() const noexcept -> bool { return suspended_; }
+
+void Connection::SetWatermarks(size_t high_watermark, size_t low_watermark) noexcept {
+  high_watermark_ = high_watermark;
+  low_watermark_ = std::min(low_watermark, high_watermark);
+}
+
+void Connection::SetHighWatermarkCallback(const std::function<void(Connection *)> &callback) {
+  high_watermark_callback_ = callback;
+}
+
+void Connection::SetLowWatermarkCallback(const std::function<void(Connection *)> &callback) {
+  low_watermark_callback_ = callback;
+}
+
+auto Connection::IsReadPaused() const noexcept -> bool { return read_paused_; }
+
+void Connection::IncrementServed() noexcept { served_++; }
+
+auto Connection::GetServedCount() const noexcept -> uint64_t { return served_; }
+
+void Connection::SetResponseStatus(int status) noexcept { response_status_ = status; }
+
+auto Connection::GetResponseStatus() const noexcept -> int { return response_status_; }
+
+auto Connection::GetBytesOut() const noexcept -> uint64_t { return bytes_sent_ + GetPendingSize(); }
+
+void Connection::SetClosing() noexcept { closing_ = true; }
+
+auto Connection::IsClosing() const noexcept -> bool { return closing_; }
+
 }  // namespace TURTLE_SERVER
@@ -11,23 +11,83 @@
 
 #include "core/looper.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+
 #include "core/acceptor.h"
 #include "core/connection.h"
+#include "core/metrics.h"
 #include "core/poller.h"
 #include "core/thread_pool.h"
 #include "log/logger.h"
 namespace TURTLE_SERVER {
 
+/* the client connections across all the loopers, and how long each round takes on how many ready ones */
+static const Gauge connections_gauge =
+    MetricsRegistry::GetInstance().AddGauge("turtle_connections", "Client connections open");
+static const Histogram loop_iteration_histogram = MetricsRegistry::GetInstance().AddHistogram(
+    "turtle_loop_iteration_us", "Time spent on the callbacks of a looper round in microseconds");
+static const Histogram epoll_batch_histogram = MetricsRegistry::GetInstance().AddHistogram(
+    "turtle_epoll_batch_size", "Ready connections returned by a poll", "", 16);
+
+/* the heap traffic of each callback, only declared when tracked */
+static const Histogram callback_allocations_histogram =
+    ALLOC_TRACKING_ENABLED ? MetricsRegistry::GetInstance().AddHistogram(
+                                 "turtle_callback_allocations", "Heap allocations made by a looper callback", "", 16)
+                           : Histogram();
+static const Histogram callback_allocated_bytes_histogram =
+    ALLOC_TRACKING_ENABLED ? MetricsRegistry::GetInstance().AddHistogram(
+                                 "turtle_callback_allocated_bytes", "Heap bytes allocated by a looper callback")
+                           : Histogram();
+
+std::atomic<uint64_t> Looper::next_id{0};
+
+static auto ToMicroseconds(std::chrono::steady_clock::duration duration) noexcept -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+LooperMetrics::LooperMetrics(uint64_t looper_id) {
+  auto &registry = MetricsRegistry::GetInstance();
+  auto labels = "looper=\"" + std::to_string(looper_id) + "\"";
+  poll_time_ = registry.AddCounter("turtle_looper_poll_us_total", "Time a looper spent waiting in the poll", labels);
+  busy_time_ = registry.AddCounter("turtle_looper_busy_us_total", "Time a looper spent on the callbacks", labels);
+  wakeups_ = registry.AddCounter("turtle_looper_wakeups_total", "Returns from the poll of a looper", labels);
+  ready_events_ =
+      registry.AddCounter("turtle_looper_ready_events_total", "Ready connections handled by a looper", labels);
+  slow_callbacks_ = registry.AddCounter("turtle_looper_slow_callbacks_total",
+                                        "Callbacks of a looper running beyond the slow threshold", labels);
+  slowest_callback_ = registry.AddGauge("turtle_looper_slowest_callback_us",
+                                        "The slowest callback of a looper in the last interval", labels);
+  slowest_fd_ = registry.AddGauge("turtle_looper_slowest_callback_fd",
+                                  "The fd the slowest callback of a looper in the last interval ran for", labels);
+}
+
 Looper::Looper(uint64_t timer_expiration)
-    : poller_(std::make_unique<Poller>()), use_timer_(timer_expiration != 0), timer_expiration_(timer_expiration) {
-  if (use_timer_) {
-    poller_->AddConnection(timer_.GetTimerConnection());
-  }
+    : poller_(std::make_unique<Poller>()),
+      use_timer_(timer_expiration != 0),
+      timer_expiration_(timer_expiration),
+      id_(next_id++),
+      metrics_(id_) {
+  // the deadlines need the timer monitored even if the idle expiration is off
+  poller_->AddConnection(timer_.GetTimerConnection());
 }
 
 void Looper::Loop() {
+  auto round_end = std::chrono::steady_clock::now();
+  interval_begin_ = round_end;
+  thread_ = pthread_self();
   while (!exit_) {
     auto ready_connections = poller_->Poll(TIMEOUT);
+    auto round_begin = std::chrono::steady_clock::now();
+    busy_since_.store(round_begin.time_since_epoch().count(), std::memory_order_release);
+    ready_backlog_ = ready_connections.size();
+    epoll_batch_histogram.Record(ready_backlog_);
+    metrics_.poll_time_.Inc(ToMicroseconds(round_begin - round_end));
+    metrics_.wakeups_.Inc();
+    metrics_.ready_events_.Inc(ready_backlog_);
+    // one clock read per callback, each one beginning where the last one ended
+    auto callback_begin = round_begin;
     Connection *timer_conn = nullptr;
     /*
      * subtle details here:
@@ -43,68 +103,239 @@ void Looper::Loop() {
         timer_conn = conn;  // save it for last
         continue;
       }
-      conn->GetCallback()();
+      if (!IsRetired(conn)) {
+        // a connection deleted by its callback is retired, and alive till the end of this round
+        int fd = conn->GetFd();
+        busy_fd_.store(fd, std::memory_order_relaxed);
+        AllocationScope allocations;
+        HandleEvent(conn);
+        callback_begin = AccountCallback(conn, fd, callback_begin, allocations);
+      }
     }
     if (timer_conn != nullptr) {
+      busy_fd_.store(timer_conn->GetFd(), std::memory_order_relaxed);
+      AllocationScope allocations;
       timer_conn->GetCallback()();
+      callback_begin = AccountCallback(timer_conn, timer_conn->GetFd(), callback_begin, allocations);
     }
+    round_end = callback_begin;
+    busy_since_.store(0, std::memory_order_relaxed);
+    auto round_time = ToMicroseconds(round_end - round_begin);
+    round_time_ = round_time / 1000;
+    loop_iteration_histogram.Record(round_time);
+    metrics_.busy_time_.Inc(round_time);
+    if (round_end - interval_begin_ >= SLOWEST_CALLBACK_INTERVAL) {
+      RollInterval(round_end);
+    }
+    UniqueLock<Mutex> lock(mtx_);
+    retired_.clear();
+  }
+}
+
+auto Looper::AccountCallback(Connection *conn, int fd, std::chrono::steady_clock::time_point begin,
+                             const AllocationScope &allocations) -> std::chrono::steady_clock::time_point {
+  auto end = std::chrono::steady_clock::now();
+  if constexpr (ALLOC_TRACKING_ENABLED) {
+    auto allocated = allocations.Get();
+    callback_allocations_histogram.Record(allocated.allocations_);
+    callback_allocated_bytes_histogram.Record(allocated.bytes_);
+  }
+  auto elapsed = ToMicroseconds(end - begin);
+  if (elapsed > interval_slowest_) {
+    interval_slowest_ = elapsed;
+    interval_slowest_fd_ = fd;
+    // a new record shows up right away, rather than at the end of the interval
+    if (elapsed > published_slowest_) {
+      published_slowest_ = elapsed;
+      metrics_.slowest_callback_.Set(static_cast<int64_t>(elapsed));
+      metrics_.slowest_fd_.Set(fd);
+    }
+  }
+  auto threshold = slow_callback_threshold_.load(std::memory_order_relaxed);
+  if (threshold != 0 && elapsed >= threshold) {
+    metrics_.slow_callbacks_.Inc();
+    LOG_WARNING("looper {} spent {}us on the callback of fd={} peer={}", id_, elapsed, fd,
+                conn->GetPeerIp().empty() ? std::string("-") : conn->GetPeerIp());
+  }
+  return end;
+}
+
+void Looper::RollInterval(std::chrono::steady_clock::time_point now) noexcept {
+  published_slowest_ = interval_slowest_;
+  metrics_.slowest_callback_.Set(static_cast<int64_t>(interval_slowest_));
+  metrics_.slowest_fd_.Set(interval_slowest_fd_);
+  interval_slowest_ = 0;
+  interval_slowest_fd_ = -1;
+  interval_begin_ = now;
+}
+
+auto Looper::IsRetired(Connection *conn) noexcept -> bool {
+  UniqueLock<Mutex> lock(mtx_);
+  return std::any_of(retired_.begin(), retired_.end(), [conn](const auto &retired) { return retired.get() == conn; });
+}
+
+void Looper::HandleEvent(Connection *conn) {
+  bool was_paused = conn->IsReadPaused();
+  if (conn->GetPendingSize() > 0) {
+    // upon writability, or an error which fails the write and clears it alike
+    conn->Send();
+  }
+  if (conn->IsClosing()) {
+    if (conn->GetPendingSize() == 0) {
+      DeleteConnection(conn->GetFd());
+    }
+    return;
+  }
+  // a paused client is not read from, and the reads skipped meanwhile are caught up once resumed
+  bool resumed = was_paused && !conn->IsReadPaused();
+  if (resumed || ((conn->GetRevents() & ~POLL_WRITE) != 0 && !conn->IsReadPaused())) {
+    conn->GetCallback()();
   }
 }
 
 void Looper::AddAcceptor(Connection *acceptor_conn) {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   poller_->AddConnection(acceptor_conn);
 }
 
-void Looper::AddConnection(std::unique_ptr<Connection> new_conn) {
-  std::unique_lock<std::mutex> lock(mtx_);
+void Looper::AddWatcher(Connection *watcher_conn) {
+  UniqueLock<Mutex> lock(mtx_);
+  poller_->AddConnection(watcher_conn);
+}
+
+void Looper::AddConnection(std::unique_ptr<Connection> new_conn, bool expire_idle) {
+  UniqueLock<Mutex> lock(mtx_);
   poller_->AddConnection(new_conn.get());
   int fd = new_conn->GetFd();
   connections_.insert({fd, std::move(new_conn)});
-  if (use_timer_) {
+  connections_gauge.Inc();
+  if (use_timer_ && expire_idle) {
     auto single_timer = timer_.AddSingleTimer(timer_expiration_, [this, fd = fd]() {
-      LOG_INFO("client fd=" + std::to_string(fd) + " has expired and will be kicked out");
+      LOG_INFO("client fd={} has expired and will be kicked out", fd);
       DeleteConnection(fd);
     });
     timers_mapping_.insert({fd, single_timer});
   }
 }
 
+auto Looper::FindConnection(int fd) noexcept -> Connection * {
+  UniqueLock<Mutex> lock(mtx_);
+  auto it = connections_.find(fd);
+  return it == connections_.end() ? nullptr : it->second.get();
+}
+
 auto Looper::RefreshConnection(int fd) noexcept -> bool {
   if (!use_timer_) {
     return false;
   }
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   auto it = timers_mapping_.find(fd);
   if (use_timer_ && it != timers_mapping_.end()) {
     auto new_timer = timer_.RefreshSingleTimer(it->second, timer_expiration_);
     if (new_timer != nullptr) {
-      timers_mapping_.insert({fd, new_timer});
+      it->second = new_timer;
     }
     return true;
   }
   return false;
 }
 
+void Looper::UpdateConnection(Connection *conn) {
+  UniqueLock<Mutex> lock(mtx_);
+  auto it = connections_.find(conn->GetFd());
+  if (it != connections_.end() && it->second.get() == conn) {
+    poller_->ModifyConnection(conn);
+  }
+}
+
+void Looper::SetDeadline(int fd, uint64_t expire_from_now, std::function<void()> on_expire) {
+  UniqueLock<Mutex> lock(mtx_);
+  if (connections_.find(fd) == connections_.end() || deadlines_mapping_.find(fd) != deadlines_mapping_.end()) {
+    return;
+  }
+  auto single_timer = timer_.AddSingleTimer(expire_from_now, [this, fd = fd, on_expire = std::move(on_expire)]() {
+    LOG_INFO("client fd={} has missed its deadline and will be kicked out", fd);
+    {
+      UniqueLock<Mutex> lock(mtx_);
+      deadlines_mapping_.erase(fd);
+    }
+    DeleteConnection(fd);
+    if (on_expire) {
+      on_expire();
+    }
+  });
+  deadlines_mapping_.insert({fd, single_timer});
+}
+
+void Looper::ClearDeadline(int fd) noexcept {
+  UniqueLock<Mutex> lock(mtx_);
+  auto it = deadlines_mapping_.find(fd);
+  if (it != deadlines_mapping_.end()) {
+    timer_.RemoveSingleTimer(it->second);
+    deadlines_mapping_.erase(it);
+  }
+}
+
 auto Looper::DeleteConnection(int fd) noexcept -> bool {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   auto it = connections_.find(fd);
   if (it == connections_.end()) {
     return false;
   }
+  poller_->RemoveConnection(it->second.get());
+  // the fd stays open and out of reuse till the end of this round
+  retired_.push_back(std::move(it->second));
   connections_.erase(it);
-  if (use_timer_) {
-    auto timer_it = timers_mapping_.find(fd);
-    if (timer_it != timers_mapping_.end()) {
-      timer_.RemoveSingleTimer(timer_it->second);
-      timers_mapping_.erase(timer_it);
-    } else {
-      LOG_ERROR("Looper: DeleteConnection() the fd " + std::to_string(fd) + " not in timers_mapping_");
-    }
+  connections_gauge.Dec();
+  auto deadline_it = deadlines_mapping_.find(fd);
+  if (deadline_it != deadlines_mapping_.end()) {
+    timer_.RemoveSingleTimer(deadline_it->second);
+    deadlines_mapping_.erase(deadline_it);
+  }
+  // a connection added not to expire when idle has no such timer
+  auto timer_it = timers_mapping_.find(fd);
+  if (timer_it != timers_mapping_.end()) {
+    timer_.RemoveSingleTimer(timer_it->second);
+    timers_mapping_.erase(timer_it);
   }
   return true;
 }
 
+void Looper::CloseConnection(int fd) {
+  auto *conn = FindConnection(fd);
+  if (conn == nullptr) {
+    return;
+  }
+  if (conn->GetPendingSize() == 0) {
+    DeleteConnection(fd);
+    return;
+  }
+  conn->SetClosing();
+  // a client never reading its response should not hold the connection forever
+  SetDeadline(fd, LINGER_TIMEOUT);
+}
+
 void Looper::SetExit() noexcept { exit_ = true; }
 
+void Looper::BeginWork() noexcept { outstanding_work_++; }
+
+void Looper::EndWork() noexcept { outstanding_work_--; }
+
+auto Looper::GetLoad() noexcept -> LooperLoad {
+  UniqueLock<Mutex> lock(mtx_);
+  return {connections_.size(), ready_backlog_, round_time_, outstanding_work_.load()};
+}
+
+auto Looper::GetHeartbeat() const noexcept -> LooperHeartbeat {
+  auto busy_since = busy_since_.load(std::memory_order_acquire);
+  // the thread is published by the release of a nonzero beat, and not to be read before one is seen
+  return {busy_since, busy_fd_.load(std::memory_order_relaxed), busy_since != 0 ? thread_ : pthread_t{}};
+}
+
+auto Looper::GetId() const noexcept -> uint64_t { return id_; }
+
+void Looper::SetSlowCallbackThreshold(uint64_t threshold) noexcept {
+  slow_callback_threshold_.store(threshold, std::memory_order_relaxed);
+}
+
 }  // namespace TURTLE_SERVER
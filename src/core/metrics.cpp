@@ -0,0 +1,211 @@
+/**
+ * @file metrics.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the metrics registry, with the
+ * counters, gauges and latency histograms recorded per thread
+ */
+
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/profiled_mutex.h"
+#include "log/log_record.h"
+#include "log/logger.h"
+
+namespace TURTLE_SERVER {
+
+static constexpr std::string_view METRIC_TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+/* name{labels} or name{labels,extra}, the braces omitted if there is no label at all */
+static void AppendSeries(std::string &out, std::string_view name, std::string_view labels,  // NOLINT
+                         std::string_view extra = "") {
+  out.append(name);
+  if (labels.empty() && extra.empty()) {
+    out.push_back(' ');
+    return;
+  }
+  out.push_back('{');
+  out.append(labels);
+  if (!labels.empty() && !extra.empty()) {
+    out.push_back(',');
+  }
+  out.append(extra);
+  out.append("} ");
+}
+
+auto Histogram::AllocateLocal() const -> HistogramShard * {
+  return MetricsRegistry::GetInstance().AllocateHistogram(&LocalMetricsShard(), slot_);
+}
+
+auto HistogramSnapshot::Quantile(double q) const noexcept -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_))), 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return HistogramBucketUpperBound(i);
+    }
+  }
+  return HistogramBucketUpperBound(buckets_.size() - 1);
+}
+
+auto MetricsRegistry::GetInstance() -> MetricsRegistry & {
+  // never destroyed, since a thread might still record on its way out
+  static auto *registry = new MetricsRegistry();
+  return *registry;
+}
+
+auto MetricsRegistry::AddCounter(std::string_view name, std::string_view help, std::string_view labels) -> Counter {
+  return Counter(Add(MetricType::COUNTER, name, help, labels, 0));
+}
+
+auto MetricsRegistry::AddGauge(std::string_view name, std::string_view help, std::string_view labels) -> Gauge {
+  return Gauge(Add(MetricType::GAUGE, name, help, labels, 0));
+}
+
+auto MetricsRegistry::AddHistogram(std::string_view name, std::string_view help, std::string_view labels,
+                                   uint32_t exposed_bits) -> Histogram {
+  return Histogram(Add(MetricType::HISTOGRAM, name, help, labels, std::min<uint32_t>(exposed_bits, 63)));
+}
+
+auto MetricsRegistry::Read(Counter counter) -> uint64_t { return Sum(counter.slot_); }
+
+auto MetricsRegistry::Read(Gauge gauge) -> int64_t { return static_cast<int64_t>(Sum(gauge.slot_)); }
+
+auto MetricsRegistry::Read(Histogram histogram) -> HistogramSnapshot { return Merge(histogram.slot_); }
+
+void MetricsRegistry::Expose(std::string &out) {  // NOLINT
+  std::vector<Metric> metrics;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    metrics = metrics_;
+  }
+  // the series of the same name are grouped under one HELP and TYPE, in the order first declared
+  std::vector<const Metric *> ordered;
+  for (const auto &metric : metrics) {
+    if (std::none_of(ordered.begin(), ordered.end(), [&metric](const Metric *m) { return m->name_ == metric.name_; })) {
+      for (const auto &series : metrics) {
+        if (series.name_ == metric.name_) {
+          ordered.push_back(&series);
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < ordered.size(); i++) {
+    const auto &metric = *ordered[i];
+    if (i == 0 || ordered[i - 1]->name_ != metric.name_) {
+      out.append("# HELP ").append(metric.name_).append(" ").append(metric.help_).append("\n");
+      out.append("# TYPE ").append(metric.name_).append(" ");
+      out.append(METRIC_TYPE_NAMES[static_cast<size_t>(metric.type_)]).append("\n");
+    }
+    if (metric.type_ != MetricType::HISTOGRAM) {
+      AppendSeries(out, metric.name_, metric.labels_);
+      auto value = Sum(metric.slot_);
+      metric.type_ == MetricType::GAUGE ? AppendNumber(out, static_cast<int64_t>(value)) : AppendNumber(out, value);
+      out.push_back('\n');
+      continue;
+    }
+    auto snapshot = Merge(metric.slot_);
+    auto bucket_name = metric.name_ + "_bucket";
+    // the buckets within a power of two are summed up to its end, so the cumulative counts are exact
+    uint64_t cumulative = 0;
+    size_t next_bucket = 0;
+    for (uint32_t bits = 0; bits <= metric.exposed_bits_; bits++) {
+      uint64_t bound = (uint64_t{1} << bits) - 1;
+      for (; next_bucket < snapshot.buckets_.size() && HistogramBucketUpperBound(next_bucket) <= bound;
+           next_bucket++) {
+        cumulative += snapshot.buckets_[next_bucket];
+      }
+      std::string le = "le=\"";
+      AppendNumber(le, bound);
+      le.push_back('"');
+      AppendSeries(out, bucket_name, metric.labels_, le);
+      AppendNumber(out, cumulative);
+      out.push_back('\n');
+    }
+    AppendSeries(out, bucket_name, metric.labels_, "le=\"+Inf\"");
+    AppendNumber(out, snapshot.count_);
+    out.push_back('\n');
+    AppendSeries(out, metric.name_ + "_sum", metric.labels_);
+    AppendNumber(out, snapshot.sum_);
+    out.push_back('\n');
+    AppendSeries(out, metric.name_ + "_count", metric.labels_);
+    AppendNumber(out, snapshot.count_);
+    out.push_back('\n');
+  }
+  LockProfiler::GetInstance().Expose(out);
+}
+
+auto MetricsRegistry::Add(MetricType type, std::string_view name, std::string_view help, std::string_view labels,
+                          uint32_t exposed_bits) -> uint32_t {
+  std::unique_lock<std::mutex> lock(mtx_);
+  for (const auto &metric : metrics_) {
+    if (metric.name_ == name && metric.labels_ == labels && metric.type_ == type) {
+      return metric.slot_;
+    }
+  }
+  bool histogram = type == MetricType::HISTOGRAM;
+  auto &next_slot = histogram ? next_histogram_slot_ : next_value_slot_;
+  if (next_slot >= (histogram ? MAX_HISTOGRAMS : MAX_METRICS)) {
+    LOG_WARNING("MetricsRegistry: no room for the metric {}", std::string(name));
+    return 0;
+  }
+  metrics_.push_back({std::string(name), std::string(help), std::string(labels), type, next_slot, exposed_bits});
+  return next_slot++;
+}
+
+auto MetricsRegistry::AddShard() -> MetricsShard * {
+  auto shard = std::make_unique<MetricsShard>();
+  auto *raw_shard = shard.get();
+  std::unique_lock<std::mutex> lock(mtx_);
+  shards_.push_back(std::move(shard));
+  return raw_shard;
+}
+
+auto MetricsRegistry::AllocateHistogram(MetricsShard *shard, uint32_t slot) -> HistogramShard * {
+  auto histogram = std::make_unique<HistogramShard>();
+  auto *raw_histogram = histogram.get();
+  std::unique_lock<std::mutex> lock(mtx_);
+  histogram_shards_.push_back(std::move(histogram));
+  // published for the scrapes, only the owner thread ever writes into it
+  shard->histograms_[slot].store(raw_histogram, std::memory_order_release);
+  return raw_histogram;
+}
+
+auto MetricsRegistry::Sum(uint32_t slot) -> uint64_t {
+  std::unique_lock<std::mutex> lock(mtx_);
+  uint64_t sum = 0;
+  for (const auto &shard : shards_) {
+    sum += shard->values_[slot].load(std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+auto MetricsRegistry::Merge(uint32_t slot) -> HistogramSnapshot {
+  HistogramSnapshot snapshot;
+  std::unique_lock<std::mutex> lock(mtx_);
+  for (const auto &shard : shards_) {
+    auto *histogram = shard->histograms_[slot].load(std::memory_order_acquire);
+    if (histogram == nullptr) {
+      continue;
+    }
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+      auto count = histogram->buckets_[i].load(std::memory_order_relaxed);
+      snapshot.buckets_[i] += count;
+      snapshot.count_ += count;
+    }
+    snapshot.sum_ += histogram->sum_.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+}  // namespace TURTLE_SERVER
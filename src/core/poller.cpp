@@ -15,6 +15,7 @@
 #include <unistd.h>
 
 #include <cassert>
+#include <cerrno>
 #include <cstring>
 
 #include "core/connection.h"
@@ -23,7 +24,7 @@ namespace TURTLE_SERVER {
 
 #ifdef OS_LINUX
 Poller::Poller(uint64_t poll_size) : poll_size_(poll_size) {
-  poll_fd_ = epoll_create1(0);
+  poll_fd_ = epoll_create1(EPOLL_CLOEXEC);
   if (poll_fd_ == -1) {
     perror("Poller: epoll_create1() error");
     exit(EXIT_FAILURE);
@@ -33,7 +34,7 @@ Poller::Poller(uint64_t poll_size) : poll_size_(poll_size) {
 }
 #elif OS_MAC
 Poller::Poller(uint64_t poll_size) : poll_size_(poll_size) {
-  poll_fd_ = kqueue();
+  poll_fd_ = kqueue();  // a kqueue is never inherited by a child process
   if (poll_fd_ == -1) {
     LOG_ERROR("Poller: kqueue() error");
     exit(EXIT_FAILURE);
@@ -69,16 +70,65 @@ void Poller::AddConnection(Connection *conn) {
   assert(conn->GetFd() != -1 && "cannot AddConnection() with an invalid fd");
   struct kevent event[1];
   memset(event, 0, sizeof(event));
-  EV_SET(&event[0], conn->GetFd(), POLL_ADD, conn->GetEvents(), 0, 0,
+  EV_SET(&event[0], conn->GetFd(), POLL_ADD, conn->GetEvents() & ~POLL_WRITE, 0, 0,
          conn);  // read-trigger-only
   assert(kevent(poll_fd_, event, 1, nullptr, 0, nullptr) != -1 && "kevent add channel fails");
 }
 #endif
 
+#ifdef OS_LINUX
+void Poller::ModifyConnection(Connection *conn) {
+  assert(conn->GetFd() != -1 && "cannot ModifyConnection() with an invalid fd");
+  struct epoll_event event;
+  memset(&event, 0, sizeof(struct epoll_event));
+  event.data.ptr = conn;
+  event.events = conn->GetEvents();
+  if (epoll_ctl(poll_fd_, EPOLL_CTL_MOD, conn->GetFd(), &event) == -1) {
+    LOG_WARNING("Poller: epoll_ctl modify error");
+  }
+}
+#elif OS_MAC
+void Poller::ModifyConnection(Connection *conn) {
+  assert(conn->GetFd() != -1 && "cannot ModifyConnection() with an invalid fd");
+  // the write interest is a filter of its own in kqueue
+  struct kevent event[1];
+  memset(event, 0, sizeof(event));
+  uint16_t flags = (conn->GetEvents() & POLL_WRITE) ? (EV_ADD | EV_CLEAR) : EV_DELETE;
+  EV_SET(&event[0], conn->GetFd(), EVFILT_WRITE, flags, 0, 0, conn);
+  if (kevent(poll_fd_, event, 1, nullptr, 0, nullptr) == -1) {
+    LOG_WARNING("Poller: kevent modify error");
+  }
+}
+#endif
+
+#ifdef OS_LINUX
+void Poller::RemoveConnection(Connection *conn) {
+  assert(conn->GetFd() != -1 && "cannot RemoveConnection() with an invalid fd");
+  if (epoll_ctl(poll_fd_, EPOLL_CTL_DEL, conn->GetFd(), nullptr) == -1) {
+    LOG_WARNING("Poller: epoll_ctl delete error");
+  }
+}
+#elif OS_MAC
+void Poller::RemoveConnection(Connection *conn) {
+  assert(conn->GetFd() != -1 && "cannot RemoveConnection() with an invalid fd");
+  struct kevent event[2];
+  memset(event, 0, sizeof(event));
+  EV_SET(&event[0], conn->GetFd(), EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+  EV_SET(&event[1], conn->GetFd(), EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+  int changes = (conn->GetEvents() & POLL_WRITE) ? 2 : 1;
+  if (kevent(poll_fd_, event, changes, nullptr, 0, nullptr) == -1) {
+    LOG_WARNING("Poller: kevent delete error");
+  }
+}
+#endif
+
 #ifdef OS_LINUX
 auto Poller::Poll(int timeout) -> std::vector<Connection *> {
   std::vector<Connection *> events_happen;
   int ready = epoll_wait(poll_fd_, poll_events_, poll_size_, timeout);
+  if (ready == -1 && errno == EINTR) {
+    return events_happen;  // interrupted by a signal, e.g. from the watchdog, which is never restarted
+  }
   if (ready == -1) {
     perror("Poller: Poll() error");
     exit(EXIT_FAILURE);
@@ -100,13 +150,17 @@ auto Poller::Poll(int timeout) -> std::vector<Connection *> {
   t.tv_nsec = (timeout % 1000) * 1000 * 1000;
 
   int ready = kevent(poll_fd_, nullptr, 0, poll_events_, static_cast<int>(poll_size_), &t);
+  if (ready == -1 && errno == EINTR) {
+    return events_happen;
+  }
   if (ready == -1) {
     LOG_ERROR("Poller: Poll() error");
     exit(EXIT_FAILURE);
   }
   for (int i = 0; i < ready; i++) {
     auto *ready_connection = reinterpret_cast<Connection *>(poll_events_[i].udata);
-    ready_connection->SetRevents(poll_events_[i].filter);
+    // the same fd is reported once per filter, translate into the epoll-like flags
+    ready_connection->SetRevents(poll_events_[i].filter == EVFILT_WRITE ? POLL_WRITE : POLL_READ);
     events_happen.emplace_back(ready_connection);
   }
   return events_happen;
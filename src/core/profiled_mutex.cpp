@@ -0,0 +1,83 @@
+/**
+ * @file profiled_mutex.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the exposition of the lock
+ * profiles, as part of the metrics
+ */
+
+#include "core/profiled_mutex.h"
+
+#include <charconv>
+
+namespace TURTLE_SERVER {
+
+static void AppendNumber(std::string &out, uint64_t value) {  // NOLINT
+  char number[32];
+  out.append(number, std::to_chars(number, number + sizeof(number), value).ptr - number);
+}
+
+static void AppendSample(std::string &out, std::string_view name, const std::string &lock,  // NOLINT
+                         std::string_view extra, uint64_t value) {
+  out.append(name).append("{lock=\"").append(lock).append("\"");
+  if (!extra.empty()) {
+    out.append(",").append(extra);
+  }
+  out.append("} ");
+  AppendNumber(out, value);
+  out.push_back('\n');
+}
+
+static void AppendHistogram(std::string &out, const std::string &name, const std::string &lock,  // NOLINT
+                            const LockHistogram &histogram) {
+  uint64_t cumulative = 0;
+  auto bucket_name = name + "_bucket";
+  // bucket n holds up to 2^n - 1, so the cumulative counts are exact
+  for (uint32_t bits = 0; bits <= LOCK_HISTOGRAM_EXPOSED_BITS; bits++) {
+    cumulative += histogram.buckets_[bits].load(std::memory_order_relaxed);
+    std::string le = "le=\"";
+    AppendNumber(le, (uint64_t{1} << bits) - 1);
+    le.push_back('"');
+    AppendSample(out, bucket_name, lock, le, cumulative);
+  }
+  for (size_t i = LOCK_HISTOGRAM_EXPOSED_BITS + 1; i < LOCK_HISTOGRAM_BUCKETS; i++) {
+    cumulative += histogram.buckets_[i].load(std::memory_order_relaxed);
+  }
+  AppendSample(out, bucket_name, lock, "le=\"+Inf\"", cumulative);
+  AppendSample(out, name + "_sum", lock, "", histogram.sum_.load(std::memory_order_relaxed));
+  AppendSample(out, name + "_count", lock, "", cumulative);
+}
+
+void LockProfiler::Expose(std::string &out) {  // NOLINT
+  std::unique_lock<std::mutex> lock(mtx_);
+  if (profiles_.empty()) {
+    return;
+  }
+  out.append("# HELP turtle_lock_acquisitions_total Acquisitions of a lock\n");
+  out.append("# TYPE turtle_lock_acquisitions_total counter\n");
+  for (const auto &profile : profiles_) {
+    AppendSample(out, "turtle_lock_acquisitions_total", profile.name_, "",
+                 profile.acquisitions_.load(std::memory_order_relaxed));
+  }
+  out.append("# HELP turtle_lock_contended_total Acquisitions of a lock not made upon the first try\n");
+  out.append("# TYPE turtle_lock_contended_total counter\n");
+  for (const auto &profile : profiles_) {
+    AppendSample(out, "turtle_lock_contended_total", profile.name_, "",
+                 profile.contended_.load(std::memory_order_relaxed));
+  }
+  out.append("# HELP turtle_lock_wait_ns Time waited for a lock in nanoseconds\n");
+  out.append("# TYPE turtle_lock_wait_ns histogram\n");
+  for (const auto &profile : profiles_) {
+    AppendHistogram(out, "turtle_lock_wait_ns", profile.name_, profile.wait_);
+  }
+  out.append("# HELP turtle_lock_hold_ns Time a lock was held exclusively in nanoseconds\n");
+  out.append("# TYPE turtle_lock_hold_ns histogram\n");
+  for (const auto &profile : profiles_) {
+    AppendHistogram(out, "turtle_lock_hold_ns", profile.name_, profile.hold_);
+  }
+}
+
+}  // namespace TURTLE_SERVER
@@ -24,6 +24,19 @@ namespace TURTLE_SERVER {
 
 static constexpr int BACK_LOG = 128;
 
+/* every socket is close-on-exec, so that a spawned CGI program never holds a client connection open */
+#ifdef OS_LINUX
+static constexpr int SOCKET_FLAGS = SOCK_CLOEXEC;
+#elif OS_MAC
+static constexpr int SOCKET_FLAGS = 0;
+
+static void SetCloseOnExec(int fd) {
+  if (fd != -1) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+}
+#endif
+
 Socket::Socket(int fd) noexcept : fd_(fd) {}
 
 Socket::Socket(Socket &&other) noexcept {
@@ -81,7 +94,12 @@ void Socket::Listen() {
 
 auto Socket::Accept(NetAddress &client_address) -> int {
   assert(fd_ != -1 && "cannot Accept() with an invalid fd");
+#ifdef OS_LINUX
+  int client_fd = accept4(fd_, client_address.YieldAddr(), client_address.YieldAddrLen(), SOCKET_FLAGS);
+#elif OS_MAC
   int client_fd = accept(fd_, client_address.YieldAddr(), client_address.YieldAddrLen());
+  SetCloseOnExec(client_fd);
+#endif
   if (client_fd == -1) {
     // under high pressure, accept might fail.
     // but server should not fail at this time
@@ -115,10 +133,13 @@ auto Socket::GetAttrs() -> int {
 
 void Socket::CreateByProtocol(Protocol protocol) {
   if (protocol == Protocol::Ipv4) {
-    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    fd_ = socket(AF_INET, SOCK_STREAM | SOCKET_FLAGS, 0);
   } else {
-    fd_ = socket(AF_INET6, SOCK_STREAM, 0);
+    fd_ = socket(AF_INET6, SOCK_STREAM | SOCKET_FLAGS, 0);
   }
+#ifdef OS_MAC
+  SetCloseOnExec(fd_);
+#endif
   if (fd_ == -1) {
     LOG_ERROR("Socket: socket() error");
     throw std::logic_error("Socket: socket() error");
@@ -22,7 +22,7 @@ ThreadPool::ThreadPool(int size) {
       while (true) {
         std::function<void()> next_task;
         {
-          std::unique_lock<std::mutex> lock(mtx_);
+          UniqueLock<Mutex> lock(mtx_);
           cv_.wait(lock, [this]() { return exit_ || !tasks_.empty(); });
           if (exit_ && tasks_.empty()) {
             return;  // thread life ends
@@ -14,12 +14,17 @@
 #include <chrono>  // NOLINT
 #include <cstring>
 #include "core/connection.h"
+#include "core/metrics.h"
 #include "core/poller.h"
 #include "core/socket.h"
 #include "log/logger.h"
 
 namespace TURTLE_SERVER {
 
+/* the single timers pending across all the loopers, i.e. the idle expirations and the deadlines */
+static const Gauge timers_gauge =
+    MetricsRegistry::GetInstance().AddGauge("turtle_timers_outstanding", "Single timers pending to expire");
+
 static constexpr int MILLS_IN_SECOND = 1000;
 static constexpr int NANOS_IN_MILL = 1000 * 1000;
 
@@ -86,10 +91,11 @@ auto Timer::GetTimerFd() -> int { return timer_fd_; }
 
 auto Timer::AddSingleTimer(uint64_t expire_from_now, const std::function<void()> &callback) noexcept
     -> Timer::SingleTimer * {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   auto new_timer = std::make_unique<SingleTimer>(expire_from_now, callback);
   auto raw_timer = new_timer.get();
   timer_queue_.emplace(raw_timer, std::move(new_timer));
+  timers_gauge.Inc();
   uint64_t new_next_expire = NextExpireTime();
   if (new_next_expire != next_expire_) {
     next_expire_ = new_next_expire;
@@ -99,10 +105,11 @@ auto Timer::AddSingleTimer(uint64_t expire_from_now, const std::function<void()>
 }
 
 auto Timer::RemoveSingleTimer(Timer::SingleTimer *single_timer) noexcept -> bool {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   auto it = timer_queue_.find(single_timer);
   if (it != timer_queue_.end()) {
     timer_queue_.erase(it);
+    timers_gauge.Dec();
     uint64_t new_next_expire = NextExpireTime();
     if (new_next_expire != next_expire_) {
       next_expire_ = new_next_expire;
@@ -115,7 +122,7 @@ auto Timer::RemoveSingleTimer(Timer::SingleTimer *single_timer) noexcept -> bool
 
 auto Timer::RefreshSingleTimer(Timer::SingleTimer *single_timer, uint64_t expire_from_now) noexcept
     -> Timer::SingleTimer * {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   auto it = timer_queue_.find(single_timer);
   if (it == timer_queue_.end()) {
     return nullptr;
@@ -143,7 +150,7 @@ auto Timer::NextExpireTime() const noexcept -> uint64_t {
 auto Timer::TimerCount() const noexcept -> size_t { return timer_queue_.size(); }
 
 auto Timer::PruneExpiredTimer() noexcept -> std::vector<std::unique_ptr<SingleTimer>> {
-  std::unique_lock<std::mutex> lock(mtx_);
+  UniqueLock<Mutex> lock(mtx_);
   std::vector<std::unique_ptr<SingleTimer>> expired;
   auto it = timer_queue_.begin();
   for (; it != timer_queue_.end(); it++) {
@@ -156,6 +163,7 @@ auto Timer::PruneExpiredTimer() noexcept -> std::vector<std::unique_ptr<SingleTi
     expired.push_back(std::move(expire_it->second));
   }
   timer_queue_.erase(timer_queue_.begin(), it);
+  timers_gauge.Add(-static_cast<int64_t>(expired.size()));
   uint64_t new_next_expire = NextExpireTime();
   if (new_next_expire != next_expire_) {
     next_expire_ = new_next_expire;
@@ -177,7 +185,8 @@ void Timer::HandleRead() {
 }
 
 auto Timer::SingleTimerCompartor::operator()(const SingleTimer *lhs, const SingleTimer *rhs) const noexcept -> bool {
-  return lhs->WhenExpire() < rhs->WhenExpire();
+  // timers expiring at the same millisecond are still distinct ones
+  return lhs->WhenExpire() < rhs->WhenExpire() || (lhs->WhenExpire() == rhs->WhenExpire() && lhs < rhs);
 }
 
 }  // namespace TURTLE_SERVER
@@ -0,0 +1,139 @@
+/**
+ * @file watchdog.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the Watchdog which catches a
+ * looper stalled by a blocking callback, along with where it is stuck
+ */
+
+#include "core/watchdog.h"
+
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+
+#include "core/looper.h"
+#include "log/logger.h"
+
+namespace TURTLE_SERVER {
+
+/* ignored by default, so that a stray one never kills the process, and never used by the server otherwise */
+static constexpr int STALL_SIGNAL = SIGURG;
+
+/* how long to wait for a stalled thread to capture its own backtrace */
+static constexpr std::chrono::milliseconds STALL_CAPTURE_TIMEOUT = std::chrono::milliseconds(100);
+
+/* filled in by the stalled thread in its signal handler, one capture at a time */
+static void *stall_frames[MAX_STALL_FRAMES];
+static std::atomic<int> stall_frames_size{-1};
+
+static void CaptureStallBacktrace(int) {
+  int saved_errno = errno;
+  stall_frames_size.store(backtrace(stall_frames, MAX_STALL_FRAMES), std::memory_order_release);
+  errno = saved_errno;
+}
+
+static void InstallStallHandler() {
+  static std::once_flag installed;
+  std::call_once(installed, []() {
+    // the first backtrace() might load the unwinder, which is not safe inside a signal handler
+    void *frame;
+    backtrace(&frame, 1);
+    struct sigaction action {};
+    action.sa_handler = CaptureStallBacktrace;
+    // the blocking call interrupted is resumed, which is where the looper is stuck anyway
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(STALL_SIGNAL, &action, nullptr);
+  });
+}
+
+/* the backtrace of a thread, one frame per line, empty if it does not respond in time */
+static auto CaptureBacktrace(pthread_t thread) -> std::string {
+  stall_frames_size.store(-1, std::memory_order_relaxed);
+  if (pthread_kill(thread, STALL_SIGNAL) != 0) {
+    return {};
+  }
+  auto give_up = std::chrono::steady_clock::now() + STALL_CAPTURE_TIMEOUT;
+  int size;
+  while ((size = stall_frames_size.load(std::memory_order_acquire)) < 0) {
+    if (std::chrono::steady_clock::now() > give_up) {
+      return {};
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  std::string trace;
+  char **symbols = backtrace_symbols(stall_frames, size);
+  for (int i = 0; i < size; i++) {
+    trace.append("\n  #").append(std::to_string(i)).append(" ");
+    trace.append(symbols != nullptr ? symbols[i] : "?");
+  }
+  free(symbols);  // NOLINT
+  return trace;
+}
+
+Watchdog::Watchdog(std::chrono::milliseconds threshold) : threshold_(threshold.count()) {
+  InstallStallHandler();
+  watcher_ = std::thread(&Watchdog::WatchLoop, this);
+}
+
+Watchdog::~Watchdog() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_ = true;
+  }
+  cv_.notify_one();
+  watcher_.join();
+}
+
+void Watchdog::Watch(Looper *looper) {
+  auto labels = "looper=\"" + std::to_string(looper->GetId()) + "\"";
+  auto stalls = MetricsRegistry::GetInstance().AddCounter(
+      "turtle_looper_stalls_total", "Rounds of a looper stuck beyond the stall threshold", labels);
+  std::unique_lock<std::mutex> lock(mtx_);
+  watched_.push_back({looper, stalls});
+}
+
+void Watchdog::SetThreshold(std::chrono::milliseconds threshold) noexcept {
+  threshold_.store(threshold.count(), std::memory_order_relaxed);
+}
+
+void Watchdog::WatchLoop() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (!done_) {
+    // a stall is caught within 1.5x the threshold
+    auto interval = std::clamp(std::chrono::milliseconds(threshold_.load(std::memory_order_relaxed) / 2),
+                               std::chrono::milliseconds(1), MAX_WATCHDOG_INTERVAL);
+    cv_.wait_for(lock, interval, [this]() { return done_; });
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    for (auto &watched : watched_) {
+      Check(watched, now);
+    }
+  }
+}
+
+void Watchdog::Check(Watched &watched, int64_t now) {  // NOLINT
+  auto heartbeat = watched.looper_->GetHeartbeat();
+  if (heartbeat.busy_since_ == 0 || heartbeat.busy_since_ == watched.reported_since_) {
+    return;
+  }
+  auto stalled = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::duration(now - heartbeat.busy_since_));
+  if (stalled.count() < threshold_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  watched.reported_since_ = heartbeat.busy_since_;
+  watched.stalls_.Inc();
+  LOG_WARNING("looper {} has been stuck for {}ms on fd={}, at:{}", watched.looper_->GetId(), stalled.count(),
+              heartbeat.fd_, CaptureBacktrace(heartbeat.thread_));
+}
+
+}  // namespace TURTLE_SERVER
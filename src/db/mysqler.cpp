@@ -68,7 +68,7 @@ auto MySqler::ExecuteQueryBlocking(const std::string &command) -> std::unique_pt
     auto stmt = std::unique_ptr<sql::Statement>(conn_->createStatement());
     return std::unique_ptr<sql::ResultSet>(stmt->executeQuery(command));
   } catch (sql::SQLException &e) {
-    LOG_ERROR("Fail to execute query [" + command + "]");
+    LOG_ERROR("Fail to execute query [{}]", command);
     LogMySqlError(e);
     throw;
   }
@@ -83,7 +83,7 @@ auto MySqler::ExecuteBlocking(const std::string &command) -> bool {
     auto stmt = std::unique_ptr<sql::Statement>(conn_->createStatement());
     return stmt->execute(command);
   } catch (sql::SQLException &e) {
-    LOG_ERROR("Fail to execute command [" + command + "]");
+    LOG_ERROR("Fail to execute command [{}]", command);
     LogMySqlError(e);
     throw;
   }
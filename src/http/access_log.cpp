@@ -0,0 +1,243 @@
+/**
+ * @file access_log.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the asynchronous access log,
+ * a line for each request served
+ */
+
+#include "http/access_log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace TURTLE_SERVER::HTTP {
+
+/* the value of a field absent, as in the Apache formats */
+static constexpr std::string_view ABSENT_FIELD{"-"};
+
+/* copy at most N - 1 bytes and terminate */
+template <size_t N>
+static void CopyField(char (&field)[N], std::string_view value) noexcept {
+  auto size = std::min(value.size(), N - 1);
+  memcpy(field, value.data(), size);
+  field[size] = '\0';
+}
+
+/* quotes, backslashes and non-printable bytes are escaped as "\xHH", the same as Nginx */
+static void AppendEscaped(LogBlock &out, std::string_view str) {  // NOLINT
+  for (char c : str) {
+    auto byte = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\' || byte < 0x20 || byte >= 0x7f) {
+      char escaped[8];
+      Append(out, {escaped, static_cast<size_t>(snprintf(escaped, sizeof(escaped), "\\x%02X", byte))});
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+static void AppendQuoted(LogBlock &out, std::string_view str) {  // NOLINT
+  out.push_back('"');
+  str.empty() ? Append(out, ABSENT_FIELD) : AppendEscaped(out, str);
+  out.push_back('"');
+}
+
+/* the "[10/Oct/2000:13:55:36 -0700]" stamp of the common log format */
+static constexpr char COMMON_TIMESTAMP_FORMAT[] = {"[%d/%b/%Y:%H:%M:%S %z]"};
+
+void AccessRecord::SetClient(std::string_view client) noexcept { CopyField(client_, client); }
+
+void AccessRecord::SetRequest(Method method, Version version, std::string_view path, std::string_view referer,
+                              std::string_view user_agent) noexcept {
+  has_request_ = true;
+  method_ = method;
+  version_ = version;
+  CopyField(path_, path);
+  CopyField(referer_, referer);
+  CopyField(user_agent_, user_agent);
+}
+
+void FormatAccessRecord(const AccessRecord &record, AccessLogFormat format, LogBlock &out) {  // NOLINT
+  std::string_view client = record.client_[0] != '\0' ? std::string_view(record.client_) : ABSENT_FIELD;
+  const auto &method = METHOD_TO_STRING.at(record.method_);
+  if (format == AccessLogFormat::JSON) {
+    Append(out, R"({"time_us":)");
+    AppendNumber(out, record.timestamp_);
+    Append(out, R"(,"client":)");
+    AppendJsonString(out, client);
+    if (record.has_request_) {
+      Append(out, R"(,"method":)");
+      AppendJsonString(out, method);
+      Append(out, R"(,"path":)");
+      AppendJsonString(out, record.path_);
+    }
+    Append(out, R"(,"status":)");
+    AppendNumber(out, record.status_);
+    Append(out, R"(,"bytes":)");
+    AppendNumber(out, record.bytes_);
+    Append(out, R"(,"latency_us":)");
+    AppendNumber(out, record.latency_);
+    if (record.has_request_) {
+      Append(out, R"(,"referer":)");
+      AppendJsonString(out, record.referer_);
+      Append(out, R"(,"user_agent":)");
+      AppendJsonString(out, record.user_agent_);
+    }
+    Append(out, "}\n");
+    return;
+  }
+  // %h %l %u %t "%r" %>s %b
+  Append(out, client);
+  Append(out, " - - ");
+  Append(out, FormatSecond<COMMON_TIMESTAMP_FORMAT>(record.timestamp_));
+  Append(out, " \"");
+  if (record.has_request_) {
+    Append(out, method);
+    out.push_back(' ');
+    AppendEscaped(out, record.path_);
+    out.push_back(' ');
+    Append(out, VERSION_TO_STRING.at(record.version_));
+  } else {
+    Append(out, ABSENT_FIELD);
+  }
+  Append(out, "\" ");
+  AppendNumber(out, record.status_);
+  out.push_back(' ');
+  if (record.bytes_ == 0) {
+    Append(out, ABSENT_FIELD);
+  } else {
+    AppendNumber(out, record.bytes_);
+  }
+  if (format == AccessLogFormat::COMBINED) {
+    // "%{Referer}i" "%{User-agent}i"
+    out.push_back(' ');
+    AppendQuoted(out, record.referer_);
+    out.push_back(' ');
+    AppendQuoted(out, record.user_agent_);
+  }
+  out.push_back('\n');
+}
+
+AccessLog::AccessRing::AccessRing(size_t capacity) : slots_(std::max<size_t>(capacity, 1)) {}
+
+auto AccessLog::AccessRing::TryPush(const AccessRecord &record) noexcept -> bool {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+    return false;
+  }
+  slots_[tail % slots_.size()] = record;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+auto AccessLog::AccessRing::IsHalfFull() const noexcept -> bool {
+  return (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_relaxed)) * 2 >= slots_.size();
+}
+
+void AccessLog::AccessRing::Drain(AccessLogFormat format, LogBlock &out) {  // NOLINT
+  auto head = head_.load(std::memory_order_relaxed);
+  auto tail = tail_.load(std::memory_order_acquire);
+  for (; head != tail; head++) {
+    FormatAccessRecord(slots_[head % slots_.size()], format, out);
+  }
+  // the slots are handed back to the producer only after being formatted
+  head_.store(head, std::memory_order_release);
+}
+
+/* each access log has a unique id, so that a thread never mistakes a destroyed one's ring as its own */
+static std::atomic<uint64_t> next_access_log_id{0};
+
+AccessLog::AccessLog(AccessLogFormat format, LogFileOptions options, size_t ring_capacity)
+    : AccessLog(format, nullptr, ring_capacity) {
+  auto log_file = std::make_shared<LogFile>(LOG_TEXT_SUFFIX, nullptr, std::move(options));
+  sink_ = [log_file](const std::vector<LogBlock> &blocks) { log_file->Write(blocks); };
+  // the sink is set before the drainer starts
+  drainer_ = std::thread(&AccessLog::DrainLoop, this);
+}
+
+AccessLog::AccessLog(AccessLogFormat format, std::function<void(const std::vector<LogBlock> &)> sink,
+                     size_t ring_capacity)
+    : id_(next_access_log_id++), format_(format), ring_capacity_(ring_capacity), sink_(std::move(sink)) {
+  if (sink_ != nullptr) {
+    drainer_ = std::thread(&AccessLog::DrainLoop, this);
+  }
+}
+
+AccessLog::~AccessLog() {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_ = true;
+  }
+  cv_.notify_one();
+  if (drainer_.joinable()) {
+    drainer_.join();
+  }
+}
+
+void AccessLog::Record(const AccessRecord &record) noexcept {
+  auto *ring = GetLocalRing();
+  if (ring == nullptr || !ring->TryPush(record)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (ring->IsHalfFull() && !notified_.exchange(true)) {
+    // pass through the lock, so that the notification never slips in before the drainer waits
+    { std::unique_lock<std::mutex> lock(mtx_); }
+    cv_.notify_one();
+  }
+}
+
+auto AccessLog::GetDropped() const noexcept -> uint64_t { return dropped_.load(std::memory_order_relaxed); }
+
+auto AccessLog::GetLocalRing() -> AccessRing * {
+  // almost always one access log per process, so a linear lookup
+  thread_local std::vector<std::pair<uint64_t, AccessRing *>> local;
+  for (const auto &[id, ring] : local) {
+    if (id == id_) {
+      return ring;
+    }
+  }
+  try {
+    auto ring = std::make_shared<AccessRing>(ring_capacity_);
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      rings_.push_back(ring);
+    }
+    local.emplace_back(id_, ring.get());
+    return ring.get();
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+
+void AccessLog::DrainLoop() {
+  std::vector<std::shared_ptr<AccessRing>> rings;
+  std::vector<LogBlock> lines(1);
+  while (true) {
+    bool done;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_.wait_for(lock, ACCESS_DRAIN_INTERVAL, [this]() { return done_ || notified_; });
+      done = done_;
+      rings = rings_;
+    }
+    notified_ = false;
+    for (auto &ring : rings) {
+      ring->Drain(format_, lines.front());
+    }
+    // called even with nothing new, so that the sink could write out what it holds back
+    sink_(lines);
+    lines.front().clear();
+    if (done) {
+      return;
+    }
+  }
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -0,0 +1,27 @@
+/**
+ * @file admission.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the admission control which
+ * sheds new requests while a looper is overloaded
+ */
+
+#include "http/admission.h"
+
+#include "core/looper.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* a threshold of 0 is disabled */
+static auto IsOver(uint64_t value, uint64_t threshold) noexcept -> bool { return threshold != 0 && value > threshold; }
+
+auto IsOverloaded(const LooperLoad &load, const AdmissionLimits &limits) noexcept -> bool {
+  return IsOver(load.connections_, limits.max_connections_) || IsOver(load.ready_backlog_, limits.max_ready_backlog_) ||
+         IsOver(load.round_time_, limits.max_round_time_) ||
+         IsOver(load.outstanding_work_, limits.max_outstanding_work_);
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -0,0 +1,474 @@
+/**
+ * @file cgi_pool.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the pool of pre-spawned CGI
+ * workers that launch the CGI programs on behalf of the server process
+ */
+
+#include "http/cgi_pool.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/metrics.h"
+#include "core/poller.h"
+#include "core/socket.h"
+#include "log/logger.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+#ifdef OS_LINUX
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#elif OS_MAC
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+/* chunk size when draining the CGI program's stdout */
+static constexpr size_t CGI_READ_CHUNK = 4096;
+
+static const Counter workers_retired_total = MetricsRegistry::GetInstance().AddCounter(
+    "turtle_cgi_workers_retired_total", "CGI workers retired for being lost or killed midway");
+static const Counter workers_replaced_total = MetricsRegistry::GetInstance().AddCounter(
+    "turtle_cgi_workers_replaced_total", "CGI workers forked by the launcher in place of the retired ones");
+
+static void SetCloseOnExec(int fd) { fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC); }
+
+/* the server's ends are non-blocking for the loopers, so a request not fitting at once waits here */
+static auto WaitFor(int fd, int16_t events) -> bool {
+  struct pollfd poll_fd {
+    fd, events, 0
+  };
+  while (poll(&poll_fd, 1, -1) == -1) {
+    if (errno != EINTR) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static auto WriteFully(int fd, const unsigned char *data, size_t size) -> bool {
+  while (size > 0) {
+    ssize_t sent = send(fd, data, size, SEND_FLAGS);
+    if (sent == -1 && errno == EINTR) {
+      continue;
+    }
+    if (sent == -1 && (errno == EAGAIN || errno == EWOULDBLOCK) && WaitFor(fd, POLLOUT)) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+static auto ReadFully(int fd, unsigned char *data, size_t size) -> bool {
+  while (size > 0) {
+    ssize_t got = recv(fd, data, size, 0);
+    if (got == -1 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    data += got;
+    size -= got;
+  }
+  return true;
+}
+
+/* a frame is a 64-bit length followed by that many bytes */
+static auto SendFrame(int fd, const std::vector<unsigned char> &frame) -> bool {
+  uint64_t size = frame.size();
+  return WriteFully(fd, reinterpret_cast<const unsigned char *>(&size), sizeof(size)) &&
+         WriteFully(fd, frame.data(), frame.size());
+}
+
+static auto RecvFrame(int fd, std::vector<unsigned char> &frame) -> bool {  // NOLINT
+  uint64_t size = 0;
+  if (!ReadFully(fd, reinterpret_cast<unsigned char *>(&size), sizeof(size))) {
+    return false;
+  }
+  frame.resize(size);
+  return ReadFully(fd, frame.data(), size);
+}
+
+/* pass a new worker's pid along with its socket to the server, a pid of -1 without any socket if it failed */
+static auto SendWorker(int fd, pid_t pid, int worker_fd) -> bool {
+  struct iovec iov {
+    &pid, sizeof(pid)
+  };
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  if (worker_fd != -1) {
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    auto *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &worker_fd, sizeof(int));
+  }
+  ssize_t sent;
+  while ((sent = sendmsg(fd, &msg, SEND_FLAGS)) == -1 && errno == EINTR) {
+  }
+  return sent == sizeof(pid);
+}
+
+/*
+ * take a new worker passed by the launcher without blocking, worker_fd is -1 if it failed to fork one
+ * return what recvmsg() returns, -1 with EAGAIN if none has arrived yet
+ */
+static auto RecvWorker(int fd, pid_t *pid, int *worker_fd) -> ssize_t {
+  struct iovec iov {
+    pid, sizeof(*pid)
+  };
+  struct msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t got;
+  while ((got = recvmsg(fd, &msg, MSG_DONTWAIT)) == -1 && errno == EINTR) {
+  }
+  *worker_fd = -1;
+  auto *cmsg = got > 0 ? CMSG_FIRSTHDR(&msg) : nullptr;
+  if (cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+    memcpy(worker_fd, CMSG_DATA(cmsg), sizeof(int));
+    SetCloseOnExec(*worker_fd);
+  }
+  return got;
+}
+
+/* path and arguments each terminated by NUL, ready to be the worker's argv */
+static auto BuildRequest(const std::string &path, const std::vector<std::string> &arguments)
+    -> std::vector<unsigned char> {
+  std::vector<unsigned char> request(path.begin(), path.end());
+  request.push_back('\0');
+  for (const auto &argument : arguments) {
+    request.insert(request.end(), argument.begin(), argument.end());
+    request.push_back('\0');
+  }
+  return request;
+}
+
+CgiWorkerPool::CgiWorkerPool(int worker_count) {
+  // the launcher is forked first, so that it holds none of the workers' sockets
+  int launcher_fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, launcher_fds) == 0) {
+    SetCloseOnExec(launcher_fds[0]);
+    SetCloseOnExec(launcher_fds[1]);
+    launcher_pid_ = fork();
+    if (launcher_pid_ == 0) {
+      close(launcher_fds[0]);
+      LauncherLoop(launcher_fds[1]);
+    }
+    close(launcher_fds[1]);
+    if (launcher_pid_ == -1) {
+      close(launcher_fds[0]);
+    } else {
+      launcher_fd_ = launcher_fds[0];
+      fcntl(launcher_fd_, F_SETFL, fcntl(launcher_fd_, F_GETFL) | O_NONBLOCK);
+      children_.push_back(launcher_pid_);
+    }
+  }
+  if (launcher_fd_ == -1) {
+    LOG_ERROR("CgiWorkerPool: fail to fork the launcher, a lost worker is never replaced");
+  }
+  for (int i = 0; i < worker_count; i++) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+      LOG_ERROR("CgiWorkerPool: fail to socketpair()");
+      break;
+    }
+    SetCloseOnExec(fds[0]);
+    SetCloseOnExec(fds[1]);
+    pid_t pid = fork();
+    if (pid == -1) {
+      LOG_ERROR("CgiWorkerPool: fail to fork()");
+      close(fds[0]);
+      close(fds[1]);
+      break;
+    }
+    if (pid == 0) {
+      // worker, leading a process group of its own and its program, which are then killed together
+      setpgid(0, 0);
+      // keep only its own end so that it sees EOF once the server closes it
+      close(fds[0]);
+      if (launcher_fd_ != -1) {
+        close(launcher_fd_);
+      }
+      for (const auto &worker : workers_) {
+        close(worker.fd_);
+      }
+      WorkerLoop(fds[1]);
+    }
+    // also set on this side, so the group exists whichever of the two runs first
+    setpgid(pid, pid);
+    close(fds[1]);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    workers_.push_back({pid, fds[0]});
+    idle_.push_back(workers_.size() - 1);
+    children_.push_back(pid);
+  }
+  alive_ = workers_.size();
+}
+
+CgiWorkerPool::~CgiWorkerPool() {
+  for (auto &worker : workers_) {
+    if (worker.fd_ != -1) {
+      close(worker.fd_);
+    }
+  }
+  if (launcher_fd_ != -1) {
+    close(launcher_fd_);
+  }
+  // the replacements are the launcher's children, they exit upon EOF as well and are never waited for here
+  for (auto pid : children_) {
+    waitpid(pid, nullptr, 0);
+  }
+}
+
+auto CgiWorkerPool::RunAsync(Looper *looper, const std::string &path, const std::vector<std::string> &arguments,
+                             std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete,
+                             uint64_t timeout) -> bool {
+  size_t index;
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    CollectReplacements();
+    if (idle_.empty()) {
+      return false;
+    }
+    index = idle_.back();
+    idle_.pop_back();
+  }
+  // a duplicate, so that the connection closes its own fd while the worker's stays with the pool
+  // it shares the non-blocking file status of the worker's
+  int reply_fd = fcntl(workers_[index].fd_, F_DUPFD_CLOEXEC, 0);
+  if (reply_fd == -1) {
+    Release(index, true);
+    return false;
+  }
+  // the request is tiny, so it fits in the socket buffer right away
+  if (!SendFrame(reply_fd, BuildRequest(path, arguments))) {
+    close(reply_fd);
+    Release(index, false);
+    return false;
+  }
+  auto reply_conn = std::make_unique<Connection>(std::make_unique<Socket>(reply_fd));
+  reply_conn->SetEvents(POLL_READ | POLL_ET);
+  reply_conn->SetLooper(looper);
+  // the worker is leased till its whole reply has been read, and handed back right then
+  // if the reply connection is destroyed before, e.g. kicked out, the worker is retired instead,
+  // so that a late reply is never taken as the next one's
+  looper->BeginWork();
+  auto released = std::make_shared<bool>(false);
+  std::shared_ptr<void> lease(nullptr, [this, looper, index, released](void *) {
+    if (!*released) {
+      Release(index, false);
+    }
+    looper->EndWork();
+  });
+  // the reply frame accumulates in the read buffer till its length prefix is satisfied
+  reply_conn->SetCallback([this, looper, index, lease, released, on_complete](Connection *conn) {
+    auto [read, exit] = conn->Recv();
+    uint64_t size = 0;
+    auto received = conn->GetReadBufferSize();
+    if (received >= sizeof(size)) {
+      memcpy(&size, conn->Read(), sizeof(size));
+    }
+    bool complete = received >= sizeof(size) && received - sizeof(size) >= size;
+    if (!complete && !exit) {
+      return;
+    }
+    std::optional<std::vector<unsigned char>> output;
+    if (complete) {
+      output.emplace(conn->Read() + sizeof(size), conn->Read() + sizeof(size) + size);
+      Release(index, true);
+      *released = true;
+    }
+    looper->DeleteConnection(conn->GetFd());
+    on_complete(std::move(output));
+  });
+  // bounded by the deadline rather than the idle timer, and the worker is still leased upon it,
+  // so it is retired once the reply connection is gone, no earlier than being killed here
+  pid_t worker_pid = workers_[index].pid_;
+  looper->AddConnection(std::move(reply_conn), false);
+  looper->SetDeadline(reply_fd, timeout, [worker_pid, on_complete = std::move(on_complete)]() {
+    LOG_WARNING("CgiWorkerPool: kill the worker pid={} for running a cgi program too long", worker_pid);
+    kill(-worker_pid, SIGKILL);
+    on_complete(std::nullopt);
+  });
+  return true;
+}
+
+void CgiWorkerPool::Release(size_t index, bool healthy) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  auto &worker = workers_[index];
+  if (healthy) {
+    idle_.push_back(index);
+    return;
+  }
+  // the worker is gone, or its reply is left unread, retire it and never fork a replacement from the large server
+  LOG_WARNING("CgiWorkerPool: worker pid={} is lost", worker.pid_);
+  close(worker.fd_);
+  worker.fd_ = -1;
+  alive_--;
+  retired_.push_back(index);
+  workers_retired_total.Inc();
+  // a single byte never fills the socket, the replacement is taken once the launcher passes it back
+  unsigned char request = 0;
+  if (launcher_fd_ != -1 && send(launcher_fd_, &request, sizeof(request), SEND_FLAGS) == sizeof(request)) {
+    replacing_++;
+  }
+}
+
+void CgiWorkerPool::CollectReplacements() {
+  while (replacing_ > 0) {
+    pid_t pid;
+    int fd;
+    ssize_t got = RecvWorker(launcher_fd_, &pid, &fd);
+    if (got == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (got != sizeof(pid)) {
+      LOG_ERROR("CgiWorkerPool: the launcher is gone, a lost worker is never replaced");
+      close(launcher_fd_);
+      launcher_fd_ = -1;
+      replacing_ = 0;
+      return;
+    }
+    replacing_--;
+    if (fd == -1) {
+      LOG_WARNING("CgiWorkerPool: the launcher fails to fork a replacement");
+      continue;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    auto index = retired_.back();
+    retired_.pop_back();
+    workers_[index] = {pid, fd};
+    idle_.push_back(index);
+    alive_++;
+    workers_replaced_total.Inc();
+  }
+}
+
+auto CgiWorkerPool::Size() noexcept -> size_t {
+  std::unique_lock<std::mutex> lock(mtx_);
+  CollectReplacements();
+  return alive_;
+}
+
+void CgiWorkerPool::LauncherLoop(int fd) {
+  // the replacements are reaped by the kernel as they exit, as no one waits for them
+  signal(SIGCHLD, SIG_IGN);
+  signal(SIGPIPE, SIG_IGN);
+  unsigned char request;
+  while (ReadFully(fd, &request, sizeof(request))) {
+    pid_t pid = -1;
+    int fds[2];
+    bool paired = socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0;
+    if (paired) {
+      SetCloseOnExec(fds[0]);
+      SetCloseOnExec(fds[1]);
+      pid = fork();
+      if (pid == 0) {
+        // the worker waits for its programs, and leads a process group of its own as the first ones do
+        signal(SIGCHLD, SIG_DFL);
+        setpgid(0, 0);
+        close(fd);
+        close(fds[0]);
+        WorkerLoop(fds[1]);
+      }
+      if (pid > 0) {
+        setpgid(pid, pid);
+      }
+      close(fds[1]);
+    }
+    // the server holds its own copy of the socket once passed
+    bool passed = SendWorker(fd, pid, pid > 0 ? fds[0] : -1);
+    if (paired) {
+      close(fds[0]);
+    }
+    if (!passed) {
+      break;
+    }
+  }
+  _exit(EXIT_SUCCESS);
+}
+
+void CgiWorkerPool::WorkerLoop(int fd) {
+  // a server gone midway fails the reply instead of killing the worker
+  signal(SIGPIPE, SIG_IGN);
+  std::vector<unsigned char> request;
+  while (RecvFrame(fd, request)) {
+    std::vector<char *> argv;
+    for (size_t pos = 0; pos < request.size(); pos += strlen(reinterpret_cast<char *>(&request[pos])) + 1) {
+      argv.push_back(reinterpret_cast<char *>(&request[pos]));
+    }
+    argv.push_back(nullptr);
+    std::vector<unsigned char> output;
+    int out_pipe[2];
+    if (argv.size() > 1 && pipe(out_pipe) == 0) {
+      pid_t pid = fork();
+      if (pid == 0) {
+        // an ignored signal survives execve(), and the program should die writing to a closed pipe as usual
+        signal(SIGPIPE, SIG_DFL);
+        // link cgi program's stdout to the pipe
+        dup2(out_pipe[1], STDOUT_FILENO);
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        execve(argv[0], argv.data(), nullptr);
+        // only reach here when execve fails
+        perror("fail to execve()");
+        _exit(EXIT_FAILURE);
+      }
+      close(out_pipe[1]);
+      unsigned char chunk[CGI_READ_CHUNK];
+      ssize_t got;
+      while ((got = read(out_pipe[0], chunk, sizeof(chunk))) != 0) {
+        if (got == -1 && errno == EINTR) {
+          continue;
+        }
+        if (got == -1) {
+          break;
+        }
+        output.insert(output.end(), chunk, chunk + got);
+      }
+      close(out_pipe[0]);
+      if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+      }
+    }
+    if (!SendFrame(fd, output)) {
+      break;
+    }
+  }
+  _exit(EXIT_SUCCESS);
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -5,7 +5,7 @@
  * program on Linux
  * @init_date Jan 13 2023
  *
- * This is an implementation file implementing the CGIer that forks another
+ * This is an implementation file implementing the CGIer that spawns another
  * process to run the cgi program commanded by the client through http request
  * in a RESTful style
  */
@@ -13,19 +13,76 @@
 #include "http/cgier.h"
 
 #include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#ifdef OS_LINUX
+#include <sys/signalfd.h>
+#endif
 
+#include <algorithm>
 #include <cassert>
-#include <cstdio>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
-#include <sstream>
-#include <thread>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
 
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/poller.h"
+#include "core/socket.h"
+#include "http/cgi_pool.h"
 #include "http/http_utils.h"
+#include "log/logger.h"
 namespace TURTLE_SERVER::HTTP {
 
+/* chunk size when draining the cgi program's stdout */
+static constexpr size_t CGI_READ_CHUNK = 4096;
+
+/* the asynchronously run programs yet to be reaped, shared by all the reactors */
+static std::mutex spawned_mtx;
+static std::vector<pid_t> spawned_pids;
+
+/* harvest whichever of them has exited, never block */
+static void ReapSpawned() {
+  std::unique_lock<std::mutex> lock(spawned_mtx);
+  spawned_pids.erase(std::remove_if(spawned_pids.begin(), spawned_pids.end(),
+                                    [](pid_t pid) { return waitpid(pid, nullptr, WNOHANG) != 0; }),
+                     spawned_pids.end());
+}
+
+#ifdef OS_LINUX
+/* one signalfd for the whole process, monitored by the looper which first runs a program asynchronously */
+static void WatchChildSignal(Looper *looper) {
+  static std::once_flag watch_once;
+  static std::unique_ptr<Connection> signal_conn;
+  std::call_once(watch_once, [looper]() {
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    int signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd == -1) {
+      LOG_WARNING("Cgier: fail to signalfd(), exited programs are only reaped upon the next run");
+      return;
+    }
+    signal_conn = std::make_unique<Connection>(std::make_unique<Socket>(signal_fd));
+    signal_conn->SetEvents(POLL_READ | POLL_ET);
+    signal_conn->SetLooper(looper);
+    signal_conn->SetCallback([](Connection *conn) {
+      // several SIGCHLD may coalesce into one, so drain it and reap everyone exited
+      struct signalfd_siginfo info;
+      while (read(conn->GetFd(), &info, sizeof(info)) == sizeof(info)) {
+      }
+      ReapSpawned();
+    });
+    looper->AddWatcher(signal_conn.get());
+  });
+}
+#endif
+
 auto Cgier::ParseCgier(const std::string &resource_url) noexcept -> Cgier {
   if (resource_url.empty() || !IsCgiRequest(resource_url)) {
     return MakeInvalidCgier();
@@ -47,62 +104,158 @@ auto Cgier::MakeInvalidCgier() noexcept -> Cgier {
 Cgier::Cgier(const std::string &path, const std::vector<std::string> &arguments) noexcept
     : cgi_program_path_(path), cgi_arguments_(arguments), valid_(true) {}
 
+void Cgier::BlockChildSignal() {
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGCHLD);
+  pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+}
+
+auto Cgier::Spawn(pid_t *pid) -> int {
+  int out_pipe[2];
+#ifdef OS_LINUX
+  if (pipe2(out_pipe, O_CLOEXEC) == -1) {
+    return -1;
+  }
+#elif OS_MAC
+  if (pipe(out_pipe) == -1) {
+    return -1;
+  }
+  fcntl(out_pipe[0], F_SETFD, FD_CLOEXEC);
+  fcntl(out_pipe[1], F_SETFD, FD_CLOEXEC);
+#endif
+  // link cgi program's stdout to the pipe, the duplicate loses close-on-exec
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+  // the program should not inherit the blocked SIGCHLD, nor the ignored SIGPIPE
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  sigset_t no_signal;
+  sigemptyset(&no_signal);
+  posix_spawnattr_setsigmask(&attributes, &no_signal);
+  sigset_t default_signals;
+  sigemptyset(&default_signals);
+  sigaddset(&default_signals, SIGPIPE);
+  posix_spawnattr_setsigdefault(&attributes, &default_signals);
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+  char **cgi_argv = BuildArgumentList();
+  int ret = posix_spawn(pid, cgi_program_path_.c_str(), &actions, &attributes, cgi_argv, nullptr);
+  FreeArgumentList(cgi_argv);
+  posix_spawnattr_destroy(&attributes);
+  posix_spawn_file_actions_destroy(&actions);
+  close(out_pipe[1]);
+  if (ret != 0) {
+    close(out_pipe[0]);
+    return -1;
+  }
+  return out_pipe[0];
+}
+
 auto Cgier::Run() -> std::vector<unsigned char> {
   assert(valid_);
   std::vector<unsigned char> cgi_result;
-  // unique shared filename within one Cgier
-  // when communicating between parent and child
-  std::stringstream ssr;
-  ssr << CGI_PREFIX << UNDERSCORE << std::this_thread::get_id() << ".txt";
-  std::string shared_file_name = ssr.str();
-  int fd = open(shared_file_name.c_str(), O_RDWR | O_APPEND | O_CREAT, READ_WRITE_PERMISSION);
-  if (fd == -1) {
-    std::string error = "fail to create/open the file " + shared_file_name;
-    return {error.begin(), error.end()};
-  }
-  pid_t pid = fork();
-  if (pid == -1) {
-    std::string error = "fail to fork()";
-    return {error.begin(), error.end()};
+  pid_t pid;
+  int out_fd = Spawn(&pid);
+  if (out_fd == -1) {
+    LOG_WARNING("Cgier: fail to spawn {}", cgi_program_path_);
+    return cgi_result;
   }
-  if (pid == 0) {
-    // child
-
-    // link cgi program's stdout to the shared file
-    dup2(fd, STDOUT_FILENO);
-    close(fd);
-
-    // build argument lists for the cgi program
-    char **cgi_argv = BuildArgumentList();
-
-    // walk into cig program
-    if (execve(cgi_program_path_.c_str(), cgi_argv, nullptr) < 0) {
-      // only reach here when execve fails
-      perror("fail to execve()");
-      FreeArgumentList(cgi_argv);
-      exit(1);  // exit child process
+  unsigned char chunk[CGI_READ_CHUNK];
+  ssize_t got;
+  while ((got = read(out_fd, chunk, sizeof(chunk))) != 0) {
+    if (got == -1 && errno == EINTR) {
+      continue;
     }
-  } else {
-    // parent
-    close(fd);
-    int status;
-    // wait and harvest child process
-    if (waitpid(pid, &status, 0) == -1) {
-      std::string error = "fail to harvest child by waitpid()";
-      return {error.begin(), error.end()};
+    if (got == -1) {
+      break;
     }
-    // load cgi result from the shared file
-    LoadFile(shared_file_name, cgi_result);
-    // clean it up by deleting shared file
-    DeleteFile(shared_file_name);
+    cgi_result.insert(cgi_result.end(), chunk, chunk + got);
+  }
+  close(out_fd);
+  // it is not among the spawned_pids, so harvest it here
+  while (waitpid(pid, nullptr, 0) == -1 && errno == EINTR) {
   }
   return cgi_result;
 }
 
+auto Cgier::RunAsync(CgiWorkerPool *pool, Looper *looper,
+                     std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete, uint64_t timeout)
+    -> bool {
+  assert(valid_);
+  return pool->RunAsync(looper, cgi_program_path_, cgi_arguments_, std::move(on_complete), timeout);
+}
+
+auto Cgier::RunAsync(Looper *looper, std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete,
+                     uint64_t timeout) -> bool {
+  assert(valid_);
+#ifdef OS_LINUX
+  WatchChildSignal(looper);
+#endif
+  // also catch up with whichever exited unnoticed
+  ReapSpawned();
+  int out_fd;
+  pid_t pid;
+  {
+    // registered under the same lock, so that its SIGCHLD never comes before it is known
+    std::unique_lock<std::mutex> lock(spawned_mtx);
+    out_fd = Spawn(&pid);
+    if (out_fd == -1) {
+      LOG_WARNING("Cgier: fail to spawn {}", cgi_program_path_);
+      return false;
+    }
+    spawned_pids.push_back(pid);
+  }
+  auto pipe_sock = std::make_unique<Socket>(out_fd);
+  pipe_sock->SetNonBlocking();
+  auto pipe_conn = std::make_unique<Connection>(std::move(pipe_sock));
+  pipe_conn->SetEvents(POLL_READ | POLL_ET);
+  pipe_conn->SetLooper(looper);
+  // the work is accounted till the pipe connection is destroyed, whether completed or kicked out
+  looper->BeginWork();
+  std::shared_ptr<void> work(nullptr, [looper](void *) { looper->EndWork(); });
+  // the output accumulates in the read buffer till the program closes its stdout
+  pipe_conn->SetCallback([looper, work, on_complete](Connection *conn) {
+    auto [read, exit] = conn->Recv();
+    if (!exit) {
+      return;
+    }
+    std::vector<unsigned char> cgi_result(conn->Read(), conn->Read() + conn->GetReadBufferSize());
+    looper->DeleteConnection(conn->GetFd());
+    ReapSpawned();
+    on_complete(std::move(cgi_result));
+  });
+  // bounded by the deadline rather than the idle timer, the program is killed and later reaped upon it
+  int pipe_fd = pipe_conn->GetFd();
+  looper->AddConnection(std::move(pipe_conn), false);
+  looper->SetDeadline(pipe_fd, timeout, [pid, on_complete = std::move(on_complete)]() {
+    LOG_WARNING("Cgier: kill the cgi program pid={} for running too long", pid);
+    {
+      // unless already reaped, when the pid might be recycled
+      std::unique_lock<std::mutex> lock(spawned_mtx);
+      if (std::find(spawned_pids.begin(), spawned_pids.end(), pid) != spawned_pids.end()) {
+        kill(pid, SIGKILL);
+      }
+    }
+    on_complete(std::nullopt);
+  });
+  return true;
+}
+
 auto Cgier::IsValid() const noexcept -> bool { return valid_; }
 
 auto Cgier::GetPath() const noexcept -> std::string { return cgi_program_path_; }
 
+auto Cgier::GetCacheKey() const -> std::string {
+  // the separator never appears within an argument, so the key is unambiguous
+  auto key = cgi_program_path_;
+  for (const auto &argument : cgi_arguments_) {
+    key += PARAMETER_SEPARATOR;
+    key += argument;
+  }
+  return key;
+}
+
 auto Cgier::BuildArgumentList() -> char ** {
   assert(!cgi_program_path_.empty());
   char **cgi_argv = (char **)calloc(cgi_arguments_.size() + 2, sizeof(char *));
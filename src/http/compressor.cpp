@@ -0,0 +1,173 @@
+/**
+ * @file compressor.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the Compressor that negotiates
+ * the content coding with client and keeps the compressed variants in the Cache
+ */
+
+#include "http/compressor.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+#include "core/cache.h"
+#include "core/thread_pool.h"
+#include "http/file_meta.h"
+#include "http/http_utils.h"
+#include "log/logger.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* zlib window bits, adding 16 asks for the gzip wrapper instead of the zlib one */
+static constexpr int ZLIB_WINDOW_BITS = 15;
+static constexpr int GZIP_WINDOW_BITS = ZLIB_WINDOW_BITS + 16;
+static constexpr int ZLIB_MEMORY_LEVEL = 8;
+
+auto EncodingToString(Encoding encoding) noexcept -> std::string {
+  if (encoding == Encoding::GZIP) {
+    return ENCODING_GZIP;
+  }
+  if (encoding == Encoding::DEFLATE) {
+    return ENCODING_DEFLATE;
+  }
+  return ENCODING_IDENTITY;
+}
+
+auto EncodingQuality(std::string_view accept_encoding, Encoding encoding) noexcept -> double {
+  if (encoding == Encoding::IDENTITY) {
+    return 1;
+  }
+  auto target = Format(EncodingToString(encoding));
+  // quality of the target coding and the wildcard, -1 for not mentioned
+  double target_q = -1;
+  double star_q = -1;
+  for (const auto &token : Split(std::string(accept_encoding), ",")) {
+    auto params = Split(token, SEMICOLON);
+    if (params.empty()) {
+      continue;
+    }
+    auto coding = Format(params[0]);
+    double q = 1;
+    for (size_t i = 1; i < params.size(); i++) {
+      auto param = Trim(params[i]);
+      if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+        q = std::strtod(param.c_str() + 2, nullptr);
+      }
+    }
+    if (coding == target || (encoding == Encoding::GZIP && coding == "X-GZIP")) {
+      target_q = q;
+    } else if (coding == "*") {
+      star_q = q;
+    }
+  }
+  return std::max((target_q < 0) ? star_q : target_q, 0.0);
+}
+
+auto NegotiateEncoding(std::string_view accept_encoding) noexcept -> Encoding {
+  double gzip_q = EncodingQuality(accept_encoding, Encoding::GZIP);
+  double deflate_q = EncodingQuality(accept_encoding, Encoding::DEFLATE);
+  if (gzip_q > 0 && gzip_q >= deflate_q) {
+    return Encoding::GZIP;
+  }
+  if (deflate_q > 0) {
+    return Encoding::DEFLATE;
+  }
+  return Encoding::IDENTITY;
+}
+
+auto IsCompressibleMime(std::string_view mime) noexcept -> bool {
+  return mime.rfind("text/", 0) == 0 || mime.find("javascript") != std::string_view::npos ||
+         mime.find("json") != std::string_view::npos || mime.find("xml") != std::string_view::npos;
+}
+
+auto Compress(const std::vector<unsigned char> &source, Encoding encoding,
+              std::vector<unsigned char> &destination) noexcept -> bool {  // NOLINT
+  if (encoding == Encoding::IDENTITY) {
+    return false;
+  }
+  z_stream stream{};
+  int window_bits = (encoding == Encoding::GZIP) ? GZIP_WINDOW_BITS : ZLIB_WINDOW_BITS;
+  if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, ZLIB_MEMORY_LEVEL, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    return false;
+  }
+  size_t old_size = destination.size();
+  // the bound is conservative but leaves a few bytes short for the gzip wrapper
+  size_t bound = deflateBound(&stream, source.size()) + 32;
+  destination.resize(old_size + bound);
+  stream.next_in = const_cast<Bytef *>(source.data());
+  stream.avail_in = static_cast<uInt>(source.size());
+  stream.next_out = destination.data() + old_size;
+  stream.avail_out = static_cast<uInt>(bound);
+  int ret = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (ret != Z_STREAM_END) {
+    destination.resize(old_size);
+    return false;
+  }
+  destination.resize(old_size + stream.total_out);
+  return true;
+}
+
+Compressor::Compressor(std::shared_ptr<Cache> cache, size_t threshold, int concurrency)
+    : cache_(std::move(cache)), threshold_(threshold), pool_(std::make_unique<ThreadPool>(concurrency)) {}
+
+Compressor::~Compressor() {
+  // harvest the background workers before the pending set and its mutex go away
+  pool_.reset();
+}
+
+auto Compressor::ShouldCompress(std::string_view mime, size_t size) const noexcept -> bool {
+  return size >= threshold_ && IsCompressibleMime(mime);
+}
+
+auto Compressor::TryLoad(const std::string &resource_path, const std::string &cache_key, Encoding encoding,
+                         std::vector<unsigned char> &destination) -> bool {
+  if (encoding == Encoding::IDENTITY) {
+    return false;
+  }
+  auto variant_key = cache_key + SEMICOLON + EncodingToString(encoding);
+  if (cache_->TryLoad(variant_key, destination)) {
+    return true;
+  }
+  Schedule(resource_path, variant_key, cache_key, encoding);
+  return false;
+}
+
+void Compressor::Schedule(const std::string &resource_path, const std::string &variant_key,
+                          const std::string &cache_key, Encoding encoding) {
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    if (!pending_.insert(variant_key).second) {
+      // someone else is already compressing it
+      return;
+    }
+  }
+  pool_->SubmitTask([this, resource_path, variant_key, cache_key, encoding]() {
+    std::vector<unsigned char> identity;
+    // the identity version is keyed by path + entity tag, only use the file if it's still that version
+    if (!cache_->TryLoad(cache_key, identity)) {
+      auto meta = FileMetaCache::Stat(resource_path, false);
+      if (meta->exists_ && resource_path + meta->etag_ == cache_key) {
+        LoadFile(resource_path, identity);
+      }
+    }
+    std::vector<unsigned char> compressed;
+    if (!identity.empty() && Compress(identity, encoding, compressed)) {
+      cache_->TryInsert(variant_key, compressed);
+    } else {
+      LOG_WARNING("Compressor: fail to compress {}", resource_path);
+    }
+    std::unique_lock<std::mutex> lock(mtx_);
+    pending_.erase(variant_key);
+  });
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -0,0 +1,130 @@
+/**
+ * @file file_meta.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the file metadata cache, which
+ * remembers the stat() result and the derived validators of the static resources
+ */
+
+#include "http/file_meta.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+
+#include "core/cache.h"
+#include "http/http_utils.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* enough for three 64-bit hex numbers, two dashes and two quotes */
+static constexpr size_t ETAG_MAX_LEN = 3 * 16 + 2 + 2;
+
+FileMetaCache::FileMetaCache(uint64_t revalidate_interval, size_t capacity) noexcept
+    : revalidate_interval_(revalidate_interval), capacity_(capacity) {}
+
+auto FileMetaCache::Lookup(const std::string &file_path) -> std::shared_ptr<const FileMeta> {
+  auto now = GetTimeUtc();
+  {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    auto iter = mapping_.find(file_path);
+    if (iter != mapping_.end() && now - iter->second->checked_at_ < revalidate_interval_) {
+      return iter->second;
+    }
+  }
+  // missing or out of date, stat() outside of the lock
+  auto meta = Stat(file_path);
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  if (mapping_.size() >= capacity_ && mapping_.find(file_path) == mapping_.end()) {
+    // no recency tracking here, an arbitrary victim is good enough for metadata
+    mapping_.erase(mapping_.begin());
+  }
+  mapping_[file_path] = meta;
+  return meta;
+}
+
+auto FileMetaCache::Size() -> size_t {
+  std::shared_lock<std::shared_mutex> lock(mtx_);
+  return mapping_.size();
+}
+
+void FileMetaCache::Clear() {
+  std::unique_lock<std::shared_mutex> lock(mtx_);
+  mapping_.clear();
+}
+
+auto FileMetaCache::Stat(const std::string &file_path, bool probe_sibling) -> std::shared_ptr<const FileMeta> {
+  auto meta = std::make_shared<FileMeta>();
+  meta->checked_at_ = GetTimeUtc();
+  struct stat file_stat {};
+  if (stat(file_path.c_str(), &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+    return meta;
+  }
+  meta->exists_ = true;
+  meta->size_ = file_stat.st_size;
+  meta->inode_ = file_stat.st_ino;
+  meta->mtime_ = file_stat.st_mtime;
+#ifdef OS_LINUX
+  auto mtime_nanos = static_cast<uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+#elif OS_MAC
+  auto mtime_nanos =
+      static_cast<uint64_t>(file_stat.st_mtimespec.tv_sec) * 1000000000 + file_stat.st_mtimespec.tv_nsec;
+#endif
+  char etag[ETAG_MAX_LEN + 1];
+  int len = snprintf(etag, sizeof(etag), "\"%llx-%llx-%llx\"", static_cast<unsigned long long>(meta->inode_),  // NOLINT
+                     static_cast<unsigned long long>(meta->size_),                                         // NOLINT
+                     static_cast<unsigned long long>(mtime_nanos));                                        // NOLINT
+  meta->etag_.assign(etag, len);
+  meta->last_modified_ = ToHttpDate(meta->mtime_);
+  if (probe_sibling) {
+    // a sibling older than the file itself is stale and never served
+    auto sibling = Stat(file_path + GZIP_SUFFIX, false);
+    if (sibling->exists_ && sibling->mtime_ >= meta->mtime_) {
+      meta->gzip_sibling_ = sibling;
+    }
+  }
+  return meta;
+}
+
+/* weak comparison ignores the W/ prefix on either side */
+static auto StripWeak(const std::string &etag) -> std::string {
+  return (etag.size() > 2 && etag[0] == 'W' && etag[1] == '/') ? etag.substr(2) : etag;
+}
+
+auto IsNotModified(std::optional<std::string_view> if_none_match, std::optional<std::string_view> if_modified_since,
+                   const FileMeta &meta) -> bool {
+  if (!meta.exists_) {
+    return false;
+  }
+  // If-None-Match takes precedence, If-Modified-Since is then ignored
+  if (if_none_match.has_value()) {
+    auto tags = std::string(if_none_match.value());
+    if (Trim(tags) == "*") {
+      return true;
+    }
+    for (const auto &etag : Split(tags, ",")) {
+      if (StripWeak(Trim(etag)) == meta.etag_) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (if_modified_since.has_value()) {
+    auto since = ParseHttpDate(std::string(if_modified_since.value()));
+    return since.has_value() && meta.mtime_ <= since.value();
+  }
+  return false;
+}
+
+auto IsRangeFresh(std::string_view if_range, const FileMeta &meta) noexcept -> bool {
+  if (!if_range.empty() && if_range[0] == '"') {
+    // strong comparison, a weak tag never matches
+    return if_range == meta.etag_;
+  }
+  return if_range == meta.last_modified_;
+}
+
+}  // namespace TURTLE_SERVER::HTTP
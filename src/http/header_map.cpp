@@ -0,0 +1,94 @@
+/**
+ * @file header_map.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the compact header container of
+ * a request, which views into the raw request instead of owning copies of the headers
+ */
+
+#include "http/header_map.h"
+
+#include <limits>
+#include <utility>
+
+#include "http/lookup_table.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+static constexpr PerfectHashTable<HeaderId, HEADER_ID_COUNT> HEADER_ID_TABLE{
+    std::array<std::pair<std::string_view, HeaderId>, HEADER_ID_COUNT>{{
+        {"Host", HeaderId::HOST},
+        {"Connection", HeaderId::CONNECTION},
+        {"Content-Length", HeaderId::CONTENT_LENGTH},
+        {"Content-Type", HeaderId::CONTENT_TYPE},
+        {"User-Agent", HeaderId::USER_AGENT},
+        {"Accept", HeaderId::ACCEPT},
+        {"Accept-Encoding", HeaderId::ACCEPT_ENCODING},
+        {"Accept-Language", HeaderId::ACCEPT_LANGUAGE},
+        {"Range", HeaderId::RANGE},
+        {"If-Range", HeaderId::IF_RANGE},
+        {"If-None-Match", HeaderId::IF_NONE_MATCH},
+        {"If-Modified-Since", HeaderId::IF_MODIFIED_SINCE},
+        {"Cookie", HeaderId::COOKIE},
+        {"Authorization", HeaderId::AUTHORIZATION},
+        {"Referer", HeaderId::REFERER},
+        {"Cache-Control", HeaderId::CACHE_CONTROL},
+    }}};
+static_assert(HEADER_ID_TABLE.IsPerfect());
+
+auto ToHeaderId(std::string_view name) noexcept -> HeaderId {
+  return HEADER_ID_TABLE.Find(name).value_or(HeaderId::UNKNOWN);
+}
+
+void HeaderMap::Add(std::string_view name, std::string_view value) {
+  Entry entry{ToHeaderId(name), name, value};
+  if (entry.id_ != HeaderId::UNKNOWN && size_ < std::numeric_limits<uint16_t>::max()) {
+    auto &position = index_[static_cast<size_t>(entry.id_)];
+    if (position == 0) {
+      position = static_cast<uint16_t>(size_ + 1);
+    }
+  }
+  if (size_ < entries_.size()) {
+    entries_[size_] = entry;
+  } else {
+    spilled_entries_.push_back(entry);
+  }
+  size_++;
+}
+
+auto HeaderMap::Get(HeaderId id) const noexcept -> std::optional<std::string_view> {
+  if (id == HeaderId::UNKNOWN || index_[static_cast<size_t>(id)] == 0) {
+    return std::nullopt;
+  }
+  return At(index_[static_cast<size_t>(id)] - 1).value_;
+}
+
+auto HeaderMap::Get(std::string_view name) const noexcept -> std::optional<std::string_view> {
+  auto id = ToHeaderId(name);
+  if (id != HeaderId::UNKNOWN) {
+    return Get(id);
+  }
+  for (size_t i = 0; i < size_; i++) {
+    if (CaseInsensitiveEqual(At(i).name_, name)) {
+      return At(i).value_;
+    }
+  }
+  return std::nullopt;
+}
+
+auto HeaderMap::Size() const noexcept -> size_t { return size_; }
+
+auto HeaderMap::At(size_t index) const noexcept -> const Entry & {
+  return (index < entries_.size()) ? entries_[index] : spilled_entries_[index - entries_.size()];
+}
+
+void HeaderMap::Clear() noexcept {
+  size_ = 0;
+  spilled_entries_.clear();
+  index_.fill(0);
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -5,99 +5,469 @@
  * @init_date Jan 3 2023
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+
+#include "core/alloc_tracker.h"
+#include "core/metrics.h"
 #include "core/turtle_server.h"
+#include "http/access_log.h"
+#include "http/admission.h"
+#include "http/cgi_pool.h"
 #include "http/cgier.h"
+#include "http/compressor.h"
+#include "http/file_meta.h"
 #include "http/header.h"
+#include "http/header_map.h"
 #include "http/http_utils.h"
+#include "http/range.h"
 #include "http/request.h"
 #include "http/response.h"
+#include "http/router.h"
 #include "log/logger.h"
 
 namespace TURTLE_SERVER::HTTP {
 
-void ProcessHttpRequest(  // NOLINT
-    const std::string &serving_directory,
-    std::shared_ptr<Cache> &cache,  // NOLINT
-    Connection *client_conn) {
+/* the requests served by status, and how long each takes till its response is handed to the write path */
+static const auto request_counters = [] {
+  std::array<Counter, STATUS_CODE.size()> counters;
+  for (size_t i = 0; i < STATUS_CODE.size(); i++) {
+    counters[i] = MetricsRegistry::GetInstance().AddCounter(
+        "turtle_http_requests_total", "HTTP requests served", "status=\"" + std::to_string(STATUS_CODE[i]) + "\"");
+  }
+  return counters;
+}();
+static const Histogram request_latency_histogram = MetricsRegistry::GetInstance().AddHistogram(
+    "turtle_http_request_latency_us", "HTTP request latency till the response is handed to the write path");
+static const Counter range_bytes_total = MetricsRegistry::GetInstance().AddCounter(
+    "turtle_http_range_bytes_total", "Bytes of the partial content served for the Range requests");
+
+/* the heap traffic of the requests by status, only declared when tracked */
+struct AllocationCounters {
+  Counter allocations_;
+  Counter bytes_;
+};
+static const auto request_allocation_counters = [] {
+  std::array<AllocationCounters, STATUS_CODE.size()> counters;
+  for (size_t i = 0; ALLOC_TRACKING_ENABLED && i < STATUS_CODE.size(); i++) {
+    auto labels = "status=\"" + std::to_string(STATUS_CODE[i]) + "\"";
+    counters[i].allocations_ = MetricsRegistry::GetInstance().AddCounter(
+        "turtle_http_request_allocations_total", "Heap allocations made serving the HTTP requests", labels);
+    counters[i].bytes_ = MetricsRegistry::GetInstance().AddCounter(
+        "turtle_http_request_allocated_bytes_total", "Heap bytes allocated serving the HTTP requests", labels);
+  }
+  return counters;
+}();
+
+/* attach the validators so that the client could revalidate later */
+void AddValidators(Response &response, const FileMeta &meta, bool weak = false) {  // NOLINT
+  response.AddHeader(HEADER_ETAG, weak ? "W/" + meta.etag_ : meta.etag_);
+  response.AddHeader(HEADER_LAST_MODIFIED, meta.last_modified_);
+}
+
+/*
+ * serve the requested byte Range of a static resource through zero-copy sendfile
+ * return false if the Range is to be ignored, and the full resource should be served instead
+ */
+auto ServeRangeRequest(const Request &request, const std::string &resource_full_path, const FileMeta &meta,
+                       Connection *client_conn) -> bool {
+  // If-Range: the partial content is only valid if the resource is unchanged
+  auto if_range = request.GetHeader(HeaderId::IF_RANGE);
+  if (if_range.has_value() && !IsRangeFresh(if_range.value(), meta)) {
+    return false;
+  }
+  auto range = Range::ParseRange(std::string(request.GetHeader(HeaderId::RANGE).value()), meta.size_);
+  if (range.GetStatus() == RangeStatus::IGNORED) {
+    return false;
+  }
+  if (range.GetStatus() == RangeStatus::UNSATISFIABLE) {
+    auto response = Response::Make416Response(request.ShouldClose(), range.UnsatisfiedContentRange());
+    response.Serialize(client_conn);
+    client_conn->Send();
+    return true;
+  }
+  int file_fd = open(resource_full_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_fd == -1) {
+    return false;
+  }
+  auto mime = ToMime(resource_full_path);
+  const auto &slices = range.GetSlices();
+  Response response{Status::PARTIAL_CONTENT, request.ShouldClose(), mime, slices[0].Length()};
+  AddValidators(response, meta);
+  if (!range.IsMultipart()) {
+    response.AddHeader(HEADER_CONTENT_RANGE, range.ContentRange(slices[0]));
+    response.Serialize(client_conn);
+    client_conn->Send();
+    if (client_conn->SendFile(file_fd, static_cast<off_t>(slices[0].first_), slices[0].Length())) {
+      range_bytes_total.Inc(slices[0].Length());
+    }
+    close(file_fd);
+    return true;
+  }
+  // multiple slices are framed as a multipart/byteranges body
+  response.SetContentType(MIME_MULTIPART_BYTERANGES);
+  response.SetContentLength(range.MultipartLength(mime));
+  response.Serialize(client_conn);
+  for (size_t i = 0; i < slices.size(); i++) {
+    client_conn->WriteToWriteBuffer(range.PartHeader(i, mime));
+    client_conn->Send();
+    if (!client_conn->SendFile(file_fd, static_cast<off_t>(slices[i].first_), slices[i].Length())) {
+      // the connection is closing, nothing more of the body could follow
+      close(file_fd);
+      return true;
+    }
+    range_bytes_total.Inc(slices[i].Length());
+  }
+  client_conn->WriteToWriteBuffer(range.PartTrailer());
+  client_conn->Send();
+  close(file_fd);
+  return true;
+}
+
+/*
+ * serve the precompressed gzip sibling of a static resource through zero-copy sendfile
+ * return false if the sibling is gone, and the resource should be served as usual instead
+ */
+auto ServePrecompressed(const Request &request, const std::string &resource_full_path, const FileMeta &meta,
+                        Connection *client_conn) -> bool {
+  const auto &sibling = *meta.gzip_sibling_;
+  int file_fd = open((resource_full_path + GZIP_SUFFIX).c_str(), O_RDONLY | O_CLOEXEC);
+  if (file_fd == -1) {
+    return false;
+  }
+  // headers describe the original resource, except for the coding and length
+  Response response{Status::OK, request.ShouldClose(), ToMime(resource_full_path), sibling.size_};
+  response.AddHeader(HEADER_CONTENT_ENCODING, ENCODING_GZIP);
+  AddValidators(response, meta, true);
+  response.AddHeader(HEADER_VARY, HEADER_ACCEPT_ENCODING);
+  response.Serialize(client_conn);
+  client_conn->Send();
+  if (request.GetMethod() == Method::GET) {
+    client_conn->SendFile(file_fd, 0, sibling.size_);
+  }
+  close(file_fd);
+  return true;
+}
+
+/* the part of an access record known before the request is served, a rejected one has no request */
+auto MakeAccessRecord(Connection *client_conn, const Request *request) -> AccessRecord {
+  AccessRecord record;
+  record.SetClient(client_conn->GetPeerIp());
+  if (request != nullptr) {
+    record.SetRequest(request->GetMethod(), request->GetVersion(), request->GetResourceUrl(),
+                      request->GetHeader(HeaderId::REFERER).value_or(""),
+                      request->GetHeader(HeaderId::USER_AGENT).value_or(""));
+  }
+  return record;
+}
+
+/* count the request by its status, return its latency in microseconds */
+auto RecordRequest(Status status, std::chrono::steady_clock::time_point started) -> uint64_t {
+  auto latency =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+  request_counters[static_cast<size_t>(status)].Inc();
+  request_latency_histogram.Record(latency);
+  return latency;
+}
+
+/* count the allocations made serving a request, which divided by its requests of the status is the average */
+void RecordAllocations(Status status, const AllocationScope &allocations) noexcept {
+  if constexpr (ALLOC_TRACKING_ENABLED) {
+    auto allocated = allocations.Get();
+    request_allocation_counters[static_cast<size_t>(status)].allocations_.Inc(allocated.allocations_);
+    request_allocation_counters[static_cast<size_t>(status)].bytes_.Inc(allocated.bytes_);
+  }
+}
+
+/* complete the record once its response is handed to the write path, the rest is off the reactor */
+void LogAccess(AccessLog *access_log, AccessRecord &record, uint64_t latency, uint64_t bytes,  // NOLINT
+               Status status) {
+  auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+                 std::chrono::system_clock::now().time_since_epoch())
+                 .count();
+  record.timestamp_ = now - static_cast<int64_t>(latency);
+  record.latency_ = static_cast<uint32_t>(latency);
+  record.bytes_ = bytes;
+  record.status_ = STATUS_CODE[static_cast<size_t>(status)];
+  access_log->Record(record);
+}
+
+/* frame the output of a CGI program as the response */
+void SerializeCgiResponse(bool should_close, const std::vector<unsigned char> &cgi_result, Connection *client_conn) {
+  auto response = Response::Make200Response(should_close, std::nullopt);
+  response.SetContentLength(cgi_result.size());
+  response.Serialize(client_conn);
+  client_conn->GetWriteBuffer()->Append(cgi_result.data(), cgi_result.size());
+}
+
+/*
+ * the dynamic CGI handler, mounted at the cgi-bin folder
+ * an idle pooled worker launches it, otherwise the program is spawned, either way off the reactor,
+ * and the client is suspended till the response is written by the completion
+ * if the route opts in a result cache, a fresh result of the same program and arguments is reused
+ * the access of a suspended client is logged by the completion
+ */
+auto ServeCgi(const std::string &serving_directory, CgiWorkerPool *cgi_pool, Cache *cgi_cache, FileMetaCache *metas,
+              AccessLog *access_log, const Request &request, Connection *client_conn) -> bool {
+  Cgier cgier = Cgier::ParseCgier(serving_directory + request.GetResourceUrl());
+  if (!cgier.IsValid()) {
+    Response::Make400Response().Serialize(client_conn);
+    return true;
+  }
+  auto meta = metas->Lookup(cgier.GetPath());
+  if (!meta->exists_) {
+    Response::Make404Response().Serialize(client_conn);
+    return true;
+  }
+  bool should_close = request.ShouldClose();
+  // keyed by the entity tag of the binary as well, so that a rebuilt program is never served stale
+  auto cache_key = cgier.GetCacheKey() + meta->etag_;
+  std::vector<unsigned char> cached_result;
+  if (cgi_cache != nullptr && cgi_cache->TryLoad(cache_key, cached_result)) {
+    SerializeCgiResponse(should_close, cached_result, client_conn);
+    return should_close;
+  }
+  // the client connection might be gone by then, and its fd recycled, so look it up by fd and id
+  auto *looper = client_conn->GetLooper();
+  int client_fd = client_conn->GetFd();
+  auto client_id = client_conn->GetId();
+  auto started = std::chrono::steady_clock::now();
+  auto access_record = access_log != nullptr ? MakeAccessRecord(client_conn, &request) : AccessRecord{};
+  // no output if the program runs too long or the pooled worker is lost midway, which the client is told to retry
+  auto complete = [=](std::optional<std::vector<unsigned char>> &&cgi_result) mutable {
+    if (cgi_result.has_value() && cgi_cache != nullptr) {
+      cgi_cache->TryInsert(cache_key, cgi_result.value());
+    }
+    auto *client = looper->FindConnection(client_fd);
+    if (client == nullptr || client->GetId() != client_id) {
+      return;
+    }
+    auto bytes_out = client->GetBytesOut();
+    auto status = cgi_result.has_value() ? Status::OK : Status::SERVICE_UNAVAILABLE;
+    if (cgi_result.has_value()) {
+      SerializeCgiResponse(should_close, cgi_result.value(), client);
+    } else {
+      Response::Make503Response(DEFAULT_RETRY_AFTER).Serialize(client);
+      should_close = true;
+    }
+    auto latency = RecordRequest(status, started);
+    if (access_log != nullptr) {
+      LogAccess(access_log, access_record, latency, client->GetBytesOut() - bytes_out, status);
+    }
+    client->Send();
+    client->Resume();
+    if (should_close) {
+      looper->CloseConnection(client_fd);
+      return;
+    }
+    // serve the following requests buffered meanwhile
+    client->GetCallback()();
+  };
+  // an idle pooled worker is preferred, whose reply is read on the looper as the spawned program's output is
+  bool spawned = cgier.RunAsync(cgi_pool, looper, complete) || cgier.RunAsync(looper, complete);
+  if (!spawned) {
+    Response::Make503Response(DEFAULT_RETRY_AFTER).Serialize(client_conn);
+    return true;
+  }
+  client_conn->Suspend();
+  return false;
+}
+
+/* the metrics handler, every metric of the process in the Prometheus text format */
+auto ServeMetrics(const Request &request, Connection *client_conn) -> bool {
+  std::string exposition;
+  MetricsRegistry::GetInstance().Expose(exposition);
+  Response response{Status::OK, request.ShouldClose(), MIME_PROMETHEUS_TEXT, exposition.size()};
+  response.AddHeader(HEADER_CACHE_CONTROL, CACHE_CONTROL_NO_STORE);
+  response.Serialize(client_conn);
+  if (request.GetMethod() == Method::GET) {
+    client_conn->WriteToWriteBuffer(exposition);
+  }
+  return request.ShouldClose();
+}
+
+/* the static resource handler, mounted at the root of the serving directory */
+auto ServeStatic(const std::string &serving_directory, Cache *cache, FileMetaCache *metas, Compressor *compressor,
+                 const Request &request, Connection *client_conn) -> bool {
+  auto *response_buf = client_conn->GetWriteBuffer();
+  std::string resource_full_path = serving_directory + request.GetResourceUrl();
+  auto meta = metas->Lookup(resource_full_path);
+  if (!meta->exists_) {
+    Response::Make404Response().Serialize(client_conn);
+    return true;
+  }
+  // the response of a compressible resource varies with the client's Accept-Encoding
+  auto mime = ToMime(resource_full_path);
+  bool compressible = compressor->ShouldCompress(mime, meta->size_);
+  bool precompressed = meta->gzip_sibling_ != nullptr;
+  if (IsNotModified(request.GetHeader(HeaderId::IF_NONE_MATCH), request.GetHeader(HeaderId::IF_MODIFIED_SINCE),
+                    *meta)) {
+    // the client's copy is still fresh, the file content is never touched
+    auto response = Response::Make304Response(request.ShouldClose());
+    AddValidators(response, *meta);
+    if (compressible || precompressed) {
+      response.AddHeader(HEADER_VARY, HEADER_ACCEPT_ENCODING);
+    }
+    response.Serialize(client_conn);
+    return request.ShouldClose();
+  }
+  if (request.GetMethod() == Method::GET && request.GetHeader(HeaderId::RANGE).has_value() &&
+      ServeRangeRequest(request, resource_full_path, *meta, client_conn)) {
+    // partial content is already sent out through the zero-copy path, unless it failed and the connection is closing
+    return request.ShouldClose() || client_conn->IsClosing();
+  }
+  if (precompressed &&
+      EncodingQuality(request.GetHeader(HeaderId::ACCEPT_ENCODING).value_or(""), Encoding::GZIP) > 0 &&
+      ServePrecompressed(request, resource_full_path, *meta, client_conn)) {
+    // compressed at build time, sent out through the zero-copy path at no CPU cost
+    return request.ShouldClose() || client_conn->IsClosing();
+  }
+  // negotiate the content coding, only a full GET of a text-like resource is compressed
+  auto encoding = (compressible && request.GetMethod() == Method::GET)
+                      ? NegotiateEncoding(request.GetHeader(HeaderId::ACCEPT_ENCODING).value_or(""))
+                      : Encoding::IDENTITY;
+  // length and type are known from the metadata already, no stat() again
+  Response response{Status::OK, request.ShouldClose(), mime, meta->size_};
+  std::vector<unsigned char> cache_buf;
+  // keyed by the entity tag as well, so that a modified file is never served stale
+  auto cache_key = resource_full_path + meta->etag_;
+  if (compressor->TryLoad(resource_full_path, cache_key, encoding, cache_buf)) {
+    // the compressed variant is a different representation, so its validator is weak
+    response.SetContentLength(cache_buf.size());
+    response.AddHeader(HEADER_CONTENT_ENCODING, EncodingToString(encoding));
+    AddValidators(response, *meta, true);
+  } else {
+    AddValidators(response, *meta);
+    if (request.GetMethod() == Method::GET) {
+      // only concern about carrying content when GET request
+      bool resource_cached = cache->TryLoad(cache_key, cache_buf);
+      if (!resource_cached) {
+        // if content directly from cache, not disk file I/O
+        // otherwise content not in cache, load from disk and try cache it
+        LoadFile(resource_full_path, cache_buf);
+        cache->TryInsert(cache_key, cache_buf);
+      }
+    }
+  }
+  if (compressible || precompressed) {
+    response.AddHeader(HEADER_VARY, HEADER_ACCEPT_ENCODING);
+  }
+  response.Serialize(client_conn);
+  // now cache_buf contains the file content anyway
+  response_buf->Append(cache_buf.data(), cache_buf.size());
+  return request.ShouldClose();
+}
+
+/* the response rejecting a request head that exceeds the limits */
+auto MakeRejectResponse(Status status) noexcept -> Response {
+  return status == Status::URI_TOO_LONG ? Response::Make414Response() : Response::Make431Response();
+}
+
+/*
+ * serve the complete requests buffered in order, each response is logged into the access log if any
+ * the access of a request suspended by its handler is logged once it is resumed
+ */
+void ProcessHttpRequest(const Router &router, const RequestLimits &limits, const AdmissionLimits &admission,
+                        ClientLimiter *limiter, AccessLog *access_log, Connection *client_conn) {
   // edge-trigger, first read all available bytes
   int from_fd = client_conn->GetFd();
   auto [read, exit] = client_conn->Recv();
   if (exit) {
     client_conn->GetLooper()->DeleteConnection(from_fd);
-    LOG_INFO("client fd=" + std::to_string(from_fd) + " has exited");
+    LOG_INFO("client fd={} has exited", from_fd);
     // client_conn ptr is invalid below here, do not touch it again
     return;
   }
+  if (client_conn->IsSuspended()) {
+    // a response is still being prepared, keep the following requests in order
+    return;
+  }
   // check if there is any complete http request ready
   bool no_more_parse = false;
   std::optional<std::string> request_op = client_conn->FindAndPopTill("\r\n\r\n");
+  bool progressed = request_op.has_value();
   while (request_op != std::nullopt) {
-    Request request{request_op.value()};
-    std::vector<unsigned char> response_buf;
-    if (!request.IsValid()) {
-      auto response = Response::Make400Response();
+    auto started = std::chrono::steady_clock::now();
+    auto bytes_out = client_conn->GetBytesOut();
+    AllocationScope allocations;
+    client_conn->SetResponseStatus(NO_RESPONSE_STATUS);
+    // constructed in place, as it refers into its own copy of the head
+    std::optional<Request> request;
+    auto exceeded = CheckRequestLimits(request_op.value(), limits);
+    if (exceeded.has_value()) {
+      MakeRejectResponse(exceeded.value()).Serialize(client_conn);
+      no_more_parse = true;
+    } else if (limiter != nullptr && !limiter->TryRequest(client_conn->GetPeerIp())) {
+      // an abusive client is cut off before it costs any more of the reactor
+      Response::Make429Response(admission.retry_after_).Serialize(client_conn);
+      no_more_parse = true;
+    } else if (client_conn->GetServedCount() == 0 && IsOverloaded(client_conn->GetLooper()->GetLoad(), admission)) {
+      // a new client is turned away at once, the ones already being served keep their priority
+      Response::Make503Response(admission.retry_after_).Serialize(client_conn);
       no_more_parse = true;
-      response.Serialize(response_buf);
     } else {
-      std::string resource_full_path = serving_directory + request.GetResourceUrl();
-      if (IsCgiRequest(resource_full_path)) {
-        // dynamic CGI request
-        Cgier cgier = Cgier::ParseCgier(resource_full_path);
-        if (!cgier.IsValid()) {
-          auto response = Response::Make400Response();
-          no_more_parse = true;
-          response.Serialize(response_buf);
-        } else {
-          auto cgi_program_path = cgier.GetPath();
-          if (!IsFileExists(cgi_program_path)) {
-            auto response = Response::Make404Response();
-            no_more_parse = true;
-            response.Serialize(response_buf);
-          } else {
-            auto cgi_result = cgier.Run();
-            auto response = Response::Make200Response(request.ShouldClose(), std::nullopt);
-            response.ChangeHeader(HEADER_CONTENT_LENGTH, std::to_string(cgi_result.size()));
-            no_more_parse = request.ShouldClose();
-            response.Serialize(response_buf);
-            response_buf.insert(response_buf.end(), cgi_result.begin(), cgi_result.end());
-          }
-        }
+      request.emplace(std::move(request_op.value()));
+      if (!request->IsValid()) {
+        // the response head is serialized right into the write buffer
+        Response::Make400Response().Serialize(client_conn);
+        no_more_parse = true;
+        request.reset();
       } else {
-        // static resource request
-        if (!IsFileExists(resource_full_path)) {
-          auto response = Response::Make404Response();
-          no_more_parse = true;
-          response.Serialize(response_buf);
-        } else {
-          auto response = Response::Make200Response(request.ShouldClose(), resource_full_path);
-          response.Serialize(response_buf);
-          no_more_parse = request.ShouldClose();
-          std::vector<unsigned char> cache_buf;
-          if (request.GetMethod() == Method::GET) {
-            // only concern about carrying content when GET request
-            bool resource_cached = cache->TryLoad(resource_full_path, cache_buf);
-            if (!resource_cached) {
-              // if content directly from cache, not disk file I/O
-              // otherwise content not in cache, load from disk and try cache it
-              LoadFile(resource_full_path, cache_buf);
-              cache->TryInsert(resource_full_path, cache_buf);
-            }
-          }
-          // now cache_buf contains the file content anyway
-          response_buf.insert(response_buf.end(), cache_buf.begin(), cache_buf.end());
-        }
+        client_conn->IncrementServed();
+        no_more_parse = router.Dispatch(*request, client_conn);
+      }
+    }
+    if (!client_conn->IsSuspended()) {
+      // a custom handler writing its response as raw bytes is taken as a success
+      auto status_code = client_conn->GetResponseStatus();
+      auto status = status_code == NO_RESPONSE_STATUS ? Status::OK : static_cast<Status>(status_code);
+      auto latency = RecordRequest(status, started);
+      if (access_log != nullptr) {
+        auto record = MakeAccessRecord(client_conn, request.has_value() ? &*request : nullptr);
+        LogAccess(access_log, record, latency, client_conn->GetBytesOut() - bytes_out, status);
       }
+      RecordAllocations(status, allocations);
     }
-    // send out the response
-    client_conn->WriteToWriteBuffer(std::move(response_buf));
+    // send out the response, whatever the socket could not take is flushed later on
     client_conn->Send();
-    if (no_more_parse) {
+    if (no_more_parse || client_conn->IsSuspended() || client_conn->IsReadPaused()) {
+      // a paused client has the following requests served once its responses drain
       break;
     }
     request_op = client_conn->FindAndPopTill("\r\n\r\n");
   }
+  if (!no_more_parse && !client_conn->IsSuspended() && !client_conn->IsReadPaused()) {
+    // whatever left is an incomplete head, which is bounded in size as well as in time
+    std::string_view pending{reinterpret_cast<const char *>(client_conn->Read()), client_conn->GetReadBufferSize()};
+    auto exceeded = CheckRequestLimits(pending, limits);
+    if (exceeded.has_value()) {
+      auto started = std::chrono::steady_clock::now();
+      auto bytes_out = client_conn->GetBytesOut();
+      AllocationScope allocations;
+      MakeRejectResponse(exceeded.value()).Serialize(client_conn);
+      auto latency = RecordRequest(exceeded.value(), started);
+      if (access_log != nullptr) {
+        auto record = MakeAccessRecord(client_conn, nullptr);
+        LogAccess(access_log, record, latency, client_conn->GetBytesOut() - bytes_out, exceeded.value());
+      }
+      RecordAllocations(exceeded.value(), allocations);
+      client_conn->Send();
+      no_more_parse = true;
+    } else {
+      if (progressed) {
+        client_conn->GetLooper()->ClearDeadline(from_fd);
+      }
+      if (!pending.empty() && limits.header_timeout_ != 0) {
+        // trickling more bytes never extends it
+        client_conn->GetLooper()->SetDeadline(from_fd, limits.header_timeout_);
+      }
+    }
+  }
   if (no_more_parse) {
-    client_conn->GetLooper()->DeleteConnection(from_fd);
+    // the last response might still be flushing out
+    client_conn->GetLooper()->CloseConnection(from_fd);
     // client_conn ptr is invalid below here, do not touch it again
     return;
   }
@@ -108,14 +478,15 @@ int main(int argc, char *argv[]) {
   const std::string usage =
       "Usage: \n"
       "./http_server [optional: port default=20080] [optional: directory "
-      "default=../http_dir/] \n";
-  if (argc > 3) {
+      "default=../http_dir/] [optional: metrics path default=/metrics] \n";
+  if (argc > 4) {
     std::cout << "argument number error\n";
     std::cout << usage;
     exit(EXIT_FAILURE);
   }
   TURTLE_SERVER::NetAddress address("0.0.0.0", 20080);
   std::string directory = "../http_dir/";
+  std::string metrics_path = TURTLE_SERVER::HTTP::DEFAULT_METRICS_PATH;
   if (argc >= 2) {
     auto port = static_cast<uint16_t>(std::strtol(argv[1], nullptr, 10));
     if (port == 0) {
@@ -124,7 +495,7 @@ int main(int argc, char *argv[]) {
       exit(EXIT_FAILURE);
     }
     address = {"0.0.0.0", port};
-    if (argc == 3) {
+    if (argc >= 3) {
       directory = argv[2];
       if (!TURTLE_SERVER::HTTP::IsDirectoryExists(directory)) {
         std::cout << "directory error\n";
@@ -132,12 +503,56 @@ int main(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
       }
     }
+    if (argc == 4) {
+      metrics_path = argv[3];
+      if (metrics_path.empty() || metrics_path[0] != '/') {
+        std::cout << "metrics path error\n";
+        std::cout << usage;
+        exit(EXIT_FAILURE);
+      }
+    }
   }
+  // the CGI workers are forked first, while the process is still small and single-threaded
+  auto cgi_pool = std::make_shared<TURTLE_SERVER::HTTP::CgiWorkerPool>();
+  // then every thread spawned below inherits the blocked SIGCHLD, which is read through a signalfd instead
+  TURTLE_SERVER::HTTP::Cgier::BlockChildSignal();
   TURTLE_SERVER::TurtleServer http_server(address);
-  auto cache = std::make_shared<TURTLE_SERVER::Cache>();
-  http_server
+  auto cache = std::make_shared<TURTLE_SERVER::Cache>(TURTLE_SERVER::DEFAULT_CACHE_CAPACITY,
+                                                      TURTLE_SERVER::NO_EXPIRATION, "file");
+  auto metas = std::make_shared<TURTLE_SERVER::HTTP::FileMetaCache>();
+  auto compressor = std::make_shared<TURTLE_SERVER::HTTP::Compressor>(cache);
+  // the sample CGI programs are pure functions of their arguments, so their route opts in a result cache
+  auto cgi_cache = std::make_shared<TURTLE_SERVER::Cache>(TURTLE_SERVER::HTTP::DEFAULT_CGI_CACHE_CAPACITY,
+                                                          TURTLE_SERVER::HTTP::DEFAULT_CGI_CACHE_TTL, "cgi");
+  // CGI programs under the cgi-bin folder, the metrics at their own path, and static resources for everything else
+  using TURTLE_SERVER::Connection;
+  using TURTLE_SERVER::HTTP::Request;
+  using TURTLE_SERVER::HTTP::RouteParams;
+  TURTLE_SERVER::HTTP::Router router;
+  TURTLE_SERVER::HTTP::RequestLimits limits;
+  TURTLE_SERVER::HTTP::AdmissionLimits admission;
+  // one limiter caps the connections upon accept and rate limits the requests of each client address
+  auto limiter = std::make_shared<TURTLE_SERVER::ClientLimiter>();
+  // a line per request in the combined format, written off the reactors into the rotating TurtleAccess files
+  auto access_log = std::make_shared<TURTLE_SERVER::HTTP::AccessLog>();
+  router
+      .Any(metrics_path,
+           [](const Request &request, const RouteParams &, Connection *client_conn) {
+             return TURTLE_SERVER::HTTP::ServeMetrics(request, client_conn);
+           })
+      .Mount(std::string("/") + TURTLE_SERVER::HTTP::CGI_BIN,
+             [&](const Request &request, const RouteParams &, Connection *client_conn) {
+               return TURTLE_SERVER::HTTP::ServeCgi(directory, cgi_pool.get(), cgi_cache.get(), metas.get(),
+                                                    access_log.get(), request, client_conn);
+             })
+      .Mount("/", [&](const Request &request, const RouteParams &, Connection *client_conn) {
+        return TURTLE_SERVER::HTTP::ServeStatic(directory, cache.get(), metas.get(), compressor.get(), request,
+                                                client_conn);
+      });
+  http_server.WithClientLimiter(limiter)
       .OnHandle([&](TURTLE_SERVER::Connection *client_conn) {
-        TURTLE_SERVER::HTTP::ProcessHttpRequest(directory, cache, client_conn);
+        TURTLE_SERVER::HTTP::ProcessHttpRequest(router, limits, admission, limiter.get(), access_log.get(),
+                                                client_conn);
       })
       .Begin();
   return 0;
@@ -17,73 +17,113 @@
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <utility>
+
+#include "http/lookup_table.h"
 namespace TURTLE_SERVER::HTTP {
 
-auto ToMethod(const std::string &method_str) noexcept -> Method {
-  auto method_str_formatted = Format(method_str);
-  if (method_str_formatted == METHOD_TO_STRING.at(Method::GET)) {
-    return Method::GET;
-  }
-  if (method_str_formatted == METHOD_TO_STRING.at(Method::HEAD)) {
-    return Method::HEAD;
+/* the case insensitive method, version and extension tables, all built at compile time */
+static constexpr PerfectHashTable<Method, 2> METHOD_TABLE{
+    std::array<std::pair<std::string_view, Method>, 2>{{{"GET", Method::GET}, {"HEAD", Method::HEAD}}}};
+static_assert(METHOD_TABLE.IsPerfect());
+
+static constexpr PerfectHashTable<Version, 1> VERSION_TABLE{
+    std::array<std::pair<std::string_view, Version>, 1>{{{"HTTP/1.1", Version::HTTP_1_1}}}};
+static_assert(VERSION_TABLE.IsPerfect());
+
+static constexpr size_t MIME_COUNT = 58;
+static constexpr PerfectHashTable<std::string_view, MIME_COUNT> MIME_TABLE{
+    std::array<std::pair<std::string_view, std::string_view>, MIME_COUNT>{{
+    {"html", "text/html"},
+    {"htm", "text/html"},
+    {"xhtml", "application/xhtml+xml"},
+    {"css", "text/css"},
+    {"js", "text/javascript"},
+    {"mjs", "text/javascript"},
+    {"json", "application/json"},
+    {"jsonld", "application/ld+json"},
+    {"map", "application/json"},
+    {"webmanifest", "application/manifest+json"},
+    {"xml", "application/xml"},
+    {"rss", "application/rss+xml"},
+    {"atom", "application/atom+xml"},
+    {"txt", "text/plain"},
+    {"md", "text/markdown"},
+    {"csv", "text/csv"},
+    {"ics", "text/calendar"},
+    {"png", "image/png"},
+    {"jpg", "image/jpeg"},
+    {"jpeg", "image/jpeg"},
+    {"gif", "image/gif"},
+    {"webp", "image/webp"},
+    {"avif", "image/avif"},
+    {"svg", "image/svg+xml"},
+    {"ico", "image/x-icon"},
+    {"bmp", "image/bmp"},
+    {"tif", "image/tiff"},
+    {"tiff", "image/tiff"},
+    {"woff", "font/woff"},
+    {"woff2", "font/woff2"},
+    {"ttf", "font/ttf"},
+    {"otf", "font/otf"},
+    {"eot", "application/vnd.ms-fontobject"},
+    {"wasm", "application/wasm"},
+    {"mp4", "video/mp4"},
+    {"m4v", "video/mp4"},
+    {"webm", "video/webm"},
+    {"ogv", "video/ogg"},
+    {"mov", "video/quicktime"},
+    {"avi", "video/x-msvideo"},
+    {"mpeg", "video/mpeg"},
+    {"mp3", "audio/mpeg"},
+    {"m4a", "audio/mp4"},
+    {"aac", "audio/aac"},
+    {"wav", "audio/wav"},
+    {"ogg", "audio/ogg"},
+    {"oga", "audio/ogg"},
+    {"opus", "audio/opus"},
+    {"flac", "audio/flac"},
+    {"pdf", "application/pdf"},
+    {"zip", "application/zip"},
+    {"gz", "application/gzip"},
+    {"tar", "application/x-tar"},
+    {"bz2", "application/x-bzip2"},
+    {"xz", "application/x-xz"},
+    {"7z", "application/x-7z-compressed"},
+    {"rar", "application/vnd.rar"},
+    {"bin", "application/octet-stream"},
+    }}};
+static_assert(MIME_TABLE.IsPerfect());
+
+/* remove the leading and trailing spaces without a copy */
+static auto TrimView(std::string_view str) noexcept -> std::string_view {
+  auto first = str.find_first_not_of(SPACE);
+  if (first == std::string_view::npos) {
+    return {};
   }
-  return Method::UNSUPPORTED;
+  auto last = str.find_last_not_of(SPACE);
+  return str.substr(first, last - first + 1);
 }
 
-auto ToVersion(const std::string &version_str) noexcept -> Version {
-  auto version_str_formatted = Format(version_str);
-  if (version_str_formatted == VERSION_TO_STRING.at(Version::HTTP_1_1)) {
-    return Version::HTTP_1_1;
-  }
-  return Version::UNSUPPORTED;
+auto ToMethod(std::string_view method_str) noexcept -> Method {
+  return METHOD_TABLE.Find(TrimView(method_str)).value_or(Method::UNSUPPORTED);
 }
 
-auto ToExtension(const std::string &extension_str) noexcept -> Extension {
-  auto extension_str_formatted = Format(extension_str);
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::HTML)) {
-    return Extension::HTML;
-  }
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::CSS)) {
-    return Extension::CSS;
-  }
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::PNG)) {
-    return Extension::PNG;
-  }
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::JPG)) {
-    return Extension::JPG;
-  }
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::JPEG)) {
-    return Extension::JPEG;
-  }
-  if (extension_str_formatted == EXTENSION_TO_STRING.at(Extension::GIF)) {
-    return Extension::GIF;
-  }
-  return Extension::OCTET;
+auto ToVersion(std::string_view version_str) noexcept -> Version {
+  return VERSION_TABLE.Find(TrimView(version_str)).value_or(Version::UNSUPPORTED);
 }
 
-auto ExtensionToMime(const Extension &extension) noexcept -> std::string {
-  if (extension == Extension::HTML) {
-    return MIME_HTML;
-  }
-  if (extension == Extension::CSS) {
-    return MIME_CSS;
-  }
-  if (extension == Extension::PNG) {
-    return MIME_PNG;
-  }
-  if (extension == Extension::JPG) {
-    return MIME_JPG;
-  }
-  if (extension == Extension::JPEG) {
-    return MIME_JPEG;
-  }
-  if (extension == Extension::GIF) {
-    return MIME_GIF;
-  }
-  if (extension == Extension::OCTET) {
+auto ExtensionToMime(std::string_view extension) noexcept -> std::string_view {
+  return MIME_TABLE.Find(TrimView(extension)).value_or(MIME_OCTET);
+}
+
+auto ToMime(std::string_view resource_url) noexcept -> std::string_view {
+  auto last_dot = resource_url.find_last_of(DOT);
+  // a dot in the directory part is not an extension
+  if (last_dot == std::string_view::npos || resource_url.find('/', last_dot) != std::string_view::npos) {
     return MIME_OCTET;
   }
-  return MIME_OCTET;
+  return ExtensionToMime(resource_url.substr(last_dot + 1));
 }
 
 auto Split(const std::string &str, const char *delim) noexcept -> std::vector<std::string> {
@@ -154,6 +194,38 @@ auto CheckFileSize(const std::string &file_path) noexcept -> size_t {
   return std::filesystem::file_size(file_path);
 }
 
+auto ToHttpDate(time_t timestamp) noexcept -> std::string {
+  struct tm gmt {};
+  gmtime_r(&timestamp, &gmt);
+  char date[HTTP_DATE_LEN + 1];
+  size_t len = strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+  return {date, len};
+}
+
+auto CurrentHttpDate() noexcept -> std::string_view {
+  // each Looper runs on its own thread, so a thread local copy needs no lock
+  thread_local char date[HTTP_DATE_LEN + 1];
+  thread_local size_t len = 0;
+  thread_local time_t formatted_at = -1;
+  time_t now = time(nullptr);
+  if (now != formatted_at) {
+    struct tm gmt {};
+    gmtime_r(&now, &gmt);
+    len = strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+    formatted_at = now;
+  }
+  return {date, len};
+}
+
+auto ParseHttpDate(const std::string &http_date) noexcept -> std::optional<time_t> {
+  struct tm gmt {};
+  const char *end = strptime(http_date.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &gmt);
+  if (end == nullptr || *end != '\0') {
+    return std::nullopt;
+  }
+  return timegm(&gmt);
+}
+
 void LoadFile(const std::string &file_path,
               std::vector<unsigned char> &buffer) noexcept {  // NOLINT
   size_t file_size = CheckFileSize(file_path);
@@ -0,0 +1,143 @@
+/**
+ * @file range.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the HTTP byte Range, which parses
+ * the 'Range' request header into a set of byte slices of the requested resource
+ */
+
+#include "http/range.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <utility>
+
+#include "http/http_utils.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* parse a non-empty all-digits string, fail on anything else including overflow */
+static auto ParsePosition(const std::string &str, size_t &position) noexcept -> bool {  // NOLINT
+  if (str.empty()) {
+    return false;
+  }
+  size_t value = 0;
+  for (char c : str) {
+    if (std::isdigit(static_cast<unsigned char>(c)) == 0) {
+      return false;
+    }
+    size_t digit = c - '0';
+    if (value > (SIZE_MAX - digit) / 10) {
+      return false;
+    }
+    value = value * 10 + digit;
+  }
+  position = value;
+  return true;
+}
+
+auto Range::ParseRange(const std::string &range_header, size_t resource_size) -> Range {
+  const Range ignored{RangeStatus::IGNORED, resource_size, {}};
+  auto equal_pos = range_header.find('=');
+  if (equal_pos == std::string::npos || Format(range_header.substr(0, equal_pos)) != Format(RANGE_UNIT_BYTES)) {
+    return ignored;
+  }
+  auto specs = Split(range_header.substr(equal_pos + 1), ",");
+  if (specs.empty() || specs.size() > MAX_RANGE_SLICES) {
+    return ignored;
+  }
+  std::vector<ByteRange> slices;
+  for (const auto &raw_spec : specs) {
+    auto spec = Trim(raw_spec);
+    auto dash_pos = spec.find('-');
+    if (dash_pos == std::string::npos) {
+      return ignored;
+    }
+    auto first_str = spec.substr(0, dash_pos);
+    auto last_str = spec.substr(dash_pos + 1);
+    size_t first = 0;
+    size_t last = 0;
+    if (first_str.empty()) {
+      // suffix form "-N": the final N bytes
+      if (!ParsePosition(last_str, last)) {
+        return ignored;
+      }
+      if (last == 0 || resource_size == 0) {
+        continue;
+      }
+      slices.push_back({resource_size - std::min(last, resource_size), resource_size - 1});
+      continue;
+    }
+    if (!ParsePosition(first_str, first)) {
+      return ignored;
+    }
+    if (last_str.empty()) {
+      // open form "N-": from N till the end
+      last = SIZE_MAX;
+    } else if (!ParsePosition(last_str, last) || last < first) {
+      return ignored;
+    }
+    if (first >= resource_size) {
+      continue;
+    }
+    slices.push_back({first, std::min(last, resource_size - 1)});
+  }
+  if (slices.empty()) {
+    return {RangeStatus::UNSATISFIABLE, resource_size, {}};
+  }
+  // coalesce overlapping or adjacent slices so each byte is sent at most once
+  std::sort(slices.begin(), slices.end(), [](const auto &lhs, const auto &rhs) { return lhs.first_ < rhs.first_; });
+  std::vector<ByteRange> coalesced{slices.front()};
+  for (size_t i = 1; i < slices.size(); i++) {
+    auto &tail = coalesced.back();
+    if (slices[i].first_ <= tail.last_ + 1) {
+      tail.last_ = std::max(tail.last_, slices[i].last_);
+    } else {
+      coalesced.push_back(slices[i]);
+    }
+  }
+  return {RangeStatus::SATISFIABLE, resource_size, std::move(coalesced)};
+}
+
+Range::Range(RangeStatus status, size_t resource_size, std::vector<ByteRange> slices) noexcept
+    : status_(status), resource_size_(resource_size), slices_(std::move(slices)) {}
+
+auto Range::GetStatus() const noexcept -> RangeStatus { return status_; }
+
+auto Range::GetSlices() const noexcept -> const std::vector<ByteRange> & { return slices_; }
+
+auto Range::IsMultipart() const noexcept -> bool { return slices_.size() > 1; }
+
+auto Range::ContentRange(const ByteRange &slice) const -> std::string {
+  return std::string(RANGE_UNIT_BYTES) + SPACE + std::to_string(slice.first_) + "-" + std::to_string(slice.last_) +
+         "/" + std::to_string(resource_size_);
+}
+
+auto Range::UnsatisfiedContentRange() const -> std::string {
+  return std::string(RANGE_UNIT_BYTES) + SPACE + "*/" + std::to_string(resource_size_);
+}
+
+auto Range::PartHeader(size_t index, std::string_view mime) const -> std::string {
+  std::string part_header = (index == 0) ? std::string() : std::string(CRLF);
+  part_header += std::string("--") + MULTIPART_BOUNDARY + CRLF;
+  part_header.append(HEADER_CONTENT_TYPE).append(COLON).append(SPACE).append(mime).append(CRLF);
+  part_header += std::string(HEADER_CONTENT_RANGE) + COLON + SPACE + ContentRange(slices_[index]) + CRLF;
+  part_header += CRLF;
+  return part_header;
+}
+
+auto Range::PartTrailer() const -> std::string { return std::string(CRLF) + "--" + MULTIPART_BOUNDARY + "--" + CRLF; }
+
+auto Range::MultipartLength(std::string_view mime) const -> size_t {
+  size_t length = PartTrailer().size();
+  for (size_t i = 0; i < slices_.size(); i++) {
+    length += PartHeader(i, mime).size() + slices_[i].Length();
+  }
+  return length;
+}
+
+}  // namespace TURTLE_SERVER::HTTP
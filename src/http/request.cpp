@@ -10,41 +10,89 @@
 #include "http/request.h"
 
 #include <algorithm>
+#include <cstring>
+#include <utility>
 
 #include "http/header.h"
 #include "http/http_utils.h"
+#include "http/lookup_table.h"
 namespace TURTLE_SERVER::HTTP {
 
+/* remove the leading and trailing spaces and tabs without a copy */
+static auto TrimWhitespace(std::string_view str) noexcept -> std::string_view {
+  auto first = str.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+}
+
+auto CheckRequestLimits(std::string_view head, const RequestLimits &limits) noexcept -> std::optional<Status> {
+  static constexpr std::string_view REQUEST_END{"\r\n\r\n"};
+  auto line_end = head.find(CRLF);
+  if ((line_end == std::string_view::npos ? head.size() : line_end) > limits.max_request_line_) {
+    return Status::URI_TOO_LONG;
+  }
+  if (head.size() > limits.max_header_bytes_) {
+    return Status::REQUEST_HEADER_FIELDS_TOO_LARGE;
+  }
+  // every header line ends with CRLF, except for the request line and the empty line ending a complete head
+  size_t line_count = 0;
+  for (auto pos = head.find(CRLF); pos != std::string_view::npos; pos = head.find(CRLF, pos + strlen(CRLF))) {
+    line_count++;
+  }
+  bool complete = head.size() >= REQUEST_END.size() && head.substr(head.size() - REQUEST_END.size()) == REQUEST_END;
+  size_t header_count = line_count - std::min(line_count, complete ? size_t{2} : size_t{1});
+  if (header_count > limits.max_header_count_) {
+    return Status::REQUEST_HEADER_FIELDS_TOO_LARGE;
+  }
+  return std::nullopt;
+}
+
 Request::Request(Method method, Version version, std::string resource_url, const std::vector<Header> &headers) noexcept
-    : method_(method), version_(version), resource_url_(std::move(resource_url)), headers_(headers), is_valid_(true) {}
+    : method_(method), version_(version), resource_url_(std::move(resource_url)), is_valid_(true) {
+  // keep the headers in raw form so that the views have somewhere to point to
+  for (const auto &header : headers) {
+    raw_ += header.Serialize();
+  }
+  std::string_view rest{raw_};
+  while (!rest.empty()) {
+    auto line = rest.substr(0, rest.find(CRLF));
+    rest.remove_prefix(std::min(rest.size(), line.size() + strlen(CRLF)));
+    auto colon = line.find(COLON);
+    headers_.Add(TrimWhitespace(line.substr(0, colon)), TrimWhitespace(line.substr(colon + 1)));
+  }
+  ScanHeaders();
+}
 
-Request::Request(const std::string &request_str) noexcept {
-  auto lines = Split(request_str, CRLF);
-  if (lines.size() < 2 || !lines.back().empty()) {
+Request::Request(std::string request_str) noexcept : raw_(std::move(request_str)) { Parse(); }
+
+void Request::Parse() noexcept {
+  /* the ending of a request should be '\r\n\r\n' */
+  static constexpr std::string_view REQUEST_END{"\r\n\r\n"};
+  std::string_view rest{raw_};
+  if (rest.size() < REQUEST_END.size() || rest.substr(rest.size() - REQUEST_END.size()) != REQUEST_END) {
     invalid_reason_ = "Request format is wrong.";
     return;
   }
-  /* the ending of a request should be '\r\n\r\n'
-   * which is split to empty string in the last token */
-  if (!lines.back().empty()) {
-    invalid_reason_ = "Ending of the request is not \r\n\r\n";
-    return;
-  }
-  lines.pop_back();
-  bool request_line_parse_success = ParseRequestLine(lines[0]);
-  if (!request_line_parse_success) {
+  // drop one CRLF of the ending so that every line ends with CRLF
+  rest.remove_suffix(strlen(CRLF));
+  auto request_line = rest.substr(0, rest.find(CRLF));
+  rest.remove_prefix(request_line.size() + strlen(CRLF));
+  if (!ParseRequestLine(request_line)) {
     return;
   }
-  lines.erase(lines.begin());
-  for (const auto &line : lines) {
-    Header header{line};
-    if (!header.IsValid()) {
-      invalid_reason_ = "Fail to parse header line: " + line;
+  while (!rest.empty()) {
+    auto line = rest.substr(0, rest.find(CRLF));
+    rest.remove_prefix(line.size() + strlen(CRLF));
+    auto colon = line.find(COLON);
+    if (colon == std::string_view::npos) {
+      invalid_reason_ = "Fail to parse header line: " + std::string(line);
       return;
     }
-    ScanHeader(header);
-    headers_.push_back(std::move(header));
+    headers_.Add(TrimWhitespace(line.substr(0, colon)), TrimWhitespace(line.substr(colon + 1)));
   }
+  ScanHeaders();
   is_valid_ = true;
 }
 
@@ -56,43 +104,63 @@ auto Request::GetMethod() const noexcept -> Method { return method_; }
 
 auto Request::GetVersion() const noexcept -> Version { return version_; }
 
-auto Request::GetResourceUrl() const noexcept -> std::string { return resource_url_; }
+auto Request::GetResourceUrl() const noexcept -> const std::string & { return resource_url_; }
+
+auto Request::GetHeaders() const noexcept -> std::vector<Header> {
+  std::vector<Header> headers;
+  headers.reserve(headers_.Size());
+  for (size_t i = 0; i < headers_.Size(); i++) {
+    const auto &entry = headers_.At(i);
+    headers.emplace_back(std::string(entry.name_), std::string(entry.value_));
+  }
+  return headers;
+}
 
-auto Request::GetHeaders() const noexcept -> std::vector<Header> { return headers_; }
+auto Request::GetHeaderMap() const noexcept -> const HeaderMap & { return headers_; }
+
+auto Request::GetHeader(HeaderId id) const noexcept -> std::optional<std::string_view> { return headers_.Get(id); }
+
+auto Request::GetHeader(std::string_view key) const noexcept -> std::optional<std::string_view> {
+  return headers_.Get(key);
+}
 
 auto Request::GetInvalidReason() const noexcept -> std::string { return invalid_reason_; }
 
-auto Request::ParseRequestLine(const std::string &request_line) -> bool {
-  auto tokens = Split(request_line, SPACE);
-  if (tokens.size() != 3) {
-    invalid_reason_ = "Invalid first request headline: " + request_line;
+auto Request::ParseRequestLine(std::string_view request_line) -> bool {
+  // exactly three tokens separated by single spaces
+  auto first_space = request_line.find(SPACE);
+  auto second_space = (first_space == std::string_view::npos) ? first_space : request_line.find(SPACE, first_space + 1);
+  if (second_space == std::string_view::npos || request_line.find(SPACE, second_space + 1) != std::string_view::npos) {
+    invalid_reason_ = "Invalid first request headline: " + std::string(request_line);
     return false;
   }
-  method_ = ToMethod(tokens[0]);
+  auto method = request_line.substr(0, first_space);
+  auto url = request_line.substr(first_space + 1, second_space - first_space - 1);
+  auto version = request_line.substr(second_space + 1);
+  method_ = ToMethod(method);
   if (method_ == Method::UNSUPPORTED) {
-    invalid_reason_ = "Unsupported method: " + tokens[0];
+    invalid_reason_ = "Unsupported method: " + std::string(method);
     return false;
   }
-  version_ = ToVersion(tokens[2]);
+  version_ = ToVersion(version);
   if (version_ == Version::UNSUPPORTED) {
-    invalid_reason_ = "Unsupported version: " + tokens[2];
+    invalid_reason_ = "Unsupported version: " + std::string(version);
     return false;
   }
   // default route to index.html
-  resource_url_ =
-      (tokens[1].empty() || tokens[1].at(tokens[1].size() - 1) == '/') ? tokens[1] + DEFAULT_ROUTE : tokens[1];
+  resource_url_ = url;
+  if (url.empty() || url.back() == '/') {
+    resource_url_ += DEFAULT_ROUTE;
+  }
   return true;
 }
 
-void Request::ScanHeader(const Header &header) {
+void Request::ScanHeaders() {
   /* currently only scan for whether the connection should be closed after
    * service */
-  auto key = Format(header.GetKey());
-  if (key == Format(HEADER_CONNECTION)) {
-    auto value = Format(header.GetValue());
-    if (value == Format(CONNECTION_KEEP_ALIVE)) {
-      should_close_ = false;
-    }
+  auto connection = headers_.Get(HeaderId::CONNECTION);
+  if (connection.has_value() && CaseInsensitiveEqual(connection.value(), CONNECTION_KEEP_ALIVE)) {
+    should_close_ = false;
   }
 }
 
@@ -10,71 +10,208 @@
 
 #include "http/response.h"
 
-#include <sstream>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
 #include <utility>
 
+#include "core/buffer.h"
+#include "core/connection.h"
 #include "http/header.h"
-#include "http/http_utils.h"
+
 namespace TURTLE_SERVER::HTTP {
 
+/* the headers every response carries, pre-formatted */
+static constexpr std::string_view SERVER_LINE = JOINED_LITERAL<HEADER_SERVER, COLON, SPACE, SERVER_TURTLE, CRLF>;
+static constexpr std::string_view CONNECTION_CLOSE_LINE =
+    JOINED_LITERAL<HEADER_CONNECTION, COLON, SPACE, CONNECTION_CLOSE, CRLF>;
+static constexpr std::string_view CONNECTION_KEEP_ALIVE_LINE =
+    JOINED_LITERAL<HEADER_CONNECTION, COLON, SPACE, CONNECTION_KEEP_ALIVE, CRLF>;
+static constexpr std::string_view ACCEPT_RANGES_LINE =
+    JOINED_LITERAL<HEADER_ACCEPT_RANGES, COLON, SPACE, RANGE_UNIT_BYTES, CRLF>;
+static constexpr std::string_view DATE_PREFIX{"Date: "};
+static constexpr std::string_view CONTENT_LENGTH_PREFIX = JOINED_LITERAL<HEADER_CONTENT_LENGTH, COLON, SPACE>;
+static constexpr std::string_view CONTENT_TYPE_PREFIX = JOINED_LITERAL<HEADER_CONTENT_TYPE, COLON, SPACE>;
+static constexpr std::string_view HEADER_SEPARATOR{": "};
+static constexpr std::string_view LINE_END{CRLF};
+
+/* enough for the decimal of a 64-bit number */
+static constexpr size_t SIZE_MAX_DIGITS = 20;
+
+/* parse the "key: value" header lines back, skipping anything else */
+static auto ParseHeaderLines(const std::string &lines) -> std::vector<Header> {
+  std::vector<Header> headers;
+  for (const auto &line : Split(lines, CRLF)) {
+    auto separator = line.find(HEADER_SEPARATOR);
+    if (separator != std::string::npos) {
+      headers.emplace_back(line.substr(0, separator), line.substr(separator + HEADER_SEPARATOR.size()));
+    }
+  }
+  return headers;
+}
+
 auto Response::Make200Response(bool should_close, std::optional<std::string> resource_url) -> Response {
-  return {RESPONSE_OK, should_close, std::move(resource_url)};
+  return {Status::OK, should_close, std::move(resource_url)};
+}
+
+auto Response::Make304Response(bool should_close) noexcept -> Response {
+  Response response{Status::NOT_MODIFIED, should_close, std::nullopt};
+  response.content_length_ = std::nullopt;
+  return response;
 }
 
-auto Response::Make400Response() noexcept -> Response { return {RESPONSE_BAD_REQUEST, true, std::nullopt}; }
+auto Response::Make400Response() noexcept -> Response { return {Status::BAD_REQUEST, true, std::nullopt}; }
 
-auto Response::Make404Response() noexcept -> Response { return {RESPONSE_NOT_FOUND, true, std::nullopt}; }
+auto Response::Make404Response() noexcept -> Response { return {Status::NOT_FOUND, true, std::nullopt}; }
 
-auto Response::Make503Response() noexcept -> Response { return {RESPONSE_SERVICE_UNAVAILABLE, true, std::nullopt}; }
+auto Response::Make414Response() noexcept -> Response { return {Status::URI_TOO_LONG, true, std::nullopt}; }
+
+auto Response::Make416Response(bool should_close, const std::string &content_range) -> Response {
+  Response response{Status::RANGE_NOT_SATISFIABLE, should_close, std::nullopt};
+  response.AddHeader(HEADER_CONTENT_RANGE, content_range);
+  return response;
+}
 
-Response::Response(const std::string &status_code, bool should_close, std::optional<std::string> resource_url)
-    : should_close_(should_close), resource_url_(std::move(resource_url)) {
-  // construct the status line
-  std::stringstream str_stream;
-  str_stream << HTTP_VERSION_TURTLE << SPACE << status_code;
-  status_line_ = str_stream.str();
-  // add necessary headers
-  headers_.emplace_back(HEADER_SERVER, SERVER_TURTLE);
-  headers_.emplace_back(HEADER_CONNECTION, ((should_close_) ? CONNECTION_CLOSE : CONNECTION_KEEP_ALIVE));
+auto Response::Make429Response(uint64_t retry_after) -> Response {
+  Response response{Status::TOO_MANY_REQUESTS, true, std::nullopt};
+  response.AddHeader(HEADER_RETRY_AFTER, std::to_string(retry_after));
+  return response;
+}
+
+auto Response::Make431Response() noexcept -> Response {
+  return {Status::REQUEST_HEADER_FIELDS_TOO_LARGE, true, std::nullopt};
+}
+
+auto Response::Make503Response() noexcept -> Response { return {Status::SERVICE_UNAVAILABLE, true, std::nullopt}; }
+
+auto Response::Make503Response(uint64_t retry_after) -> Response {
+  Response response{Status::SERVICE_UNAVAILABLE, true, std::nullopt};
+  response.AddHeader(HEADER_RETRY_AFTER, std::to_string(retry_after));
+  return response;
+}
+
+Response::Response(Status status, bool should_close, std::optional<std::string> resource_url)
+    : status_(status), should_close_(should_close) {
   // if resource is specified and available
-  if (resource_url_.has_value() && IsFileExists(resource_url_.value())) {
-    size_t content_length = CheckFileSize(resource_url_.value());
-    headers_.emplace_back(HEADER_CONTENT_LENGTH, std::to_string(content_length));
-    // parse out the extension
-    auto last_dot = resource_url_.value().find_last_of(DOT);
-    if (last_dot != std::string::npos) {
-      auto extension_raw_str = resource_url_.value().substr(last_dot + 1);
-      auto extension = ToExtension(extension_raw_str);
-      headers_.emplace_back(HEADER_CONTENT_TYPE, ExtensionToMime(extension));
+  if (resource_url.has_value() && IsFileExists(resource_url.value())) {
+    content_length_ = CheckFileSize(resource_url.value());
+    accept_ranges_ = true;
+    if (resource_url.value().find_last_of(DOT) != std::string::npos) {
+      content_type_ = ToMime(resource_url.value());
     }
-  } else {
-    resource_url_ = std::nullopt;
-    headers_.emplace_back(HEADER_CONTENT_LENGTH, CONTENT_LENGTH_ZERO);
   }
 }
 
-void Response::Serialize(std::vector<unsigned char> &buffer) {  // NOLINT
-  // construct everything before body
-  std::stringstream str_stream;
-  str_stream << status_line_ << CRLF;
-  for (const auto &header : headers_) {
-    str_stream << header.Serialize();
+Response::Response(Status status, bool should_close, std::string_view mime, size_t size)
+    : status_(status), should_close_(should_close), accept_ranges_(true), content_length_(size), content_type_(mime) {}
+
+template <typename Sink>
+void Response::Emit(Sink &&sink) const {
+  sink(STATUS_LINE[static_cast<size_t>(status_)]);
+  sink(SERVER_LINE);
+  sink(DATE_PREFIX);
+  sink(CurrentHttpDate());
+  sink(LINE_END);
+  sink(should_close_ ? CONNECTION_CLOSE_LINE : CONNECTION_KEEP_ALIVE_LINE);
+  if (content_length_.has_value()) {
+    char digits[SIZE_MAX_DIGITS];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), content_length_.value());
+    sink(CONTENT_LENGTH_PREFIX);
+    sink(std::string_view(digits, end - digits));
+    sink(LINE_END);
+  }
+  if (accept_ranges_) {
+    sink(ACCEPT_RANGES_LINE);
+  }
+  if (!content_type_.empty()) {
+    sink(CONTENT_TYPE_PREFIX);
+    sink(content_type_);
+    sink(LINE_END);
   }
-  str_stream << CRLF;
-  std::string response_head = str_stream.str();
-  buffer.insert(buffer.end(), response_head.begin(), response_head.end());
+  auto [inline_headers, spilled_headers] = ExtraHeaders();
+  sink(inline_headers);
+  sink(spilled_headers);
+  sink(LINE_END);
 }
 
-auto Response::GetHeaders() -> std::vector<Header> { return headers_; }
+void Response::Serialize(std::vector<unsigned char> &buffer) const {  // NOLINT
+  Emit([&buffer](std::string_view fragment) { buffer.insert(buffer.end(), fragment.begin(), fragment.end()); });
+}
+
+void Response::Serialize(Buffer &buffer) const {  // NOLINT
+  Emit([&buffer](std::string_view fragment) { buffer.Append(fragment); });
+}
 
-auto Response::ChangeHeader(const std::string &key, const std::string &new_value) noexcept -> bool {
-  for (auto &it : headers_) {
-    if (it.GetKey() == key) {
-      it.SetValue(new_value);
-      return true;
+void Response::Serialize(Connection *client_conn) const {
+  client_conn->SetResponseStatus(static_cast<int>(status_));
+  Serialize(*client_conn->GetWriteBuffer());
+}
+
+auto Response::GetHeaders() const -> std::vector<Header> {
+  std::vector<unsigned char> serialized;
+  Serialize(serialized);
+  // the status line has no ": " separator and is skipped
+  return ParseHeaderLines(std::string(serialized.begin(), serialized.end()));
+}
+
+void Response::SetContentLength(size_t content_length) noexcept { content_length_ = content_length; }
+
+void Response::SetContentType(std::string_view content_type) noexcept { content_type_ = content_type; }
+
+void Response::AddHeader(std::string_view key, std::string_view value) {
+  size_t line_len = key.size() + HEADER_SEPARATOR.size() + value.size() + LINE_END.size();
+  if (extra_headers_spill_.empty() && extra_headers_len_ + line_len <= extra_headers_.size()) {
+    char *dst = extra_headers_.data() + extra_headers_len_;
+    for (auto fragment : {key, HEADER_SEPARATOR, value, LINE_END}) {
+      memcpy(dst, fragment.data(), fragment.size());
+      dst += fragment.size();
     }
+    extra_headers_len_ += line_len;
+    return;
   }
-  return false;
+  // out of inline space, keep the rest on heap in order
+  extra_headers_spill_.append(key).append(HEADER_SEPARATOR).append(value).append(LINE_END);
+}
+
+auto Response::ChangeHeader(const std::string &key, const std::string &new_value) -> bool {
+  if (key == HEADER_CONTENT_LENGTH) {
+    if (!content_length_.has_value()) {
+      return false;
+    }
+    content_length_ = std::strtoull(new_value.c_str(), nullptr, 10);
+    return true;
+  }
+  if (key == HEADER_CONTENT_TYPE) {
+    if (content_type_.empty()) {
+      return false;
+    }
+    // an arbitrary value has no static storage to refer to, thus kept among the less common headers
+    content_type_ = {};
+    AddHeader(HEADER_CONTENT_TYPE, new_value);
+    return true;
+  }
+  // the less common headers are rarely changed, simply rebuild them
+  auto [inline_headers, spilled_headers] = ExtraHeaders();
+  auto extra_headers = ParseHeaderLines(std::string(inline_headers) + std::string(spilled_headers));
+  bool changed = false;
+  for (auto &header : extra_headers) {
+    if (!changed && header.GetKey() == key) {
+      header.SetValue(new_value);
+      changed = true;
+    }
+  }
+  if (changed) {
+    extra_headers_len_ = 0;
+    extra_headers_spill_.clear();
+    for (const auto &header : extra_headers) {
+      AddHeader(header.GetKey(), header.GetValue());
+    }
+  }
+  return changed;
+}
+
+auto Response::ExtraHeaders() const noexcept -> std::pair<std::string_view, std::string_view> {
+  return {std::string_view(extra_headers_.data(), extra_headers_len_), extra_headers_spill_};
 }
 
 }  // namespace TURTLE_SERVER::HTTP
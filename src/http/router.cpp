@@ -0,0 +1,204 @@
+/**
+ * @file router.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the Router that dispatches a
+ * request to its handler by the method and the resource url path
+ */
+
+#include "http/router.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "core/connection.h"
+#include "http/request.h"
+#include "http/response.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+static constexpr char PARAM_MARK = ':';
+static constexpr char WILDCARD_MARK = '*';
+static constexpr char PATH_SEPARATOR = '/';
+static constexpr char QUERY_MARK = '?';
+
+/**
+ * A node of the radix trie
+ * the static children are keyed by distinct first bytes of their prefix
+ * a parameter or wildcard child is named and has an empty prefix
+ */
+struct Router::Node {
+  std::string prefix_;
+  std::string name_;
+  std::vector<std::unique_ptr<Node>> children_;
+  std::unique_ptr<Node> param_child_;
+  std::unique_ptr<Node> wildcard_child_;
+  std::array<RouteHandler, METHOD_COUNT> handlers_;
+};
+
+auto RouteParams::Get(std::string_view name) const noexcept -> std::optional<std::string_view> {
+  for (size_t i = 0; i < size_; i++) {
+    if (params_[i].first == name) {
+      return params_[i].second;
+    }
+  }
+  return std::nullopt;
+}
+
+auto RouteParams::Size() const noexcept -> size_t { return size_; }
+
+void RouteParams::Push(std::string_view name, std::string_view value) noexcept {
+  // the pattern is verified at registration to have no more than the capacity
+  params_[size_++] = {name, value};
+}
+
+void RouteParams::Pop() noexcept { size_--; }
+
+Router::Router() : root_(std::make_unique<Node>()) {}
+
+Router::~Router() = default;
+
+auto Router::Get(const std::string &pattern, RouteHandler handler) -> Router & {
+  return Handle(Method::GET, pattern, std::move(handler));
+}
+
+auto Router::Head(const std::string &pattern, RouteHandler handler) -> Router & {
+  return Handle(Method::HEAD, pattern, std::move(handler));
+}
+
+auto Router::Any(const std::string &pattern, RouteHandler handler) -> Router & {
+  Handle(Method::GET, pattern, handler);
+  return Handle(Method::HEAD, pattern, std::move(handler));
+}
+
+auto Router::Mount(const std::string &prefix, RouteHandler handler) -> Router & {
+  auto pattern = prefix;
+  if (pattern.empty() || pattern.back() != PATH_SEPARATOR) {
+    pattern += PATH_SEPARATOR;
+  }
+  return Any(pattern + WILDCARD_MARK + MOUNT_PARAM, std::move(handler));
+}
+
+auto Router::Handle(Method method, const std::string &pattern, RouteHandler handler) -> Router & {
+  if (method == Method::UNSUPPORTED || pattern.empty() || pattern[0] != PATH_SEPARATOR) {
+    throw std::logic_error("Router: invalid route " + pattern);
+  }
+  Node *node = root_.get();
+  std::string_view rest{pattern};
+  size_t param_count = 0;
+  while (!rest.empty()) {
+    if (rest[0] == PARAM_MARK || rest[0] == WILDCARD_MARK) {
+      // a named parameter, the wildcard must be the last piece
+      bool wildcard = rest[0] == WILDCARD_MARK;
+      auto name_end = wildcard ? rest.size() : std::min(rest.find(PATH_SEPARATOR), rest.size());
+      auto name = rest.substr(1, name_end - 1);
+      if (name.empty() || name.find(PATH_SEPARATOR) != std::string_view::npos || ++param_count > MAX_ROUTE_PARAMS) {
+        throw std::logic_error("Router: invalid parameter in route " + pattern);
+      }
+      auto &child = wildcard ? node->wildcard_child_ : node->param_child_;
+      if (child == nullptr) {
+        child = std::make_unique<Node>();
+        child->name_ = name;
+      } else if (child->name_ != name) {
+        throw std::logic_error("Router: conflicting parameter name in route " + pattern);
+      }
+      node = child.get();
+      rest.remove_prefix(name_end);
+      continue;
+    }
+    // static text till the next parameter
+    auto label = rest.substr(0, std::min(rest.find_first_of(":*"), rest.size()));
+    auto iter = std::find_if(node->children_.begin(), node->children_.end(),
+                             [&](const auto &child) { return child->prefix_[0] == label[0]; });
+    if (iter == node->children_.end()) {
+      node->children_.push_back(std::make_unique<Node>());
+      node = node->children_.back().get();
+      node->prefix_ = label;
+      rest.remove_prefix(label.size());
+      continue;
+    }
+    Node *next = iter->get();
+    size_t common = 0;
+    while (common < label.size() && common < next->prefix_.size() && label[common] == next->prefix_[common]) {
+      common++;
+    }
+    if (common < next->prefix_.size()) {
+      // split the edge, the existing node keeps the shared head and the tail moves one level down
+      auto tail = std::make_unique<Node>();
+      tail->prefix_ = next->prefix_.substr(common);
+      tail->children_ = std::move(next->children_);
+      tail->param_child_ = std::move(next->param_child_);
+      tail->wildcard_child_ = std::move(next->wildcard_child_);
+      tail->handlers_ = std::move(next->handlers_);
+      next->prefix_.resize(common);
+      next->children_.clear();
+      next->children_.push_back(std::move(tail));
+      next->handlers_ = {};
+    }
+    node = next;
+    rest.remove_prefix(common);
+  }
+  auto &slot = node->handlers_[static_cast<size_t>(method)];
+  if (slot) {
+    throw std::logic_error("Router: duplicate route " + pattern);
+  }
+  slot = std::move(handler);
+  return *this;
+}
+
+auto Router::MatchNode(const Node *node, std::string_view path, size_t method, RouteParams &params) noexcept
+    -> const RouteHandler * {
+  if (path.empty() && node->handlers_[method]) {
+    return &node->handlers_[method];
+  }
+  if (!path.empty()) {
+    for (const auto &child : node->children_) {
+      if (child->prefix_[0] == path[0]) {
+        if (path.compare(0, child->prefix_.size(), child->prefix_) == 0) {
+          auto handler = MatchNode(child.get(), path.substr(child->prefix_.size()), method, params);
+          if (handler != nullptr) {
+            return handler;
+          }
+        }
+        break;
+      }
+    }
+    auto segment_end = std::min(path.find(PATH_SEPARATOR), path.size());
+    if (node->param_child_ != nullptr && segment_end > 0) {
+      params.Push(node->param_child_->name_, path.substr(0, segment_end));
+      auto handler = MatchNode(node->param_child_.get(), path.substr(segment_end), method, params);
+      if (handler != nullptr) {
+        return handler;
+      }
+      params.Pop();
+    }
+  }
+  if (node->wildcard_child_ != nullptr && node->wildcard_child_->handlers_[method]) {
+    params.Push(node->wildcard_child_->name_, path);
+    return &node->wildcard_child_->handlers_[method];
+  }
+  return nullptr;
+}
+
+auto Router::Match(Method method, std::string_view path, RouteParams &params) const noexcept -> const RouteHandler * {
+  if (method == Method::UNSUPPORTED) {
+    return nullptr;
+  }
+  path = path.substr(0, std::min(path.find(QUERY_MARK), path.size()));
+  return MatchNode(root_.get(), path, static_cast<size_t>(method), params);
+}
+
+auto Router::Dispatch(const Request &request, Connection *client_conn) const -> bool {
+  RouteParams params;
+  const auto *handler = Match(request.GetMethod(), request.GetResourceUrl(), params);
+  if (handler == nullptr) {
+    Response::Make404Response().Serialize(client_conn);
+    return true;
+  }
+  return (*handler)(request, params, client_conn);
+}
+
+}  // namespace TURTLE_SERVER::HTTP
@@ -11,6 +11,7 @@
 #ifndef SRC_INCLUDE_CORE_ACCEPTOR_H_
 #define SRC_INCLUDE_CORE_ACCEPTOR_H_
 
+#include <chrono>  // NOLINT
 #include <functional>
 #include <memory>
 #include <vector>
@@ -18,9 +19,13 @@
 #include "core/utils.h"
 namespace TURTLE_SERVER {
 
+/* the refusals of over-cap clients are logged at most once per this interval, and counted in a metric */
+static constexpr std::chrono::seconds REFUSAL_LOG_INTERVAL = std::chrono::seconds(1);
+
 class NetAddress;
 class Looper;
 class Connection;
+class ClientLimiter;
 
 /**
  * This Acceptor comes with basic functionality for accepting new client
@@ -49,11 +54,18 @@ class Acceptor {
 
   auto GetAcceptorConnection() noexcept -> Connection *;
 
+  /* cap the connections of each client address upon accept, nullptr to lift the cap */
+  void SetClientLimiter(std::shared_ptr<ClientLimiter> limiter);
+
  private:
   std::vector<Looper *> reactors_;
   std::unique_ptr<Connection> acceptor_conn;
   std::function<void(Connection *)> custom_accept_callback_{};
   std::function<void(Connection *)> custom_handle_callback_{};
+  std::shared_ptr<ClientLimiter> limiter_{nullptr};
+  /* only touched on the listener's thread */
+  std::chrono::steady_clock::time_point last_refusal_log_{};
+  uint64_t refused_unlogged_{0};
 };
 
 }  // namespace TURTLE_SERVER
@@ -0,0 +1,59 @@
+/**
+ * @file alloc_tracker.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the per-thread heap allocation counts,
+ * tracked by the counting operator new and delete when built with ALLOC_TRACKING
+ */
+
+#ifndef SRC_INCLUDE_CORE_ALLOC_TRACKER_H_
+#define SRC_INCLUDE_CORE_ALLOC_TRACKER_H_
+
+#include <cstdint>
+
+namespace TURTLE_SERVER {
+
+#ifdef ALLOC_TRACKING
+static constexpr bool ALLOC_TRACKING_ENABLED = true;
+#else
+static constexpr bool ALLOC_TRACKING_ENABLED = false;
+#endif
+
+/* the heap traffic of a thread, the bytes as requested */
+struct AllocationStats {
+  auto operator-(const AllocationStats &other) const noexcept -> AllocationStats {
+    return {allocations_ - other.allocations_, bytes_ - other.bytes_, deallocations_ - other.deallocations_};
+  }
+
+  uint64_t allocations_{0};
+  uint64_t bytes_{0};
+  uint64_t deallocations_{0};
+};
+
+/* the calling thread's allocations so far, all zero unless tracked */
+auto LocalAllocationStats() noexcept -> AllocationStats;
+
+/**
+ * This AllocationScope snapshots the calling thread's allocations upon construction,
+ * so that the ones made since, e.g. by a callback or a request, could be told apart
+ * i.e. as an allocation budget in a test: CHECK(scope.Get().allocations_ <= 2)
+ * Without ALLOC_TRACKING it is a no-op, and always reads zero
+ */
+class AllocationScope {
+ public:
+  AllocationScope() noexcept : begin_(ALLOC_TRACKING_ENABLED ? LocalAllocationStats() : AllocationStats{}) {}
+
+  auto Get() const noexcept -> AllocationStats {
+    return ALLOC_TRACKING_ENABLED ? LocalAllocationStats() - begin_ : AllocationStats{};
+  }
+
+ private:
+  AllocationStats begin_;
+};
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_CORE_ALLOC_TRACKER_H_
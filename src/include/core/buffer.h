@@ -43,16 +43,19 @@ class Buffer {
 
   void Append(const unsigned char *new_char_data, size_t data_size);
 
-  void Append(const std::string &new_str_data);
+  void Append(std::string_view new_str_data);
 
   void Append(std::vector<unsigned char> &&other_buffer);
 
   void AppendHead(const unsigned char *new_char_data, size_t data_size);
 
-  void AppendHead(const std::string &new_str_data);
+  void AppendHead(std::string_view new_str_data);
 
   auto FindAndPopTill(const std::string &target) -> std::optional<std::string>;
 
+  /* drop the first pop_size bytes, or everything if there are fewer */
+  void PopHead(size_t pop_size) noexcept;
+
   auto Size() const noexcept -> size_t;
 
   auto Capacity() const noexcept -> size_t;
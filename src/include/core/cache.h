@@ -11,12 +11,15 @@
 #ifndef SRC_INCLUDE_CORE_CACHE_H_
 #define SRC_INCLUDE_CORE_CACHE_H_
 
+#include <core/metrics.h>
+#include <core/profiled_mutex.h>
 #include <core/utils.h>
 
 #include <memory>
 #include <mutex>         // NOLINT
 #include <shared_mutex>  // NOLINT
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -25,6 +28,12 @@ namespace TURTLE_SERVER {
 /* default cache size 10 MB */
 static constexpr size_t DEFAULT_CACHE_CAPACITY = 10 * 1024 * 1024;
 
+/* by default a cached resource never expires by age, only by eviction */
+static constexpr uint64_t NO_EXPIRATION = 0;
+
+/* the name labeling the metrics of a cache, unless given one */
+static constexpr std::string_view DEFAULT_CACHE_NAME = "default";
+
 /* get the current UTC time in milliseconds */
 auto GetTimeUtc() noexcept -> uint64_t;
 
@@ -54,6 +63,7 @@ class Cache {
     auto Size() const noexcept -> size_t;
     void UpdateTimestamp() noexcept;
     auto GetTimestamp() const noexcept -> uint64_t;
+    auto GetInsertTimestamp() const noexcept -> uint64_t;
 
    private:
     /* the resource identifier for this node */
@@ -62,11 +72,18 @@ class Cache {
     std::vector<unsigned char> data_;
     /* the timestamp of last access in milliseconds */
     uint64_t last_access_{0};
+    /* the timestamp of insertion in milliseconds, which the time-to-live counts from */
+    uint64_t inserted_at_{0};
     CacheNode *prev_{nullptr};
     CacheNode *next_{nullptr};
   };
 
-  explicit Cache(size_t capacity = DEFAULT_CACHE_CAPACITY) noexcept;
+  /*
+   * a resource older than the time_to_live in milliseconds is treated as absent
+   * the hits, misses and evictions are counted in the metrics labeled by the name
+   */
+  explicit Cache(size_t capacity = DEFAULT_CACHE_CAPACITY, uint64_t time_to_live = NO_EXPIRATION,
+                 std::string_view name = DEFAULT_CACHE_NAME);
 
   NON_COPYABLE_AND_MOVEABLE(Cache);
 
@@ -74,10 +91,12 @@ class Cache {
 
   auto GetCapacity() const noexcept -> size_t;
 
+  auto GetTimeToLive() const noexcept -> uint64_t;
+
   /**
    * Given the resource url to search, if found
    * populate the destination buffer and return true
-   * if not exists, return false
+   * if not exists or expired, return false
    */
   auto TryLoad(const std::string &resource_url,
                std::vector<unsigned char> &destination) -> bool;  // NOLINT
@@ -86,7 +105,7 @@ class Cache {
    * Given the resource_url and content, try to insert it into the cache
    * return true if success, false otherwise
    * failure reason could be that the content is too big or identical
-   * resource_url already cached
+   * resource_url already cached and not expired yet
    */
   auto TryInsert(const std::string &resource_url, const std::vector<unsigned char> &source) -> bool;
 
@@ -101,6 +120,13 @@ class Cache {
    */
   void EvictOne() noexcept;
 
+  /**
+   * Take a node out of both the list and the mapping
+   */
+  void RemoveNode(std::unordered_map<std::string, std::shared_ptr<CacheNode>>::iterator iter) noexcept;
+
+  auto IsExpired(const CacheNode &node) const noexcept -> bool;
+
   /**
    * Helper function to remove a node from the doubly-linked list
    * essentially re-wire the prev and next pointers to each other
@@ -113,17 +139,22 @@ class Cache {
   void AppendToListTail(const std::shared_ptr<CacheNode> &node) noexcept;
 
   /* concurrency */
-  std::shared_mutex mtx_;
+  SharedMutex mtx_{"cache"};
   /* map a key (resource name) to the corresponding cache node if exists */
   std::unordered_map<std::string, std::shared_ptr<CacheNode>> mapping_;
   /* the upper limit of cache storage capacity in bytes */
   const size_t capacity_;
   /* current occupancyin bytes */
   size_t occupancy_{0};
+  /* how long a resource stays valid since insertion in milliseconds, 0 for forever */
+  const uint64_t time_to_live_;
   /* the dummy sentinel header in doubly-linked list */
   const std::shared_ptr<CacheNode> header_;
   /* the dummy sentinel tailer in doubly-linked list */
   const std::shared_ptr<CacheNode> tailer_;
+  Counter hits_;
+  Counter misses_;
+  Counter evictions_;
 };
 
 }  // namespace TURTLE_SERVER
@@ -0,0 +1,111 @@
+/**
+ * @file client_limiter.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the ClientLimiter which caps the
+ * connections and rate limits the requests of each client address
+ */
+
+#ifndef SRC_INCLUDE_CORE_CLIENT_LIMITER_H_
+#define SRC_INCLUDE_CORE_CLIENT_LIMITER_H_
+
+#include <array>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+
+/* default cap on the concurrent connections from one client address */
+static constexpr size_t DEFAULT_MAX_CONNECTIONS_PER_IP = 512;
+
+/* by default a client address could sustain this many requests per second, with bursts up to the latter */
+static constexpr double DEFAULT_REQUESTS_PER_SECOND = 1000;
+static constexpr double DEFAULT_REQUEST_BURST = 2000;
+
+/* the number of independently locked shards, a power of 2 */
+static constexpr size_t CLIENT_LIMITER_SHARDS = 16;
+
+/* a shard sweeps away the entries of idle clients once it grows beyond this, or twice its size after the last sweep */
+static constexpr size_t CLIENT_LIMITER_SWEEP_SIZE = 4096;
+
+/**
+ * The limits applied to each client address, a limit of 0 disables its check
+ * the loopback addresses are exempted by default, since the local tools and benchmarks are trusted
+ */
+struct ClientLimits {
+  size_t max_connections_per_ip_{DEFAULT_MAX_CONNECTIONS_PER_IP};
+  double requests_per_second_{DEFAULT_REQUESTS_PER_SECOND};
+  double request_burst_{DEFAULT_REQUEST_BURST};
+  bool exempt_loopback_{true};
+};
+
+/**
+ * This ClientLimiter keeps a connection count and a request token bucket per client address
+ * It is shared by the acceptor and all the reactors, so the table is split into shards
+ * each guarded by its own mutex, and a client only ever contends on the shard its address hashes to
+ * A token bucket is refilled lazily upon each request by the time elapsed since the last one,
+ * so no background thread is involved
+ */
+class ClientLimiter {
+ public:
+  explicit ClientLimiter(ClientLimits limits = {});
+
+  ~ClientLimiter() = default;
+
+  NON_COPYABLE_AND_MOVEABLE(ClientLimiter);
+
+  /* count in a new connection, return false if the address is already at its cap */
+  auto TryConnect(const std::string &ip) -> bool;
+
+  /* count out a connection previously admitted by TryConnect() */
+  void Disconnect(const std::string &ip);
+
+  /* take a token for a request, return false if the address is out of tokens */
+  auto TryRequest(const std::string &ip) -> bool;
+
+  auto GetConnectionCount(const std::string &ip) -> size_t;
+
+  auto GetLimits() const noexcept -> const ClientLimits &;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    size_t connections_{0};
+    double tokens_{0};
+    Clock::time_point refilled_at_{};
+  };
+
+  struct Shard {
+    std::mutex mtx_;
+    std::unordered_map<std::string, Entry> entries_;
+    size_t sweep_at_{CLIENT_LIMITER_SWEEP_SIZE};
+  };
+
+  auto IsExempted(const std::string &ip) const noexcept -> bool;
+
+  auto GetShard(const std::string &ip) noexcept -> Shard &;
+
+  /* find or create the entry of an address, with a full bucket if new, under the shard's lock */
+  auto GetEntry(Shard &shard, const std::string &ip, Clock::time_point now) -> Entry &;  // NOLINT
+
+  void Refill(Entry &entry, Clock::time_point now) const noexcept;  // NOLINT
+
+  /* drop the entries with no connection and a full bucket, which are the same as brand new ones */
+  void Sweep(Shard &shard, Clock::time_point now);  // NOLINT
+
+  ClientLimits limits_;
+  std::array<Shard, CLIENT_LIMITER_SHARDS> shards_;
+};
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_CORE_CLIENT_LIMITER_H_
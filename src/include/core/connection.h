@@ -12,6 +12,10 @@
 #ifndef SRC_INCLUDE_CORE_CONNECTION_H_
 #define SRC_INCLUDE_CORE_CONNECTION_H_
 
+#include <sys/types.h>
+
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -26,6 +30,15 @@ namespace TURTLE_SERVER {
 
 constexpr static int TEMP_BUF_SIZE = 2048;
 
+/* stop reading from a client once this many bytes are waiting to be sent to it */
+constexpr static size_t DEFAULT_HIGH_WATERMARK = 1024 * 1024;
+
+/* and resume once they drain down to this */
+constexpr static size_t DEFAULT_LOW_WATERMARK = 256 * 1024;
+
+/* no response written to the current request yet */
+constexpr static int NO_RESPONSE_STATUS = -1;
+
 class Looper;
 
 /**
@@ -37,12 +50,19 @@ class Looper;
 class Connection {
  public:
   explicit Connection(std::unique_ptr<Socket> socket);
-  ~Connection() = default;
+  /* close the files of the slices still pending */
+  ~Connection();
 
   NON_COPYABLE(Connection);
 
   auto GetFd() const noexcept -> int;
   auto GetSocket() noexcept -> Socket *;
+  /* unique over the process lifetime, unlike the fd which is recycled */
+  auto GetId() const noexcept -> uint64_t;
+
+  /* the address of the client in text, as the per-client limits and logs key on it */
+  void SetPeerIp(std::string peer_ip);
+  auto GetPeerIp() const noexcept -> const std::string &;
 
   /* for Poller */
   void SetEvents(uint32_t events);
@@ -57,29 +77,110 @@ class Connection {
   auto FindAndPopTill(const std::string &target) -> std::optional<std::string>;
   auto GetReadBufferSize() const noexcept -> size_t;
   auto GetWriteBufferSize() const noexcept -> size_t;
+  /* the bytes not sent yet, either in the write buffer or in the files still pending */
+  auto GetPendingSize() const noexcept -> size_t;
   void WriteToReadBuffer(const unsigned char *buf, size_t size);
   void WriteToWriteBuffer(const unsigned char *buf, size_t size);
   void WriteToReadBuffer(const std::string &str);
   void WriteToWriteBuffer(const std::string &str);
   void WriteToWriteBuffer(std::vector<unsigned char> &&other_buf);
+  /* for serializing a response in place */
+  auto GetWriteBuffer() noexcept -> Buffer *;
 
   auto Read() const noexcept -> const unsigned char *;
   auto ReadAsString() const noexcept -> std::string;
 
   /* return std::pair<How many bytes read, whether the client exits> */
   auto Recv() -> std::pair<ssize_t, bool>;
+  /*
+   * write as much as the socket takes without blocking
+   * the rest stays in the write buffer, and is flushed by the looper once the socket is writable again
+   */
   void Send();
+  /*
+   * zero-copy send a slice of an opened file after whatever is pending
+   * if the socket could not take all of it, the rest is kept as a file tail, and sent from a duplicate of
+   * the fd once the bytes written before it are flushed, so the file is never read into memory
+   * the bytes written afterwards follow the tail
+   * return false if the slice could be neither sent nor queued, when whatever pending is dropped
+   * and the connection is closing, as the response could never be delivered in order anymore
+   */
+  auto SendFile(int file_fd, off_t offset, size_t count) -> bool;
   void ClearReadBuffer() noexcept;
+  /* the file tails pending are dropped along */
   void ClearWriteBuffer() noexcept;
 
   void SetLooper(Looper *looper) noexcept;
   auto GetLooper() noexcept -> Looper *;
 
+  /* a suspended connection keeps buffering incoming bytes, but no more request is processed till resumed */
+  void Suspend() noexcept;
+  void Resume() noexcept;
+  auto IsSuspended() const noexcept -> bool;
+
+  /**
+   * Write-side backpressure
+   * once the pending bytes, file tails included, reach the high watermark, the looper stops reading from the client
+   * and the high callback notifies the producer, if any
+   * once they drain down to the low watermark, reading resumes and the low callback is invoked
+   */
+  void SetWatermarks(size_t high_watermark, size_t low_watermark) noexcept;
+  void SetHighWatermarkCallback(const std::function<void(Connection *)> &callback);
+  void SetLowWatermarkCallback(const std::function<void(Connection *)> &callback);
+  auto IsReadPaused() const noexcept -> bool;
+
+  /* how many requests have been served on this connection so far */
+  void IncrementServed() noexcept;
+  auto GetServedCount() const noexcept -> uint64_t;
+
+  /* the status of the response to the current request, opaque to the core, reset as the next request begins */
+  void SetResponseStatus(int status) noexcept;
+  auto GetResponseStatus() const noexcept -> int;
+
+  /* how many bytes have been handed to the write path so far, either sent or still pending */
+  auto GetBytesOut() const noexcept -> uint64_t;
+
+  /* a closing connection processes no more request, and is closed by the looper once its writes are flushed */
+  void SetClosing() noexcept;
+  auto IsClosing() const noexcept -> bool;
+
  private:
+  /* the rest of a file slice the socket could not take, behind the first position_ bytes of the write buffer */
+  struct FileTail {
+    int fd_;
+    off_t offset_;
+    size_t remaining_;
+    size_t position_;
+  };
+
+  /* zero-copy send from a file till the socket is full, return false upon an error or a file shorter than expected */
+  auto SendFromFile(int file_fd, off_t &offset, size_t &remaining) -> bool;  // NOLINT
+
+  /* drop whatever is pending, which could never be delivered */
+  void DropPending() noexcept;
+
+  /* watch for writability while bytes are pending, and apply the watermarks */
+  void UpdateWriteState();
+
+  static std::atomic<uint64_t> next_id;
+  uint64_t id_;
+  std::string peer_ip_;
+  bool suspended_{false};
+  bool read_paused_{false};
+  bool closing_{false};
+  uint64_t served_{0};
+  int response_status_{NO_RESPONSE_STATUS};
+  uint64_t bytes_sent_{0};
+  size_t high_watermark_{DEFAULT_HIGH_WATERMARK};
+  size_t low_watermark_{DEFAULT_LOW_WATERMARK};
+  std::function<void(Connection *)> high_watermark_callback_{nullptr};
+  std::function<void(Connection *)> low_watermark_callback_{nullptr};
   Looper *owner_looper_{nullptr};
   std::unique_ptr<Socket> socket_;
   std::unique_ptr<Buffer> read_buffer_;
   std::unique_ptr<Buffer> write_buffer_;
+  std::deque<FileTail> file_tails_;
+  size_t file_tails_size_{0};
   uint32_t events_{0};
   uint32_t revents_{0};
   std::function<void()> callback_{nullptr};
@@ -12,14 +12,21 @@
 #ifndef SRC_INCLUDE_CORE_LOOPER_H_
 #define SRC_INCLUDE_CORE_LOOPER_H_
 
+#include <pthread.h>
+
 #include <atomic>
+#include <chrono>  // NOLINT
 #include <cstdint>
 #include <functional>
 #include <future>  // NOLINT
 #include <map>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <vector>
 
+#include "core/alloc_tracker.h"
+#include "core/metrics.h"
+#include "core/profiled_mutex.h"
 #include "core/timer.h"
 #include "core/utils.h"
 
@@ -28,9 +35,18 @@ namespace TURTLE_SERVER {
 /* the epoll_wait time in milliseconds */
 static constexpr int TIMEOUT = 3000;
 
+/* a callback running for this many microseconds or longer is logged along with its connection, 0 for never */
+static constexpr uint64_t DEFAULT_SLOW_CALLBACK_THRESHOLD = 10000;
+
+/* the slowest callback is tracked over intervals of this long */
+static constexpr std::chrono::seconds SLOWEST_CALLBACK_INTERVAL = std::chrono::seconds(10);
+
 /* a connection must be finished within this amount of time */
 static constexpr uint64_t INACTIVE_TIMEOUT = 3000;
 
+/* a closing connection gets this long to flush its pending writes */
+static constexpr uint64_t LINGER_TIMEOUT = 5000;
+
 class Poller;
 
 class ThreadPool;
@@ -39,6 +55,43 @@ class Connection;
 
 class Acceptor;
 
+/* a snapshot of how busy a looper is, for the admission control */
+struct LooperLoad {
+  size_t connections_{0};
+  /* how many connections were ready in the current round */
+  size_t ready_backlog_{0};
+  /* how long the last round took to run the callbacks in milliseconds */
+  uint64_t round_time_{0};
+  /* the asynchronous work in flight, i.e. spawned CGI programs */
+  size_t outstanding_work_{0};
+};
+
+/* what a looper is up to, watched for a stall */
+struct LooperHeartbeat {
+  /* the steady clock tick the current round began at, 0 while polling */
+  int64_t busy_since_;
+  /* the fd whose callback is running, or ran last */
+  int fd_;
+  /* the looper's thread, only valid while busy */
+  pthread_t thread_;
+};
+
+/* the instrumentation of a looper, labeled by its id in the metrics */
+struct LooperMetrics {
+  explicit LooperMetrics(uint64_t looper_id);
+
+  /* microseconds spent blocked in the poll, and running the callbacks, the ratio of which is the utilization */
+  Counter poll_time_;
+  Counter busy_time_;
+  /* the rounds, and the ready connections over them */
+  Counter wakeups_;
+  Counter ready_events_;
+  Counter slow_callbacks_;
+  /* the slowest callback of the last interval, or of the current one if slower, and the fd it ran for */
+  Gauge slowest_callback_;
+  Gauge slowest_fd_;
+};
+
 /**
  * This Looper acts as the executor on a single thread
  * adopt the philosophy of 'one looper per thread'
@@ -56,23 +109,94 @@ class Looper {
 
   void AddAcceptor(Connection *acceptor_conn);
 
-  void AddConnection(std::unique_ptr<Connection> new_conn);
+  /* a connection not expiring when idle, e.g. a pipe of the server's own, should be bounded by a deadline instead */
+  void AddConnection(std::unique_ptr<Connection> new_conn, bool expire_idle = true);
+
+  /* monitor a connection owned elsewhere, which is never expired by the timer */
+  void AddWatcher(Connection *watcher_conn);
+
+  /* nullptr if no such connection is owned by this looper */
+  auto FindConnection(int fd) noexcept -> Connection *;
 
   auto RefreshConnection(int fd) noexcept -> bool;
 
+  /* apply the changed events of a connection owned by this looper to the poller */
+  void UpdateConnection(Connection *conn);
+
+  /**
+   * Kick out the connection unless the deadline is cleared within expire_from_now milliseconds
+   * It works regardless of the idle timer, and a deadline already set is kept instead of extended
+   * on_expire, if any, is called right after the connection is kicked out upon the deadline
+   */
+  void SetDeadline(int fd, uint64_t expire_from_now, std::function<void()> on_expire = nullptr);
+
+  void ClearDeadline(int fd) noexcept;
+
+  /*
+   * a connection deleted in the middle of a round of callbacks is only destroyed at the end of it
+   * since it might still be among the ready ones of this round
+   */
   auto DeleteConnection(int fd) noexcept -> bool;
 
+  /* delete the connection once its pending writes are flushed, instead of dropping them */
+  void CloseConnection(int fd);
+
   void SetExit() noexcept;
 
+  /* account for a piece of asynchronous work started on and completed back on this looper */
+  void BeginWork() noexcept;
+  void EndWork() noexcept;
+
+  auto GetLoad() noexcept -> LooperLoad;
+
+  /* the label of this looper's metrics */
+  auto GetId() const noexcept -> uint64_t;
+
+  /* beaten once per round, and read by another thread */
+  auto GetHeartbeat() const noexcept -> LooperHeartbeat;
+
+  /* in microseconds, 0 to never log a slow callback */
+  void SetSlowCallbackThreshold(uint64_t threshold) noexcept;
+
  private:
+  auto IsRetired(Connection *conn) noexcept -> bool;
+
+  /* account for the callback of the fd that began at begin, with its allocations, return when it ended */
+  auto AccountCallback(Connection *conn, int fd, std::chrono::steady_clock::time_point begin,
+                       const AllocationScope &allocations) -> std::chrono::steady_clock::time_point;
+
+  /* publish the slowest callback of the interval once it is over, and start a new one */
+  void RollInterval(std::chrono::steady_clock::time_point now) noexcept;
+
+  /* flush the pending writes, then invoke the callback unless the connection is not to be read from */
+  void HandleEvent(Connection *conn);
+
   std::unique_ptr<Poller> poller_;
-  std::mutex mtx_;
+  Mutex mtx_{"looper"};
   std::map<int, std::unique_ptr<Connection>> connections_;
+  std::vector<std::unique_ptr<Connection>> retired_;
   std::map<int, Timer::SingleTimer *> timers_mapping_;
+  std::map<int, Timer::SingleTimer *> deadlines_mapping_;
   Timer timer_{};
   bool exit_{false};
+  size_t ready_backlog_{0};
+  uint64_t round_time_{0};
+  std::atomic<size_t> outstanding_work_{0};
   bool use_timer_{false};
   uint64_t timer_expiration_{0};
+  const uint64_t id_;
+  LooperMetrics metrics_;
+  std::atomic<uint64_t> slow_callback_threshold_{DEFAULT_SLOW_CALLBACK_THRESHOLD};
+  /* only touched by the looping thread */
+  std::chrono::steady_clock::time_point interval_begin_;
+  uint64_t interval_slowest_{0};
+  int interval_slowest_fd_{-1};
+  uint64_t published_slowest_{0};
+  /* the heartbeat, the thread published before the first beat */
+  std::atomic<int64_t> busy_since_{0};
+  std::atomic<int> busy_fd_{-1};
+  pthread_t thread_{};
+  static std::atomic<uint64_t> next_id;
 };
 }  // namespace TURTLE_SERVER
 #endif  // SRC_INCLUDE_CORE_LOOPER_H_
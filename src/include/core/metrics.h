@@ -0,0 +1,237 @@
+/**
+ * @file metrics.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the metrics registry, with the
+ * counters, gauges and latency histograms recorded per thread
+ */
+
+#ifndef SRC_INCLUDE_CORE_METRICS_H_
+#define SRC_INCLUDE_CORE_METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+
+/* at most this many counters and gauges, and this many histograms, could be registered */
+static constexpr size_t MAX_METRICS = 2048;
+static constexpr size_t MAX_HISTOGRAMS = 32;
+
+/*
+ * HDR-style log-linear buckets: a value below 2^HISTOGRAM_SUB_BITS has its own bucket,
+ * and each power of two above is split into 2^HISTOGRAM_SUB_BITS buckets, so that
+ * a bucket is within 1/16 of the values it holds, across the full range of uint64_t
+ */
+static constexpr uint32_t HISTOGRAM_SUB_BITS = 4;
+static constexpr size_t HISTOGRAM_SUB_BUCKETS = size_t{1} << HISTOGRAM_SUB_BITS;
+static constexpr size_t HISTOGRAM_BUCKETS = (64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS;
+
+/* the histogram buckets exposed are bounded by 2^n - 1 for n up to this, by default */
+static constexpr uint32_t DEFAULT_HISTOGRAM_EXPOSED_BITS = 32;
+
+enum class MetricType { COUNTER, GAUGE, HISTOGRAM };
+
+/* the bucket a value falls into */
+constexpr auto HistogramBucket(uint64_t value) noexcept -> size_t {
+  if (value < HISTOGRAM_SUB_BUCKETS) {
+    return value;
+  }
+  auto magnitude = static_cast<uint32_t>(63 - __builtin_clzll(value));
+  auto sub = (value >> (magnitude - HISTOGRAM_SUB_BITS)) - HISTOGRAM_SUB_BUCKETS;
+  return (magnitude - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/* the largest value held by a bucket */
+constexpr auto HistogramBucketUpperBound(size_t bucket) noexcept -> uint64_t {
+  if (bucket < HISTOGRAM_SUB_BUCKETS) {
+    return bucket;
+  }
+  auto magnitude = static_cast<uint32_t>(bucket / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BITS - 1);
+  auto sub = bucket % HISTOGRAM_SUB_BUCKETS;
+  auto width = uint64_t{1} << (magnitude - HISTOGRAM_SUB_BITS);
+  return ((HISTOGRAM_SUB_BUCKETS + sub) << (magnitude - HISTOGRAM_SUB_BITS)) + width - 1;
+}
+
+/* the part of a histogram written by a single thread */
+struct HistogramShard {
+  std::atomic<uint64_t> buckets_[HISTOGRAM_BUCKETS]{};
+  std::atomic<uint64_t> sum_{0};
+};
+
+/*
+ * the values written by a single thread, each slot by its owner thread only
+ * so that a record is a plain load and store instead of a contended read-modify-write
+ * a gauge's slot holds the net delta made by the thread, which might be negative
+ */
+struct MetricsShard {
+  std::atomic<uint64_t> values_[MAX_METRICS]{};
+  /* allocated upon the first record on the thread */
+  std::atomic<HistogramShard *> histograms_[MAX_HISTOGRAMS]{};
+};
+
+/* the calling thread's shard, registered upon the first use */
+inline auto LocalMetricsShard() -> MetricsShard &;
+
+/* a monotonic count, the default constructed one records into a slot never exposed */
+class Counter {
+ public:
+  Counter() = default;
+
+  void Inc(uint64_t delta = 1) const noexcept {
+    auto &value = LocalMetricsShard().values_[slot_];
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MetricsRegistry;
+  explicit Counter(uint32_t slot) noexcept : slot_(slot) {}
+  uint32_t slot_{0};
+};
+
+/* a value going up and down, possibly on different threads */
+class Gauge {
+ public:
+  Gauge() = default;
+
+  void Add(int64_t delta) const noexcept {
+    auto &value = LocalMetricsShard().values_[slot_];
+    value.store(value.load(std::memory_order_relaxed) + static_cast<uint64_t>(delta), std::memory_order_relaxed);
+  }
+
+  void Inc() const noexcept { Add(1); }
+
+  void Dec() const noexcept { Add(-1); }
+
+  /* only for a gauge written by a single thread all along, i.e. by a looper on its own */
+  void Set(int64_t value) const noexcept {
+    LocalMetricsShard().values_[slot_].store(static_cast<uint64_t>(value), std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MetricsRegistry;
+  explicit Gauge(uint32_t slot) noexcept : slot_(slot) {}
+  uint32_t slot_{0};
+};
+
+/* the distribution of e.g. the latencies, in whatever unit the name says */
+class Histogram {
+ public:
+  Histogram() = default;
+
+  void Record(uint64_t value) const noexcept {
+    auto *shard = LocalMetricsShard().histograms_[slot_].load(std::memory_order_relaxed);
+    if (shard == nullptr) {
+      shard = AllocateLocal();
+    }
+    auto &bucket = shard->buckets_[HistogramBucket(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard->sum_.store(shard->sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+ private:
+  friend class MetricsRegistry;
+  explicit Histogram(uint32_t slot) noexcept : slot_(slot) {}
+  auto AllocateLocal() const -> HistogramShard *;
+  uint32_t slot_{0};
+};
+
+/* the per-thread parts of a histogram merged */
+struct HistogramSnapshot {
+  /* the smallest bucket upper bound that at least q of the values fall under, 0 if empty */
+  auto Quantile(double q) const noexcept -> uint64_t;
+
+  std::vector<uint64_t> buckets_ = std::vector<uint64_t>(HISTOGRAM_BUCKETS);
+  uint64_t count_{0};
+  uint64_t sum_{0};
+};
+
+/**
+ * This MetricsRegistry is where every metric is declared once, by name and
+ * labels, and then recorded through its handle at the cost of a few nanoseconds:
+ * each thread writes into its own MetricsShard, no lock and no atomic read-modify-write
+ * The per-thread values are merged only upon a read or a scrape, which is rare
+ * The shards outlive their threads, so that the counts of an exited thread are kept
+ */
+class MetricsRegistry {
+ public:
+  static auto GetInstance() -> MetricsRegistry &;
+
+  NON_COPYABLE_AND_MOVEABLE(MetricsRegistry);
+
+  /*
+   * declare a metric, the labels in Prometheus form, i.e. status="200"
+   * the same name and labels declared again get the same handle
+   * beyond the capacity, the handle records into a slot never exposed
+   */
+  auto AddCounter(std::string_view name, std::string_view help, std::string_view labels = "") -> Counter;
+
+  auto AddGauge(std::string_view name, std::string_view help, std::string_view labels = "") -> Gauge;
+
+  /* the exposed buckets are bounded by 0, 1, 3, ..., 2^exposed_bits - 1 and +Inf */
+  auto AddHistogram(std::string_view name, std::string_view help, std::string_view labels = "",
+                    uint32_t exposed_bits = DEFAULT_HISTOGRAM_EXPOSED_BITS) -> Histogram;
+
+  auto Read(Counter counter) -> uint64_t;
+
+  auto Read(Gauge gauge) -> int64_t;
+
+  auto Read(Histogram histogram) -> HistogramSnapshot;
+
+  /* append the Prometheus text exposition of every metric declared */
+  void Expose(std::string &out);  // NOLINT
+
+ private:
+  friend auto LocalMetricsShard() -> MetricsShard &;
+  friend class Histogram;
+
+  struct Metric {
+    std::string name_;
+    std::string help_;
+    std::string labels_;
+    MetricType type_;
+    uint32_t slot_;
+    uint32_t exposed_bits_;
+  };
+
+  MetricsRegistry() = default;
+
+  auto Add(MetricType type, std::string_view name, std::string_view help, std::string_view labels,
+           uint32_t exposed_bits) -> uint32_t;
+
+  auto AddShard() -> MetricsShard *;
+
+  auto AllocateHistogram(MetricsShard *shard, uint32_t slot) -> HistogramShard *;
+
+  /* the sum of a slot across all the shards, wrapping around for a negative gauge */
+  auto Sum(uint32_t slot) -> uint64_t;
+
+  auto Merge(uint32_t slot) -> HistogramSnapshot;
+
+  std::mutex mtx_;
+  std::vector<Metric> metrics_;
+  /* slot 0 of either kind is reserved for the default constructed handles */
+  uint32_t next_value_slot_{1};
+  uint32_t next_histogram_slot_{1};
+  std::vector<std::unique_ptr<MetricsShard>> shards_;
+  std::vector<std::unique_ptr<HistogramShard>> histogram_shards_;
+};
+
+inline auto LocalMetricsShard() -> MetricsShard & {
+  thread_local MetricsShard *shard = MetricsRegistry::GetInstance().AddShard();
+  return *shard;
+}
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_CORE_METRICS_H_
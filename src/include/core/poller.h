@@ -31,10 +31,12 @@ static constexpr int DEFAULT_EVENTS_LISTENED = 1024;
 #ifdef OS_LINUX  // Linux Epoll
 static constexpr unsigned POLL_ADD = EPOLL_CTL_ADD;
 static constexpr unsigned POLL_READ = EPOLLIN;
+static constexpr unsigned POLL_WRITE = EPOLLOUT;
 static constexpr unsigned POLL_ET = EPOLLET;
 #elif OS_MAC  // Mac KQueue
 static constexpr unsigned POLL_ADD = EVFILT_READ;  // a bit awkward but this is how kqueue works
 static constexpr unsigned POLL_READ = EV_ADD;
+static constexpr unsigned POLL_WRITE = EV_FLAG1;  // not a kevent flag, but tells to add the EVFILT_WRITE filter
 static constexpr unsigned POLL_ET = EV_CLEAR;
 #endif
 
@@ -53,6 +55,15 @@ class Poller {
 
   void AddConnection(Connection *conn);
 
+  /* apply the changed events of a connection already monitored, i.e. start or stop watching for POLL_WRITE */
+  void ModifyConnection(Connection *conn);
+
+  /*
+   * stop monitoring a connection before it is closed
+   * closing the fd alone is not enough while a spawned child still shares it
+   */
+  void RemoveConnection(Connection *conn);
+
   // timeout in milliseconds
   auto Poll(int timeout = -1) -> std::vector<Connection *>;
 
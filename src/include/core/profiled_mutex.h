@@ -0,0 +1,212 @@
+/**
+ * @file profiled_mutex.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the named mutexes on the hot paths,
+ * profiled for contention when built with LOCK_PROFILING
+ */
+
+#ifndef SRC_INCLUDE_CORE_PROFILED_MUTEX_H_
+#define SRC_INCLUDE_CORE_PROFILED_MUTEX_H_
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <mutex>  // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+
+/* a bucket for 0, and one for each power of two of nanoseconds */
+static constexpr size_t LOCK_HISTOGRAM_BUCKETS = 65;
+
+/* the wait and hold times exposed are bounded by 2^n - 1 nanoseconds for n up to this, about 17 seconds */
+static constexpr uint32_t LOCK_HISTOGRAM_EXPOSED_BITS = 34;
+
+/* the distribution of the wait or hold times of a lock, in nanoseconds */
+struct LockHistogram {
+  void Record(uint64_t nanoseconds) noexcept {
+    auto bucket = nanoseconds == 0 ? 0 : 64 - __builtin_clzll(nanoseconds);
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(nanoseconds, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> buckets_[LOCK_HISTOGRAM_BUCKETS]{};
+  std::atomic<uint64_t> sum_{0};
+};
+
+/* the contention of a lock, shared by all the mutexes of the same name */
+struct LockProfile {
+  explicit LockProfile(std::string_view name) : name_(name) {}
+
+  const std::string name_;
+  std::atomic<uint64_t> acquisitions_{0};
+  std::atomic<uint64_t> contended_{0};
+  LockHistogram wait_;
+  LockHistogram hold_;
+};
+
+/**
+ * This LockProfiler keeps a profile per lock name, which is never freed
+ * It is header-only but for the exposition, so that the logger could use
+ * the profiled mutexes without depending on the core library
+ */
+class LockProfiler {
+ public:
+  static auto GetInstance() -> LockProfiler & {
+    // never destroyed, since a mutex might be locked on the way out
+    static auto *profiler = new LockProfiler();
+    return *profiler;
+  }
+
+  NON_COPYABLE_AND_MOVEABLE(LockProfiler);
+
+  auto GetProfile(std::string_view name) -> LockProfile * {
+    std::unique_lock<std::mutex> lock(mtx_);
+    for (auto &profile : profiles_) {
+      if (profile.name_ == name) {
+        return &profile;
+      }
+    }
+    return &profiles_.emplace_back(name);
+  }
+
+  /* append the Prometheus text exposition of every lock profiled, nothing if none is */
+  void Expose(std::string &out);  // NOLINT
+
+ private:
+  LockProfiler() = default;
+
+  std::mutex mtx_;
+  /* never reallocated, so that a profile stays where it is */
+  std::deque<LockProfile> profiles_;
+};
+
+/**
+ * This ProfiledMutex wraps a std::mutex or std::shared_mutex, and records into the profile
+ * of its name the acquisitions, the contended ones, i.e. not acquired upon the first try,
+ * and the distributions of the time waited and, for the exclusive ones, the time held
+ * It costs two clock reads and a few shared atomic increments per acquisition,
+ * thus only meant for a profiling build
+ */
+template <typename M>
+class ProfiledMutex {
+ public:
+  using lockable_type = ProfiledMutex;
+
+  explicit ProfiledMutex(std::string_view name) : profile_(LockProfiler::GetInstance().GetProfile(name)) {}
+
+  NON_COPYABLE_AND_MOVEABLE(ProfiledMutex);
+
+  void lock() {
+    if (!mutex_.try_lock()) {
+      auto wait_begin = Now();
+      mutex_.lock();
+      hold_begin_ = Now();
+      Acquired(true, hold_begin_ - wait_begin);
+      return;
+    }
+    hold_begin_ = Now();
+    Acquired(false, 0);
+  }
+
+  auto try_lock() -> bool {
+    if (!mutex_.try_lock()) {
+      return false;
+    }
+    hold_begin_ = Now();
+    Acquired(false, 0);
+    return true;
+  }
+
+  void unlock() {
+    auto held = Now() - hold_begin_;
+    mutex_.unlock();
+    profile_->hold_.Record(held);
+  }
+
+  /* the shared ones overlap, thus only their waits are recorded */
+  void lock_shared() {
+    if (!mutex_.try_lock_shared()) {
+      auto wait_begin = Now();
+      mutex_.lock_shared();
+      Acquired(true, Now() - wait_begin);
+      return;
+    }
+    Acquired(false, 0);
+  }
+
+  auto try_lock_shared() -> bool {
+    if (!mutex_.try_lock_shared()) {
+      return false;
+    }
+    Acquired(false, 0);
+    return true;
+  }
+
+  void unlock_shared() { mutex_.unlock_shared(); }
+
+ private:
+  static auto Now() noexcept -> uint64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void Acquired(bool contended, uint64_t waited) noexcept {
+    profile_->acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    if (contended) {
+      profile_->contended_.fetch_add(1, std::memory_order_relaxed);
+    }
+    profile_->wait_.Record(waited);
+  }
+
+  M mutex_;
+  LockProfile *profile_;
+  /* written and read by the exclusive owner only */
+  uint64_t hold_begin_{0};
+};
+
+/* the mutex as it is, the name ignored, and locked as the standard one */
+template <typename M>
+class NamedMutex : public M {
+ public:
+  using lockable_type = M;
+
+  explicit NamedMutex(std::string_view /* name */) noexcept {}
+};
+
+#ifdef LOCK_PROFILING
+static constexpr bool LOCK_PROFILING_ENABLED = true;
+template <typename M>
+using HotMutex = ProfiledMutex<M>;
+#else
+static constexpr bool LOCK_PROFILING_ENABLED = false;
+template <typename M>
+using HotMutex = NamedMutex<M>;
+#endif
+
+/* the mutexes on the hot paths, constructed with the name they are profiled by */
+using Mutex = HotMutex<std::mutex>;
+using SharedMutex = HotMutex<std::shared_mutex>;
+
+/* the lock taken on a Mutex or SharedMutex, which a ConditionVariable waits with */
+template <typename M>
+using UniqueLock = std::unique_lock<typename M::lockable_type>;
+
+/* only the standard mutex could be waited on by the faster std::condition_variable */
+using ConditionVariable =
+    std::conditional_t<LOCK_PROFILING_ENABLED, std::condition_variable_any, std::condition_variable>;
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_CORE_PROFILED_MUTEX_H_
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/profiled_mutex.h"
 #include "core/utils.h"
 #ifndef SRC_INCLUDE_CORE_THREAD_POOL_H_
 #define SRC_INCLUDE_CORE_THREAD_POOL_H_
@@ -54,8 +55,8 @@ class ThreadPool {
  private:
   std::vector<std::thread> threads_;
   std::queue<std::function<void()>> tasks_;
-  std::mutex mtx_;
-  std::condition_variable cv_;
+  Mutex mtx_{"thread_pool"};
+  ConditionVariable cv_;
   std::atomic<bool> exit_{false};
 };
 
@@ -70,7 +71,7 @@ auto ThreadPool::SubmitTask(F &&new_task, Args &&...args) -> decltype(auto) {
   auto fut = packaged_new_task->get_future();
   {
     // submit in form of std::function to the Thread Pool task queue
-    std::unique_lock<std::mutex> lock(mtx_);
+    UniqueLock<Mutex> lock(mtx_);
     tasks_.emplace([packaged_new_task]() { (*packaged_new_task)(); });
   }
   cv_.notify_one();
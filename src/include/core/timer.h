@@ -21,6 +21,8 @@
 #include <mutex>  // NOLINT
 #include <vector>
 
+#include "core/profiled_mutex.h"
+
 namespace TURTLE_SERVER {
 
 class Socket;
@@ -97,7 +99,7 @@ class Timer {
 
   int timer_fd_;
   uint64_t next_expire_{0};
-  mutable std::mutex mtx_;
+  mutable Mutex mtx_{"timer"};
   std::unique_ptr<Connection> timer_conn_;
   std::map<SingleTimer *, std::unique_ptr<SingleTimer>, SingleTimerCompartor> timer_queue_;
 };
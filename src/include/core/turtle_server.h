@@ -7,6 +7,8 @@
  *
  * This is a header-file-only class for the Turtle web server setup
  */
+#include <signal.h>
+
 #include <algorithm>
 #include <functional>
 #include <memory>
@@ -17,6 +19,7 @@
 #include "core/acceptor.h"
 #include "core/buffer.h"
 #include "core/cache.h"
+#include "core/client_limiter.h"
 #include "core/connection.h"
 #include "core/looper.h"
 #include "core/net_address.h"
@@ -24,6 +27,7 @@
 #include "core/socket.h"
 #include "core/thread_pool.h"
 #include "core/utils.h"
+#include "core/watchdog.h"
 
 #ifndef SRC_INCLUDE_CORE_TURTLE_SERVER_H_
 #define SRC_INCLUDE_CORE_TURTLE_SERVER_H_
@@ -50,6 +54,8 @@ class TurtleServer {
  public:
   TurtleServer(NetAddress server_address, int concurrency = static_cast<int>(std::thread::hardware_concurrency()) - 1)
       : pool_(std::make_unique<ThreadPool>(concurrency)), listener_(std::make_unique<Looper>()) {
+    // sendfile() has no MSG_NOSIGNAL, so a client gone midway must fail the write instead of killing the process
+    signal(SIGPIPE, SIG_IGN);
     for (size_t i = 0; i < pool_->GetSize(); i++) {
       reactors_.push_back(std::make_unique<Looper>(TIMER_EXPIRATION));
     }
@@ -61,6 +67,11 @@ class TurtleServer {
     std::transform(reactors_.begin(), reactors_.end(), std::back_inserter(raw_reactors),
                    [](auto &uni_ptr) { return uni_ptr.get(); });
     acceptor_ = std::make_unique<Acceptor>(listener_.get(), raw_reactors, server_address);
+    watchdog_ = std::make_unique<Watchdog>();
+    watchdog_->Watch(listener_.get());
+    for (auto &reactor : reactors_) {
+      watchdog_->Watch(reactor.get());
+    }
   }
 
   virtual ~TurtleServer() = default;
@@ -78,6 +89,18 @@ class TurtleServer {
     return *this;
   }
 
+  /* cap the connections of each client address, the limiter could be shared to rate limit the requests as well */
+  auto WithClientLimiter(std::shared_ptr<ClientLimiter> limiter) -> TurtleServer & {
+    acceptor_->SetClientLimiter(std::move(limiter));
+    return *this;
+  }
+
+  /* a looper stuck on a callback for this long is reported along with its backtrace */
+  auto WithStallThreshold(std::chrono::milliseconds threshold) -> TurtleServer & {
+    watchdog_->SetThreshold(threshold);
+    return *this;
+  }
+
   void Begin() {
     if (!on_handle_set_) {
       throw std::logic_error("Please specify OnHandle callback function before starts");
@@ -91,6 +114,8 @@ class TurtleServer {
   std::vector<std::unique_ptr<Looper>> reactors_;
   std::unique_ptr<ThreadPool> pool_;
   std::unique_ptr<Looper> listener_;
+  /* stopped first, before the loopers it watches */
+  std::unique_ptr<Watchdog> watchdog_;
 };
 }  // namespace TURTLE_SERVER
 
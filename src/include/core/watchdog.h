@@ -0,0 +1,81 @@
+/**
+ * @file watchdog.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the Watchdog which catches a looper
+ * stalled by a blocking callback, along with where it is stuck
+ */
+
+#ifndef SRC_INCLUDE_CORE_WATCHDOG_H_
+#define SRC_INCLUDE_CORE_WATCHDOG_H_
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "core/metrics.h"
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+
+class Looper;
+
+/* a looper busy on the same round for this long is considered stalled */
+static constexpr std::chrono::milliseconds DEFAULT_STALL_THRESHOLD = std::chrono::milliseconds(1000);
+
+/* the heartbeats are checked at least this often */
+static constexpr std::chrono::milliseconds MAX_WATCHDOG_INTERVAL = std::chrono::milliseconds(100);
+
+/* the deepest backtrace captured of a stalled looper */
+static constexpr int MAX_STALL_FRAMES = 64;
+
+/**
+ * This Watchdog runs a thread of its own, checking the heartbeat of each looper watched
+ * A looper stuck on a round beyond the threshold, i.e. blocked in a callback,
+ * is counted once per stall in turtle_looper_stalls_total, and logged as a warning
+ * along with the fd being handled and the backtrace of the looper's thread,
+ * captured by interrupting it with SIGURG
+ * A looper watched must outlive the watchdog
+ */
+class Watchdog {
+ public:
+  explicit Watchdog(std::chrono::milliseconds threshold = DEFAULT_STALL_THRESHOLD);
+
+  ~Watchdog();
+
+  NON_COPYABLE_AND_MOVEABLE(Watchdog);
+
+  void Watch(Looper *looper);
+
+  void SetThreshold(std::chrono::milliseconds threshold) noexcept;
+
+ private:
+  struct Watched {
+    Looper *looper_;
+    Counter stalls_;
+    /* the round already reported, so that a long stall is counted once */
+    int64_t reported_since_{0};
+  };
+
+  void WatchLoop();
+
+  void Check(Watched &watched, int64_t now);  // NOLINT
+
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool done_{false};
+  std::vector<Watched> watched_;
+  std::atomic<int64_t> threshold_;
+  std::thread watcher_;
+};
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_CORE_WATCHDOG_H_
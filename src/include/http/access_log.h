@@ -0,0 +1,152 @@
+/**
+ * @file access_log.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the asynchronous access log,
+ * a line for each request served
+ */
+
+#ifndef SRC_INCLUDE_HTTP_ACCESS_LOG_H_
+#define SRC_INCLUDE_HTTP_ACCESS_LOG_H_
+
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "core/utils.h"
+#include "http/http_utils.h"
+#include "log/log_file.h"
+#include "log/log_record.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* access log file name prefix, followed by the creation time and the suffix */
+const std::string ACCESS_LOG_PATH = std::string("TurtleAccess");  // NOLINT
+
+/* the fields longer than these are truncated, so that a record is of a fixed size */
+static constexpr size_t ACCESS_CLIENT_SIZE = 48;
+static constexpr size_t ACCESS_PATH_SIZE = 256;
+static constexpr size_t ACCESS_HEADER_SIZE = 128;
+
+/* records buffered per reactor, beyond which they are dropped and counted instead of blocking */
+static constexpr size_t DEFAULT_ACCESS_RING_CAPACITY = 1024;
+/* the rings are drained at least this often, and as soon as one of them is half full */
+static constexpr std::chrono::milliseconds ACCESS_DRAIN_INTERVAL = std::chrono::milliseconds(100);
+
+/* common and combined are the Apache/Nginx formats, JSON adds the latency */
+enum class AccessLogFormat { COMMON, COMBINED, JSON };
+
+/* a request served, filled on the reactor and formatted later on the access log thread */
+struct AccessRecord {
+  /* copy the client address */
+  void SetClient(std::string_view client) noexcept;
+
+  /* copy the request line and the headers of the combined format, a rejected request has none */
+  void SetRequest(Method method, Version version, std::string_view path, std::string_view referer,
+                  std::string_view user_agent) noexcept;
+
+  /* microseconds since epoch upon the arrival of the request */
+  int64_t timestamp_{0};
+  /* the response bytes, head included */
+  uint64_t bytes_{0};
+  /* microseconds till the response is handed to the write path */
+  uint32_t latency_{0};
+  uint16_t status_{0};
+  bool has_request_{false};
+  Method method_{Method::UNSUPPORTED};
+  Version version_{Version::UNSUPPORTED};
+  /* NUL-terminated */
+  char client_[ACCESS_CLIENT_SIZE]{};
+  char path_[ACCESS_PATH_SIZE]{};
+  char referer_[ACCESS_HEADER_SIZE]{};
+  char user_agent_[ACCESS_HEADER_SIZE]{};
+};
+
+/* append the record as a line in the format */
+void FormatAccessRecord(const AccessRecord &record, AccessLogFormat format, LogBlock &out);  // NOLINT
+
+/**
+ * This AccessLog keeps the access logging off the reactors' critical path
+ * Each reactor copies a fixed-size AccessRecord into its own single-producer
+ * single-consumer ring, which takes no lock and no allocation
+ * A background thread drains all the rings, formats the records and hands them
+ * to the sink, by default a rotating LogFile, so the formatting and the file
+ * I/O never run on a reactor
+ * If a ring is full, the record is dropped and counted instead of blocking
+ */
+class AccessLog {
+ public:
+  /* written into the rotating files with the ".log" suffix */
+  explicit AccessLog(AccessLogFormat format = AccessLogFormat::COMBINED,
+                     LogFileOptions options = {ACCESS_LOG_PATH}, size_t ring_capacity = DEFAULT_ACCESS_RING_CAPACITY);
+
+  /* handed to a custom sink each round, with nothing if idle */
+  AccessLog(AccessLogFormat format, std::function<void(const std::vector<LogBlock> &)> sink,
+            size_t ring_capacity = DEFAULT_ACCESS_RING_CAPACITY);
+
+  /* the records already recorded are written out before it returns */
+  ~AccessLog();
+
+  NON_COPYABLE_AND_MOVEABLE(AccessLog);
+
+  /* copy the record into the calling thread's ring, never blocks */
+  void Record(const AccessRecord &record) noexcept;
+
+  /* how many records have been dropped as their ring is full */
+  auto GetDropped() const noexcept -> uint64_t;
+
+ private:
+  /* a single-producer single-consumer ring of records */
+  class AccessRing {
+   public:
+    explicit AccessRing(size_t capacity);
+
+    /* by the producer, false if full */
+    auto TryPush(const AccessRecord &record) noexcept -> bool;
+
+    /* by the producer, to wake up the consumer early */
+    auto IsHalfFull() const noexcept -> bool;
+
+    /* by the consumer, format and pop all the records available */
+    void Drain(AccessLogFormat format, LogBlock &out);  // NOLINT
+
+   private:
+    std::vector<AccessRecord> slots_;
+    /* only ever increasing, a slot is indexed modulo the capacity, each on its own cache line */
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+  };
+
+  /* the calling thread's ring of this access log, registered on first use */
+  auto GetLocalRing() -> AccessRing *;
+
+  void DrainLoop();
+
+  const uint64_t id_;
+  const AccessLogFormat format_;
+  const size_t ring_capacity_;
+  std::function<void(const std::vector<LogBlock> &)> sink_;
+  /* the rings live as long as the access log, even if their thread is gone */
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::vector<std::shared_ptr<AccessRing>> rings_;
+  std::atomic<bool> notified_{false};
+  bool done_{false};
+  std::atomic<uint64_t> dropped_{0};
+  std::thread drainer_;
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_ACCESS_LOG_H_
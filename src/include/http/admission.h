@@ -0,0 +1,55 @@
+/**
+ * @file admission.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the admission control which sheds
+ * new requests while a looper is overloaded
+ */
+
+#ifndef SRC_INCLUDE_HTTP_ADMISSION_H_
+#define SRC_INCLUDE_HTTP_ADMISSION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TURTLE_SERVER {
+struct LooperLoad;
+}  // namespace TURTLE_SERVER
+
+namespace TURTLE_SERVER::HTTP {
+
+/* default thresholds of a looper's load, beyond which new requests are shed */
+static constexpr size_t DEFAULT_MAX_CONNECTIONS = 10000;
+static constexpr size_t DEFAULT_MAX_READY_BACKLOG = 512;
+static constexpr uint64_t DEFAULT_MAX_ROUND_TIME = 200;
+static constexpr size_t DEFAULT_MAX_OUTSTANDING_WORK = 128;
+
+/* by default a shed client is asked to retry after this many seconds */
+static constexpr uint64_t DEFAULT_RETRY_AFTER = 1;
+
+/**
+ * The thresholds of the admission control, a threshold of 0 disables its check
+ * While a looper is over any of them, the first request of a new connection is replied
+ * a fast 503 with Retry-After and disconnected, so that its cost is close to nothing
+ * A keep-alive connection which has been served already is always admitted,
+ * so that the clients in the middle of their work finish first
+ */
+struct AdmissionLimits {
+  size_t max_connections_{DEFAULT_MAX_CONNECTIONS};
+  size_t max_ready_backlog_{DEFAULT_MAX_READY_BACKLOG};
+  /* in milliseconds */
+  uint64_t max_round_time_{DEFAULT_MAX_ROUND_TIME};
+  size_t max_outstanding_work_{DEFAULT_MAX_OUTSTANDING_WORK};
+  /* in seconds */
+  uint64_t retry_after_{DEFAULT_RETRY_AFTER};
+};
+
+/* check if a looper's load is over any of the thresholds */
+auto IsOverloaded(const LooperLoad &load, const AdmissionLimits &limits) noexcept -> bool;
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_ADMISSION_H_
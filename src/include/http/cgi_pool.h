@@ -0,0 +1,103 @@
+/**
+ * @file cgi_pool.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the pool of pre-spawned CGI workers
+ * that launch the CGI programs on behalf of the server process
+ */
+
+#ifndef SRC_INCLUDE_HTTP_CGI_POOL_H_
+#define SRC_INCLUDE_HTTP_CGI_POOL_H_
+
+#include <sys/types.h>
+
+#include <functional>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+class Looper;
+}  // namespace TURTLE_SERVER
+
+namespace TURTLE_SERVER::HTTP {
+
+/* number of pre-spawned CGI workers */
+static constexpr int DEFAULT_CGI_WORKERS = 4;
+
+/**
+ * This CgiWorkerPool pre-spawns a few long-lived worker processes, each talking
+ * to the server over its own Unix domain socket pair
+ * A request of program path plus arguments is handed to an idle worker, which
+ * launches the program with its stdout piped back and replies the collected output
+ * The workers are launchers, the CGI program itself is still forked per request
+ * The workers are forked while the server is still small, so the server itself
+ * never forks a process with a large cache, and no temp file is involved
+ * A worker lost midway is retired, and its replacement is forked by a small launcher
+ * process forked first of all, which passes the new socket back over its own socket pair
+ * It should be constructed before any other thread is spawned
+ */
+class CgiWorkerPool {
+ public:
+  explicit CgiWorkerPool(int worker_count = DEFAULT_CGI_WORKERS);
+
+  /* closing the sockets tells the workers to exit, then harvest them */
+  ~CgiWorkerPool();
+
+  NON_COPYABLE_AND_MOVEABLE(CgiWorkerPool);
+
+  /**
+   * Hand the program to an idle worker and return at once, its output is read by a connection
+   * on the looper, and on_complete is later called on the looper's thread with the output,
+   * or with nullopt if the worker is lost meanwhile
+   * The worker is kept busy till the whole output has arrived, or killed along with the program
+   * if it does not arrive within timeout milliseconds
+   * return false at once if no worker is idle, and on_complete is never called then
+   */
+  auto RunAsync(Looper *looper, const std::string &path, const std::vector<std::string> &arguments,
+                std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete, uint64_t timeout)
+      -> bool;
+
+  /* how many workers are alive, including the replacements arrived so far */
+  auto Size() noexcept -> size_t;
+
+ private:
+  struct Worker {
+    pid_t pid_;
+    int fd_;
+  };
+
+  /* put a worker back to idle, or retire it and ask the launcher for a replacement */
+  void Release(size_t index, bool healthy);
+
+  /* take the replacements the launcher has passed back so far, in place of the retired workers, under lock */
+  void CollectReplacements();
+
+  /* the loop of the launcher process, forks a worker per request byte, never returns */
+  [[noreturn]] static void LauncherLoop(int fd);
+
+  /* the loop of a worker process, never returns */
+  [[noreturn]] static void WorkerLoop(int fd);
+
+  std::vector<Worker> workers_;
+  std::vector<size_t> idle_;
+  /* the slots of the retired workers, waiting for their replacements */
+  std::vector<size_t> retired_;
+  /* the processes forked by the server itself, to be harvested at last */
+  std::vector<pid_t> children_;
+  pid_t launcher_pid_{-1};
+  int launcher_fd_{-1};
+  size_t replacing_{0};
+  size_t alive_{0};
+  std::mutex mtx_;
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_CGI_POOL_H_
@@ -5,7 +5,7 @@
  * program on Linux
  * @init_date Jan 13 2022
  *
- * This is a header file implementing the CGIer that fork another process
+ * This is a header file implementing the CGIer that spawns another process
  * to run the cgi program commanded by the client through http request in a
  * RESTful style
  */
@@ -13,30 +13,76 @@
 #ifndef SRC_INCLUDE_HTTP_CGIER_H_
 #define SRC_INCLUDE_HTTP_CGIER_H_
 
+#include <sys/types.h>
+
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "core/utils.h"
 
+namespace TURTLE_SERVER {
+class Looper;
+}  // namespace TURTLE_SERVER
+
 namespace TURTLE_SERVER::HTTP {
 
+class CgiWorkerPool;
+
+/* the results of a cached cgi route, 1 MB by default */
+static constexpr size_t DEFAULT_CGI_CACHE_CAPACITY = 1024 * 1024;
+
+/* a cached cgi result is reused for this long in milliseconds */
+static constexpr uint64_t DEFAULT_CGI_CACHE_TTL = 5000;
+
+/* a cgi program not done within this many milliseconds is killed, and the client told to retry */
+static constexpr uint64_t DEFAULT_CGI_TIMEOUT = 10000;
+
 /**
- * This Cgier runs a client commanded program through traditional 'fork' +
- * 'execve' All the cgi program should reside in a '/cgi-bin' folder in the root
- * directory of the http serving directory parent and child process communicate
- * through a file, where child writes the output to it and parent read it out
- * afterwards
+ * This Cgier runs a client commanded program through 'posix_spawn'
+ * All the cgi program should reside in a '/cgi-bin' folder in the root
+ * directory of the http serving directory. The program's stdout is a pipe
+ * whose read end is either drained right away, or monitored as a connection
+ * on a Looper so that the reactor carries on serving other clients meanwhile
  * */
 class Cgier {
  public:
   static auto ParseCgier(const std::string &resource_url) noexcept -> Cgier;
   static auto MakeInvalidCgier() noexcept -> Cgier;
+  /**
+   * Block SIGCHLD in the calling thread, must be called before any other thread is spawned
+   * the asynchronously run programs are then reaped through a signalfd instead of waitpid() blocking
+   */
+  static void BlockChildSignal();
   explicit Cgier(const std::string &path, const std::vector<std::string> &arguments) noexcept;
+  /* run and block till the program closes its stdout */
   auto Run() -> std::vector<unsigned char>;
+  /**
+   * Spawn the program and return at once, its stdout is collected by a connection on the looper
+   * on_complete is later called on the looper's thread with the output, or with nullopt if the
+   * program is killed for not finishing within timeout milliseconds
+   * return false if the program could not be spawned
+   */
+  auto RunAsync(Looper *looper, std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete,
+                uint64_t timeout = DEFAULT_CGI_TIMEOUT) -> bool;
+  /**
+   * Same as above, but in a pre-spawned worker of the pool, whose reply is read by a connection on the looper
+   * on_complete is also called with nullopt if the worker is lost meanwhile
+   * return false if no worker is idle right now
+   */
+  auto RunAsync(CgiWorkerPool *pool, Looper *looper,
+                std::function<void(std::optional<std::vector<unsigned char>> &&)> on_complete,
+                uint64_t timeout = DEFAULT_CGI_TIMEOUT) -> bool;
   auto IsValid() const noexcept -> bool;
   auto GetPath() const noexcept -> std::string;
+  /* the program path followed by the arguments, which identifies the result of a pure program */
+  auto GetCacheKey() const -> std::string;
 
  private:
+  /* spawn the program with its stdout redirected to a pipe, return the read end or -1 upon failure */
+  auto Spawn(pid_t *pid) -> int;
   auto BuildArgumentList() -> char **;
   void FreeArgumentList(char **arg_list);
   std::string cgi_program_path_;
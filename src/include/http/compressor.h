@@ -0,0 +1,101 @@
+/**
+ * @file compressor.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the Compressor that negotiates the
+ * content coding with client and keeps the compressed variants in the Cache
+ */
+
+#ifndef SRC_INCLUDE_HTTP_COMPRESSOR_H_
+#define SRC_INCLUDE_HTTP_COMPRESSOR_H_
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER {
+class Cache;
+class ThreadPool;
+}  // namespace TURTLE_SERVER
+
+namespace TURTLE_SERVER::HTTP {
+
+/* resources smaller than this in bytes are not worth the compression */
+static constexpr size_t DEFAULT_COMPRESS_THRESHOLD = 1024;
+
+/* number of background threads doing compression for cache misses */
+static constexpr int DEFAULT_COMPRESS_CONCURRENCY = 2;
+
+/* Content coding enum, in the order of preference when the client accepts several */
+enum class Encoding { GZIP, DEFLATE, IDENTITY };
+
+/* the token of an Encoding in Accept-Encoding and Content-Encoding headers */
+auto EncodingToString(Encoding encoding) noexcept -> std::string;
+
+/* the quality value the client assigns to a content coding, 0 if not acceptable */
+auto EncodingQuality(std::string_view accept_encoding, Encoding encoding) noexcept -> double;
+
+/**
+ * Pick the preferred content coding the client accepts, honouring "q=0" exclusions
+ * fall back to identity if nothing is acceptable or the header is absent
+ */
+auto NegotiateEncoding(std::string_view accept_encoding) noexcept -> Encoding;
+
+/* if a MIME type is text-like and benefits from compression */
+auto IsCompressibleMime(std::string_view mime) noexcept -> bool;
+
+/**
+ * Compress the source in gzip or deflate (zlib) format appending to the destination
+ * return false if failed or the encoding is identity
+ */
+auto Compress(const std::vector<unsigned char> &source, Encoding encoding,
+              std::vector<unsigned char> &destination) noexcept -> bool;  // NOLINT
+
+/**
+ * This Compressor stores compressed variants in the Cache alongside the identity version
+ * so that each resource is compressed only once
+ * A cache miss is compressed by a background ThreadPool, so the reactor is never blocked
+ * and serves the identity version meanwhile
+ */
+class Compressor {
+ public:
+  explicit Compressor(std::shared_ptr<Cache> cache, size_t threshold = DEFAULT_COMPRESS_THRESHOLD,
+                      int concurrency = DEFAULT_COMPRESS_CONCURRENCY);
+
+  ~Compressor();
+
+  NON_COPYABLE_AND_MOVEABLE(Compressor);
+
+  /* if a resource of this MIME type and size should be compressed at all */
+  auto ShouldCompress(std::string_view mime, size_t size) const noexcept -> bool;
+
+  /*
+   * Load the compressed variant of the cached resource identified by cache_key
+   * upon miss schedule a background compression of the file at resource_path and return false
+   */
+  auto TryLoad(const std::string &resource_path, const std::string &cache_key, Encoding encoding,
+               std::vector<unsigned char> &destination) -> bool;  // NOLINT
+
+ private:
+  void Schedule(const std::string &resource_path, const std::string &variant_key, const std::string &cache_key,
+                Encoding encoding);
+
+  std::shared_ptr<Cache> cache_;
+  size_t threshold_;
+  std::unique_ptr<ThreadPool> pool_;
+  std::mutex mtx_;
+  /* variants being compressed now, to avoid duplicate work under load */
+  std::unordered_set<std::string> pending_;
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_COMPRESSOR_H_
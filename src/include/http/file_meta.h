@@ -0,0 +1,98 @@
+/**
+ * @file file_meta.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the file metadata cache, which remembers
+ * the stat() result and the derived validators of the static resources
+ */
+
+#ifndef SRC_INCLUDE_HTTP_FILE_META_H_
+#define SRC_INCLUDE_HTTP_FILE_META_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>         // NOLINT
+#include <optional>
+#include <shared_mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "core/utils.h"
+
+namespace TURTLE_SERVER::HTTP {
+
+/* a cached stat() result is trusted for this long in milliseconds before re-stat */
+static constexpr uint64_t DEFAULT_META_REVALIDATE_INTERVAL = 1000;
+
+/* at most this many files are remembered */
+static constexpr size_t DEFAULT_META_CAPACITY = 10000;
+
+/**
+ * The metadata of a single file at the time it was last stat()
+ * Not-existing files are remembered as well to save the repeated probes
+ */
+struct FileMeta {
+  bool exists_{false};
+  size_t size_{0};
+  ino_t inode_{0};
+  time_t mtime_{0};
+  /* strong entity tag "inode-size-mtime" in hex, with the quotes */
+  std::string etag_;
+  /* the mtime in IMF-fixdate */
+  std::string last_modified_;
+  /* when this metadata was taken in milliseconds */
+  uint64_t checked_at_{0};
+  /* the precompressed "<file>.gz" next to it if exists and not older, nullptr otherwise */
+  std::shared_ptr<const FileMeta> gzip_sibling_{nullptr};
+};
+
+/**
+ * An concurrent cache of FileMeta keyed by file path
+ * the returned FileMeta is an immutable snapshot that is safe to hold across threads
+ */
+class FileMetaCache {
+ public:
+  explicit FileMetaCache(uint64_t revalidate_interval = DEFAULT_META_REVALIDATE_INTERVAL,
+                         size_t capacity = DEFAULT_META_CAPACITY) noexcept;
+
+  NON_COPYABLE_AND_MOVEABLE(FileMetaCache);
+
+  /* get the metadata of a file, stat() it only if not remembered or out of date */
+  auto Lookup(const std::string &file_path) -> std::shared_ptr<const FileMeta>;
+
+  auto Size() -> size_t;
+
+  void Clear();
+
+  /* stat() a file and derive its validators, without caching, optionally probe its gzip sibling too */
+  static auto Stat(const std::string &file_path, bool probe_sibling = true) -> std::shared_ptr<const FileMeta>;
+
+ private:
+  std::shared_mutex mtx_;
+  std::unordered_map<std::string, std::shared_ptr<const FileMeta>> mapping_;
+  const uint64_t revalidate_interval_;
+  const size_t capacity_;
+};
+
+/**
+ * Evaluate the If-None-Match and If-Modified-Since preconditions of a GET/HEAD
+ * return true if the client's copy is still fresh and 304 should be replied
+ */
+auto IsNotModified(std::optional<std::string_view> if_none_match, std::optional<std::string_view> if_modified_since,
+                   const FileMeta &meta) -> bool;
+
+/**
+ * Evaluate the If-Range precondition, which is either an entity tag or a date
+ * return true if the requested Range can be served
+ */
+auto IsRangeFresh(std::string_view if_range, const FileMeta &meta) noexcept -> bool;
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_FILE_META_H_
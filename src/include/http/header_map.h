@@ -0,0 +1,89 @@
+/**
+ * @file header_map.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the compact header container of a request,
+ * which views into the raw request instead of owning copies of the headers
+ */
+
+#ifndef SRC_INCLUDE_HTTP_HEADER_MAP_H_
+#define SRC_INCLUDE_HTTP_HEADER_MAP_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace TURTLE_SERVER::HTTP {
+
+/* Well-known header names, interned to integer id at parse time */
+enum class HeaderId : uint8_t {
+  HOST,
+  CONNECTION,
+  CONTENT_LENGTH,
+  CONTENT_TYPE,
+  USER_AGENT,
+  ACCEPT,
+  ACCEPT_ENCODING,
+  ACCEPT_LANGUAGE,
+  RANGE,
+  IF_RANGE,
+  IF_NONE_MATCH,
+  IF_MODIFIED_SINCE,
+  COOKIE,
+  AUTHORIZATION,
+  REFERER,
+  CACHE_CONTROL,
+  UNKNOWN
+};
+
+static constexpr size_t HEADER_ID_COUNT = static_cast<size_t>(HeaderId::UNKNOWN);
+
+/* a typical request has no more headers than this, the rest spill onto heap */
+static constexpr size_t HEADER_MAP_INLINE_CAPACITY = 24;
+
+/* case insensitive, UNKNOWN if not a well-known header */
+auto ToHeaderId(std::string_view name) noexcept -> HeaderId;
+
+/**
+ * A flat container of (name, value) views in the order they appear
+ * The well-known headers are additionally indexed by their HeaderId, so looking them up is O(1)
+ * It never owns the bytes, which must outlive the map
+ */
+class HeaderMap {
+ public:
+  struct Entry {
+    HeaderId id_;
+    std::string_view name_;
+    std::string_view value_;
+  };
+
+  /* keep the first one if a header name repeats */
+  void Add(std::string_view name, std::string_view value);
+
+  auto Get(HeaderId id) const noexcept -> std::optional<std::string_view>;
+
+  /* case insensitive, O(1) for the well-known names and a linear scan otherwise */
+  auto Get(std::string_view name) const noexcept -> std::optional<std::string_view>;
+
+  auto Size() const noexcept -> size_t;
+
+  auto At(size_t index) const noexcept -> const Entry &;
+
+  void Clear() noexcept;
+
+ private:
+  std::array<Entry, HEADER_MAP_INLINE_CAPACITY> entries_{};
+  std::vector<Entry> spilled_entries_;
+  size_t size_{0};
+  /* position + 1 of each well-known header, 0 if absent */
+  std::array<uint16_t, HEADER_ID_COUNT> index_{};
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_HEADER_MAP_H_
@@ -12,49 +12,111 @@
 #ifndef SRC_INCLUDE_HTTP_HTTP_UTILS_H_
 #define SRC_INCLUDE_HTTP_HTTP_UTILS_H_
 
+#include <array>
+#include <cstdint>
+#include <ctime>
 #include <map>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TURTLE_SERVER::HTTP {
 
-static constexpr int READ_WRITE_PERMISSION = 0600;
+/* the literals joined at compile time, the terminating NUL included */
+template <const char *...Parts>
+constexpr auto JoinLiterals() noexcept {
+  std::array<char, (std::char_traits<char>::length(Parts) + ... + 0) + 1> joined{};
+  size_t pos = 0;
+  for (const char *part : {Parts...}) {
+    for (; *part != '\0'; part++) {
+      joined[pos++] = *part;
+    }
+  }
+  return joined;
+}
+
+template <const char *...Parts>
+inline constexpr auto JOINED_LITERAL_STORAGE = JoinLiterals<Parts...>();
+
+/* a static string built from the shared constants, so that it never drifts from them */
+template <const char *...Parts>
+inline constexpr std::string_view JOINED_LITERAL{JOINED_LITERAL_STORAGE<Parts...>.data(),
+                                                 JOINED_LITERAL_STORAGE<Parts...>.size() - 1};
+
+/* length of an IMF-fixdate such as "Sun, 06 Nov 1994 08:49:37 GMT" */
+static constexpr size_t HTTP_DATE_LEN = 29;
 
 static constexpr char PARAMETER_SEPARATOR[] = {"&"};
-static constexpr char UNDERSCORE[] = {"_"};
 static constexpr char SPACE[] = {" "};
 static constexpr char DOT[] = {"."};
 static constexpr char CRLF[] = {"\r\n"};
 static constexpr char COLON[] = {":"};
+static constexpr char SEMICOLON[] = {";"};
 static constexpr char DEFAULT_ROUTE[] = {"index.html"};
 static constexpr char CGI_BIN[] = {"cgi-bin"};
-static constexpr char CGI_PREFIX[] = {"cgi_temp"};
+static constexpr char GZIP_SUFFIX[] = {".gz"};
+static constexpr char DEFAULT_METRICS_PATH[] = {"/metrics"};
 
 /* Common Header and Value */
 static constexpr char HEADER_SERVER[] = {"Server"};
 static constexpr char SERVER_TURTLE[] = {"Turtle/1.0"};
 static constexpr char HEADER_CONTENT_LENGTH[] = {"Content-Length"};
 static constexpr char HEADER_CONTENT_TYPE[] = {"Content-Type"};
-static constexpr char CONTENT_LENGTH_ZERO[] = {"0"};
 static constexpr char HEADER_CONNECTION[] = {"Connection"};
 static constexpr char CONNECTION_CLOSE[] = {"Close"};
 static constexpr char CONNECTION_KEEP_ALIVE[] = {"Keep-Alive"};
-static constexpr char HTTP_VERSION_TURTLE[] = {"HTTP/1.1"};
+static constexpr char HEADER_ACCEPT_RANGES[] = {"Accept-Ranges"};
+static constexpr char HEADER_CONTENT_RANGE[] = {"Content-Range"};
+static constexpr char RANGE_UNIT_BYTES[] = {"bytes"};
+static constexpr char HEADER_ETAG[] = {"ETag"};
+static constexpr char HEADER_LAST_MODIFIED[] = {"Last-Modified"};
+static constexpr char HEADER_ACCEPT_ENCODING[] = {"Accept-Encoding"};
+static constexpr char HEADER_CONTENT_ENCODING[] = {"Content-Encoding"};
+static constexpr char HEADER_VARY[] = {"Vary"};
+static constexpr char HEADER_RETRY_AFTER[] = {"Retry-After"};
+static constexpr char HEADER_CACHE_CONTROL[] = {"Cache-Control"};
+static constexpr char CACHE_CONTROL_NO_STORE[] = {"no-store"};
+static constexpr char ENCODING_GZIP[] = {"gzip"};
+static constexpr char ENCODING_DEFLATE[] = {"deflate"};
+static constexpr char ENCODING_IDENTITY[] = {"identity"};
+static constexpr char MULTIPART_BOUNDARY[] = {"TURTLE_BYTERANGES_BOUNDARY"};
 
 /* MIME Types */
-static constexpr char MIME_HTML[] = {"text/html"};
-static constexpr char MIME_CSS[] = {"text/css"};
-static constexpr char MIME_PNG[] = {"image/png"};
-static constexpr char MIME_JPG[] = {"image/jpg"};
-static constexpr char MIME_JPEG[] = {"image/jpeg"};
-static constexpr char MIME_GIF[] = {"image/gif"};
 static constexpr char MIME_OCTET[] = {"application/octet-stream"};
-
-/* Response status */
-static constexpr char RESPONSE_OK[] = {"200 OK"};
-static constexpr char RESPONSE_BAD_REQUEST[] = {"400 Bad Request"};
-static constexpr char RESPONSE_NOT_FOUND[] = {"404 Not Found"};
-static constexpr char RESPONSE_SERVICE_UNAVAILABLE[] = {"503 Service Unavailable"};
+static constexpr char MIME_MULTIPART_BYTERANGES_PREFIX[] = {"multipart/byteranges; boundary="};
+static constexpr std::string_view MIME_MULTIPART_BYTERANGES =
+    JOINED_LITERAL<MIME_MULTIPART_BYTERANGES_PREFIX, MULTIPART_BOUNDARY>;
+static constexpr char MIME_PROMETHEUS_TEXT[] = {"text/plain; version=0.0.4; charset=utf-8"};
+
+/* Response status enum, only the ones the server replies with */
+enum class Status {
+  OK,
+  PARTIAL_CONTENT,
+  NOT_MODIFIED,
+  BAD_REQUEST,
+  NOT_FOUND,
+  URI_TOO_LONG,
+  RANGE_NOT_SATISFIABLE,
+  TOO_MANY_REQUESTS,
+  REQUEST_HEADER_FIELDS_TOO_LARGE,
+  SERVICE_UNAVAILABLE
+};
+
+/* pre-formatted status line of each Status, in the enum order */
+static constexpr std::array<std::string_view, 10> STATUS_LINE{"HTTP/1.1 200 OK\r\n",
+                                                             "HTTP/1.1 206 Partial Content\r\n",
+                                                             "HTTP/1.1 304 Not Modified\r\n",
+                                                             "HTTP/1.1 400 Bad Request\r\n",
+                                                             "HTTP/1.1 404 Not Found\r\n",
+                                                             "HTTP/1.1 414 URI Too Long\r\n",
+                                                             "HTTP/1.1 416 Range Not Satisfiable\r\n",
+                                                             "HTTP/1.1 429 Too Many Requests\r\n",
+                                                             "HTTP/1.1 431 Request Header Fields Too Large\r\n",
+                                                             "HTTP/1.1 503 Service Unavailable\r\n"};
+
+/* numeric code of each Status, in the enum order */
+static constexpr std::array<uint16_t, 10> STATUS_CODE{200, 206, 304, 400, 404, 414, 416, 429, 431, 503};
 
 /* HTTP Method enum, only support GET/HEAD method now */
 enum class Method { GET, HEAD, UNSUPPORTED };
@@ -62,30 +124,23 @@ enum class Method { GET, HEAD, UNSUPPORTED };
 /* HTTP version enum, only support HTTP 1.1 now */
 enum class Version { HTTP_1_1, UNSUPPORTED };
 
-/* Content Extension enum */
-enum class Extension { HTML, CSS, PNG, JPG, JPEG, GIF, OCTET };
-
 static const std::map<Method, std::string> METHOD_TO_STRING{
     {Method::GET, "GET"}, {Method::HEAD, "HEAD"}, {Method::UNSUPPORTED, "UNSUPPORTED"}};
 
 static const std::map<Version, std::string> VERSION_TO_STRING{{Version::HTTP_1_1, "HTTP/1.1"},
                                                               {Version::UNSUPPORTED, "UNSUPPORTED"}};
 
-static const std::map<Extension, std::string> EXTENSION_TO_STRING{
-    {Extension::HTML, "HTML"}, {Extension::CSS, "CSS"}, {Extension::PNG, "PNG"},    {Extension::JPG, "JPG"},
-    {Extension::JPEG, "JPEG"}, {Extension::GIF, "GIF"}, {Extension::OCTET, "OCTET"}};
-
 /* space and case insensitive */
-auto ToMethod(const std::string &method_str) noexcept -> Method;
+auto ToMethod(std::string_view method_str) noexcept -> Method;
 
 /* space and case insensitive */
-auto ToVersion(const std::string &version_str) noexcept -> Version;
+auto ToVersion(std::string_view version_str) noexcept -> Version;
 
-/* space and case insensitive */
-auto ToExtension(const std::string &extension_str) noexcept -> Extension;
+/* space and case insensitive, octet-stream for the unknown extensions */
+auto ExtensionToMime(std::string_view extension) noexcept -> std::string_view;
 
-/* space and case insensitive */
-auto ExtensionToMime(const Extension &extension) noexcept -> std::string;
+/* parse out the extension of a resource url and map to its MIME type */
+auto ToMime(std::string_view resource_url) noexcept -> std::string_view;
 
 /**
  * split a string into many sub strings, splitted by the specified delimiter
@@ -139,6 +194,22 @@ auto DeleteFile(const std::string &file_path) noexcept -> bool;
  */
 auto CheckFileSize(const std::string &file_path) noexcept -> size_t;
 
+/**
+ * Format a timestamp in seconds since epoch into IMF-fixdate, i.e. "Sun, 06 Nov 1994 08:49:37 GMT"
+ */
+auto ToHttpDate(time_t timestamp) noexcept -> std::string;
+
+/**
+ * The current time in IMF-fixdate for the Date header
+ * formatted at most once per second per thread, i.e. per Looper
+ */
+auto CurrentHttpDate() noexcept -> std::string_view;
+
+/**
+ * Parse an IMF-fixdate back into seconds since epoch, nullopt if malformed
+ */
+auto ParseHttpDate(const std::string &http_date) noexcept -> std::optional<time_t>;
+
 /**
  * Load the file appending to be back of a vector of unsigned char
  * able to contain binary data
@@ -0,0 +1,118 @@
+/**
+ * @file lookup_table.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the compile-time perfect hash table
+ * for the case insensitive string lookups on the per-request path
+ */
+
+#ifndef SRC_INCLUDE_HTTP_LOOKUP_TABLE_H_
+#define SRC_INCLUDE_HTTP_LOOKUP_TABLE_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace TURTLE_SERVER::HTTP {
+
+/* give up searching for a collision-free seed after this many trials */
+static constexpr uint32_t PERFECT_HASH_MAX_TRIALS = 10000;
+
+constexpr auto ToLowerAscii(char c) noexcept -> char { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+constexpr auto CaseInsensitiveEqual(std::string_view lhs, std::string_view rhs) noexcept -> bool {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (ToLowerAscii(lhs[i]) != ToLowerAscii(rhs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* seeded FNV-1a over the lower-cased bytes */
+constexpr auto CaseInsensitiveHash(std::string_view key, uint32_t seed) noexcept -> uint32_t {
+  uint32_t hash = 2166136261U ^ seed;
+  for (char c : key) {
+    hash = (hash ^ static_cast<unsigned char>(ToLowerAscii(c))) * 16777619U;
+  }
+  return hash ^ (hash >> 15);
+}
+
+/* the smallest power of two no less than n */
+constexpr auto NextPowerOfTwo(size_t n) noexcept -> size_t {
+  size_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+/**
+ * A read-only hash table from case insensitive string keys to values, built at compile time
+ * The seed is searched until no two keys share a bucket, so a lookup is one hash,
+ * one probe and one comparison, without any allocation
+ * There are 8 buckets per key to keep the search short
+ */
+template <typename Value, size_t N>
+class PerfectHashTable {
+ public:
+  using Entry = std::pair<std::string_view, Value>;
+
+  static constexpr size_t BUCKETS = NextPowerOfTwo(N * 8);
+
+  constexpr explicit PerfectHashTable(const std::array<Entry, N> &entries) noexcept : entries_(entries) {
+    for (uint32_t seed = 0; seed < PERFECT_HASH_MAX_TRIALS; seed++) {
+      if (TryBuild(seed)) {
+        seed_ = seed;
+        perfect_ = true;
+        return;
+      }
+    }
+  }
+
+  /* if a collision-free seed is found, to be static_assert-ed */
+  constexpr auto IsPerfect() const noexcept -> bool { return perfect_; }
+
+  constexpr auto Find(std::string_view key) const noexcept -> std::optional<Value> {
+    auto slot = slots_[CaseInsensitiveHash(key, seed_) & (BUCKETS - 1)];
+    if (slot != EMPTY_SLOT && CaseInsensitiveEqual(entries_[slot - 1].first, key)) {
+      return entries_[slot - 1].second;
+    }
+    return std::nullopt;
+  }
+
+ private:
+  /* slots store the entry index plus one, 0 for empty */
+  static constexpr uint16_t EMPTY_SLOT = 0;
+
+  constexpr auto TryBuild(uint32_t seed) noexcept -> bool {
+    for (auto &slot : slots_) {
+      slot = EMPTY_SLOT;
+    }
+    for (size_t i = 0; i < N; i++) {
+      auto &slot = slots_[CaseInsensitiveHash(entries_[i].first, seed) & (BUCKETS - 1)];
+      if (slot != EMPTY_SLOT) {
+        return false;
+      }
+      slot = static_cast<uint16_t>(i + 1);
+    }
+    return true;
+  }
+
+  std::array<Entry, N> entries_;
+  std::array<uint16_t, BUCKETS> slots_{};
+  uint32_t seed_{0};
+  bool perfect_{false};
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_LOOKUP_TABLE_H_
@@ -0,0 +1,70 @@
+/**
+ * @file range.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the HTTP byte Range, which parses the
+ * 'Range' request header into a set of byte slices of the requested resource
+ */
+
+#ifndef SRC_INCLUDE_HTTP_RANGE_H_
+#define SRC_INCLUDE_HTTP_RANGE_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TURTLE_SERVER::HTTP {
+
+/* more slices than this in one request is treated as abuse and the Range is ignored */
+static constexpr size_t MAX_RANGE_SLICES = 16;
+
+/**
+ * One inclusive slice [first, last] of a resource in bytes
+ */
+struct ByteRange {
+  size_t first_;
+  size_t last_;
+  auto Length() const noexcept -> size_t { return last_ - first_ + 1; }
+};
+
+/* how a 'Range' header applies to a resource of known size */
+enum class RangeStatus { IGNORED, SATISFIABLE, UNSATISFIABLE };
+
+/**
+ * The HTTP byte Range in the form of "bytes=0-99,200-,-50"
+ * Overlapping or adjacent slices are coalesced in ascending order
+ * A malformed header is IGNORED so that the full resource is served instead
+ */
+class Range {
+ public:
+  static auto ParseRange(const std::string &range_header, size_t resource_size) -> Range;
+
+  auto GetStatus() const noexcept -> RangeStatus;
+  auto GetSlices() const noexcept -> const std::vector<ByteRange> &;
+  auto IsMultipart() const noexcept -> bool;
+
+  /* the value of 'Content-Range' for a slice */
+  auto ContentRange(const ByteRange &slice) const -> std::string;
+  /* the value of 'Content-Range' for the 416 response */
+  auto UnsatisfiedContentRange() const -> std::string;
+
+  /* the delimiter and headers before the i-th part in a multipart/byteranges body */
+  auto PartHeader(size_t index, std::string_view mime) const -> std::string;
+  /* the closing delimiter of a multipart/byteranges body */
+  auto PartTrailer() const -> std::string;
+  /* total body length of a multipart/byteranges response */
+  auto MultipartLength(std::string_view mime) const -> size_t;
+
+ private:
+  Range(RangeStatus status, size_t resource_size, std::vector<ByteRange> slices) noexcept;
+  RangeStatus status_;
+  size_t resource_size_;
+  std::vector<ByteRange> slices_;
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_RANGE_H_
@@ -10,44 +10,85 @@
 
 #ifndef SRC_INCLUDE_HTTP_REQUEST_H_
 #define SRC_INCLUDE_HTTP_REQUEST_H_
+#include <cstdint>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/utils.h"
+#include "http/header_map.h"
 namespace TURTLE_SERVER::HTTP {
 
 class Header;
 enum class Method;
 enum class Version;
+enum class Status;
+
+/* default limits on a request head in bytes */
+static constexpr size_t DEFAULT_MAX_REQUEST_LINE = 8 * 1024;
+static constexpr size_t DEFAULT_MAX_HEADER_BYTES = 16 * 1024;
+static constexpr size_t DEFAULT_MAX_HEADER_COUNT = 100;
+
+/* by default a request head must arrive completely within this many milliseconds since it starts */
+static constexpr uint64_t DEFAULT_HEADER_TIMEOUT = 10000;
+
+/**
+ * The limits on a request head, which bound how much memory and time a client could hold
+ * a client exceeding them is replied 414 or 431 and disconnected
+ */
+struct RequestLimits {
+  size_t max_request_line_{DEFAULT_MAX_REQUEST_LINE};
+  size_t max_header_bytes_{DEFAULT_MAX_HEADER_BYTES};
+  size_t max_header_count_{DEFAULT_MAX_HEADER_COUNT};
+  /* 0 disables the header-read deadline, which is independent of the keep-alive idle timer */
+  uint64_t header_timeout_{DEFAULT_HEADER_TIMEOUT};
+};
+
+/**
+ * Check a request head against the limits, either complete or still arriving
+ * return URI_TOO_LONG or REQUEST_HEADER_FIELDS_TOO_LARGE if exceeded, nullopt otherwise
+ */
+auto CheckRequestLimits(std::string_view head, const RequestLimits &limits) noexcept -> std::optional<Status>;
 
 /**
  * The (limited GET/HEAD-only HTTP 1.1) HTTP Request class
  * it contains necessary request line features including method, resource url,
  * http version and since we supports http 1.1, it also cares if the client
  * connection should be kept alive
+ * It owns the raw request, and the headers are views into it
  */
 class Request {
  public:
   Request(Method method, Version version, std::string resource_url, const std::vector<Header> &headers) noexcept;
-  explicit Request(const std::string &request_str) noexcept;  // deserialize method
-  NON_COPYABLE(Request);
+  explicit Request(std::string request_str) noexcept;  // deserialize method
+  /* the header views point into the raw request, which must stay in place */
+  NON_COPYABLE_AND_MOVEABLE(Request);
   auto IsValid() const noexcept -> bool;
   auto ShouldClose() const noexcept -> bool;
   auto GetInvalidReason() const noexcept -> std::string;
   auto GetMethod() const noexcept -> Method;
   auto GetVersion() const noexcept -> Version;
-  auto GetResourceUrl() const noexcept -> std::string;
+  auto GetResourceUrl() const noexcept -> const std::string &;
+  /* materialize a copy of all the headers, for inspection only */
   auto GetHeaders() const noexcept -> std::vector<Header>;
+  auto GetHeaderMap() const noexcept -> const HeaderMap &;
+  /* O(1) lookup of a well-known header's trimmed value */
+  auto GetHeader(HeaderId id) const noexcept -> std::optional<std::string_view>;
+  /* case insensitive lookup of a header's trimmed value by its key */
+  auto GetHeader(std::string_view key) const noexcept -> std::optional<std::string_view>;
   friend auto operator<<(std::ostream &os, const Request &request) -> std::ostream &;
 
  private:
-  auto ParseRequestLine(const std::string &request_line) -> bool;
-  void ScanHeader(const Header &header);
+  void Parse() noexcept;
+  auto ParseRequestLine(std::string_view request_line) -> bool;
+  void ScanHeaders();
   Method method_;
   Version version_;
   std::string resource_url_;
-  std::vector<Header> headers_;
+  std::string raw_;
+  HeaderMap headers_;
   bool should_close_{true};
   bool is_valid_{false};
   std::string invalid_reason_;
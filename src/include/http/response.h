@@ -11,44 +11,99 @@
 #ifndef SRC_INCLUDE_HTTP_RESPONSE_H_
 #define SRC_INCLUDE_HTTP_RESPONSE_H_
 
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "http/http_utils.h"
+
+namespace TURTLE_SERVER {
+class Buffer;
+class Connection;
+}  // namespace TURTLE_SERVER
+
 namespace TURTLE_SERVER::HTTP {
 
 class Header;
 
+/* inline storage for the less common headers, beyond which they spill onto heap */
+static constexpr size_t RESPONSE_HEADER_CAPACITY = 256;
+
 /**
  * The HTTP Response class
- * use vector of char to be able to contain binary data
+ * The status line and the common headers are emitted from pre-formatted fragments
+ * and the rest are kept serialized already, so the emission is a few memcpy
  */
 class Response {
  public:
   /* 200 OK response */
   static auto Make200Response(bool should_close, std::optional<std::string> resource_url) -> Response;
+  /* 304 Not Modified response, no body and hence no Content-Length */
+  static auto Make304Response(bool should_close) noexcept -> Response;
   /* 400 Bad Request response, close connection */
   static auto Make400Response() noexcept -> Response;
   /* 404 Not Found response, close connection */
   static auto Make404Response() noexcept -> Response;
+  /* 414 URI Too Long response, close connection */
+  static auto Make414Response() noexcept -> Response;
+  /* 416 Range Not Satisfiable response, carries the unsatisfied Content-Range */
+  static auto Make416Response(bool should_close, const std::string &content_range) -> Response;
+  /* 429 Too Many Requests response asking to retry after some seconds, close connection */
+  static auto Make429Response(uint64_t retry_after) -> Response;
+  /* 431 Request Header Fields Too Large response, close connection */
+  static auto Make431Response() noexcept -> Response;
   /* 503 Service Unavailable response, close connection */
   static auto Make503Response() noexcept -> Response;
+  /* 503 Service Unavailable response asking to retry after some seconds, close connection */
+  static auto Make503Response(uint64_t retry_after) -> Response;
 
-  Response(const std::string &status_code, bool should_close, std::optional<std::string> resource_url);
+  /* stat() the resource if specified to fill in its length and type */
+  Response(Status status, bool should_close, std::optional<std::string> resource_url);
+
+  /* a resource whose MIME type and size are already known, no stat(), the MIME type a static string */
+  Response(Status status, bool should_close, std::string_view mime, size_t size);
 
   /* no content, content should separately be loaded */
-  void Serialize(std::vector<unsigned char> &buffer);  // NOLINT
+  void Serialize(std::vector<unsigned char> &buffer) const;  // NOLINT
+
+  /* no content, emitted directly at the back of e.g. a connection's write Buffer */
+  void Serialize(Buffer &buffer) const;  // NOLINT
+
+  /* emitted at the back of the connection's write Buffer, its status noted there for the metrics and access log */
+  void Serialize(Connection *client_conn) const;
 
-  auto GetHeaders() -> std::vector<Header>;
+  /* materialize all the headers, for inspection only */
+  auto GetHeaders() const -> std::vector<Header>;
 
-  auto ChangeHeader(const std::string &key, const std::string &new_value) noexcept -> bool;
+  void SetContentLength(size_t content_length) noexcept;
+
+  /* a static string, i.e. from the MIME table, which is referred to rather than copied */
+  void SetContentType(std::string_view content_type) noexcept;
+
+  void AddHeader(std::string_view key, std::string_view value);
+
+  auto ChangeHeader(const std::string &key, const std::string &new_value) -> bool;
 
  private:
-  std::string status_line_;
+  template <typename Sink>
+  void Emit(Sink &&sink) const;
+
+  auto ExtraHeaders() const noexcept -> std::pair<std::string_view, std::string_view>;
+
+  Status status_;
   bool should_close_;
-  std::vector<Header> headers_;
-  std::optional<std::string> resource_url_;
-  std::vector<unsigned char> body_;
+  bool accept_ranges_{false};
+  std::optional<size_t> content_length_{0};
+  /* always one of the static MIME strings, so that emitting the head never allocates for it */
+  std::string_view content_type_;
+  /* the less common headers already in "key: value\r\n" form, inline first then spilled */
+  std::array<char, RESPONSE_HEADER_CAPACITY> extra_headers_{};
+  size_t extra_headers_len_{0};
+  std::string extra_headers_spill_;
 };
 
 }  // namespace TURTLE_SERVER::HTTP
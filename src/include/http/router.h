@@ -0,0 +1,119 @@
+/**
+ * @file router.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the Router that dispatches a request
+ * to its handler by the method and the resource url path
+ */
+
+#ifndef SRC_INCLUDE_HTTP_ROUTER_H_
+#define SRC_INCLUDE_HTTP_ROUTER_H_
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/utils.h"
+#include "http/http_utils.h"
+
+namespace TURTLE_SERVER {
+class Connection;
+}  // namespace TURTLE_SERVER
+
+namespace TURTLE_SERVER::HTTP {
+
+class Request;
+
+/* at most this many path parameters in one route pattern */
+static constexpr size_t MAX_ROUTE_PARAMS = 8;
+
+/* the name of the parameter capturing the rest of the path below a mount point */
+static constexpr char MOUNT_PARAM[] = {"path"};
+
+/* the number of methods a route could be registered for */
+static constexpr size_t METHOD_COUNT = static_cast<size_t>(Method::UNSUPPORTED);
+
+/**
+ * The parameters captured when matching a route, i.e. ":id" or "*path"
+ * both the names and the values are views into the Router and the resource url respectively
+ */
+class RouteParams {
+ public:
+  auto Get(std::string_view name) const noexcept -> std::optional<std::string_view>;
+
+  auto Size() const noexcept -> size_t;
+
+  void Push(std::string_view name, std::string_view value) noexcept;
+
+  void Pop() noexcept;
+
+ private:
+  std::array<std::pair<std::string_view, std::string_view>, MAX_ROUTE_PARAMS> params_{};
+  size_t size_{0};
+};
+
+/**
+ * A handler writes its response into the client connection
+ * return true if the connection should be closed afterwards
+ */
+using RouteHandler = std::function<bool(const Request &, const RouteParams &, Connection *)>;
+
+/**
+ * The Router matches the path of a request against the registered route patterns
+ * A pattern consists of static text, ":name" which captures one path segment
+ * and a trailing "*name" which captures the rest of the path
+ * Routes are kept in a compressed radix trie built once at startup, so matching
+ * walks the path once without any allocation
+ * Upon overlap a static segment wins over a parameter, which wins over the wildcard
+ */
+class Router {
+ public:
+  Router();
+
+  ~Router();
+
+  NON_COPYABLE(Router);
+
+  auto Get(const std::string &pattern, RouteHandler handler) -> Router &;
+
+  auto Head(const std::string &pattern, RouteHandler handler) -> Router &;
+
+  /* register for both GET and HEAD */
+  auto Any(const std::string &pattern, RouteHandler handler) -> Router &;
+
+  /* serve every path below the prefix, the rest of the path is captured as MOUNT_PARAM */
+  auto Mount(const std::string &prefix, RouteHandler handler) -> Router &;
+
+  auto Handle(Method method, const std::string &pattern, RouteHandler handler) -> Router &;
+
+  /* find the handler of a path, ignoring the query string, nullptr if no match */
+  auto Match(Method method, std::string_view path, RouteParams &params) const noexcept  // NOLINT
+      -> const RouteHandler *;
+
+  /**
+   * Dispatch a valid request to its handler, or reply 404 if no route matches
+   * return true if the connection should be closed afterwards
+   */
+  auto Dispatch(const Request &request, Connection *client_conn) const -> bool;
+
+ private:
+  struct Node;
+
+  /* depth-first, backtrack if the more specific branch leads to no handler */
+  static auto MatchNode(const Node *node, std::string_view path, size_t method, RouteParams &params) noexcept  // NOLINT
+      -> const RouteHandler *;
+
+  std::unique_ptr<Node> root_;
+};
+
+}  // namespace TURTLE_SERVER::HTTP
+
+#endif  // SRC_INCLUDE_HTTP_ROUTER_H_
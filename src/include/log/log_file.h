@@ -0,0 +1,105 @@
+/**
+ * @file log_file.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file implementing the rotating log file
+ * written by the backend thread of the Logger
+ */
+
+#ifndef SRC_INCLUDE_LOG_LOG_FILE_H_
+#define SRC_INCLUDE_LOG_LOG_FILE_H_
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/utils.h"
+#include "log/log_record.h"
+
+namespace TURTLE_SERVER {
+
+/* log file name prefix, followed by the creation time and the suffix of either mode */
+const std::string LOG_PATH = std::string("TurtleLog");       // NOLINT
+const std::string LOG_TEXT_SUFFIX = std::string(".log");    // NOLINT
+const std::string LOG_BINARY_SUFFIX = std::string(".bin");  // NOLINT
+
+/* rotation and batching defaults, at most DEFAULT_LOG_RETAINED_FILES * DEFAULT_LOG_ROTATE_SIZE on disk */
+constexpr size_t DEFAULT_LOG_ROTATE_SIZE = 64 * 1024 * 1024;
+constexpr std::chrono::seconds DEFAULT_LOG_ROTATE_INTERVAL = std::chrono::hours(24);
+constexpr size_t DEFAULT_LOG_RETAINED_FILES = 8;
+constexpr size_t DEFAULT_LOG_WRITE_SIZE = 256 * 1024;
+constexpr std::chrono::milliseconds DEFAULT_LOG_FLUSH_INTERVAL = std::chrono::milliseconds(1000);
+
+struct LogFileOptions {
+  /* the path prefix of the files */
+  std::string path_{LOG_PATH};
+  /* a file is rotated once it would grow beyond this size, or has been written for this long */
+  size_t rotate_size_{DEFAULT_LOG_ROTATE_SIZE};
+  std::chrono::seconds rotate_interval_{DEFAULT_LOG_ROTATE_INTERVAL};
+  /* the oldest files with the same prefix and suffix are deleted beyond this many, this run's or not */
+  size_t retained_files_{DEFAULT_LOG_RETAINED_FILES};
+  /* the logs are written in batches of this size at offsets aligned to it, a multiple of the page size */
+  size_t write_size_{DEFAULT_LOG_WRITE_SIZE};
+  /* a partial batch is written once it has been pending for this long */
+  std::chrono::milliseconds flush_interval_{DEFAULT_LOG_FLUSH_INTERVAL};
+};
+
+/**
+ * This LogFile stages the logs and writes them out in large batches, so that
+ * the write syscall rate is bounded by the batch size and the flush interval
+ * instead of following each round of the Logger's writer thread
+ * Each file is preallocated to the rotation size where supported, and trimmed
+ * to what is written once rotated, so that the disk usage is predictable
+ * A file could start with a header, i.e. the format strings of the binary log,
+ * so that each file is readable on its own after rotation
+ * It is only ever touched by the writer thread
+ */
+class LogFile {
+ public:
+  LogFile(std::string suffix, std::function<void(LogBlock &)> header, LogFileOptions options = {});
+
+  /* write out whatever is staged and trim the file */
+  ~LogFile();
+
+  NON_COPYABLE_AND_MOVEABLE(LogFile);
+
+  /* stage the blocks, then write out the full batches, and the partial one if stale */
+  void Write(const std::vector<LogBlock> &blocks);
+
+  /* write out the partial batch as well, to be rewritten in full later at the same aligned offset */
+  void Flush();
+
+  /* the files retained from the oldest, the last one being written */
+  auto GetFiles() const noexcept -> const std::deque<std::string> &;
+
+ private:
+  void Open(std::chrono::steady_clock::time_point now);
+
+  void Close();
+
+  /* write to the file at offset, the bytes that cannot be written are dropped */
+  void WriteAt(const char *data, size_t size, size_t offset) noexcept;
+
+  std::string suffix_;
+  std::function<void(LogBlock &)> header_;
+  LogFileOptions options_;
+  std::deque<std::string> files_;
+  int fd_{-1};
+  uint32_t sequence_{0};
+  std::chrono::steady_clock::time_point opened_at_;
+  /* the file offset of the staged logs, always a multiple of the write size */
+  size_t offset_{0};
+  LogBlock staged_;
+  bool pending_{false};
+  std::chrono::steady_clock::time_point pending_since_;
+};
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_LOG_LOG_FILE_H_
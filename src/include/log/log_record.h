@@ -0,0 +1,177 @@
+/**
+ * @file log_record.h
+ * @author Yukun J
+ * @expectation this header file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is a header file for the raw layout of a log record and the binary log file,
+ * shared by the Logger that encodes the records and the renderers that format them
+ * into text or JSON, either on the writer thread or offline
+ */
+
+#ifndef SRC_INCLUDE_LOG_LOG_RECORD_H_
+#define SRC_INCLUDE_LOG_LOG_RECORD_H_
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace TURTLE_SERVER {
+
+enum class LogLevel { INFO, WARNING, ERROR, FATAL };
+
+/* a block of log records or of rendered logs */
+using LogBlock = std::vector<char>;
+
+/* a registered format string and where it is logged, its id is the index of registration */
+struct LogFormat {
+  std::string fmt_;
+  std::string file_;
+  uint32_t line_{0};
+};
+
+/* the type tag leading each encoded argument */
+enum class LogArgTag : uint8_t { INT, UINT, DOUBLE, BOOL, CHAR, STRING };
+
+/*
+ * a record is [u32 total size][u32 format id][i64 timestamp in microseconds][u8 level]
+ * followed by the encoded arguments, all in host byte order
+ */
+constexpr size_t LOG_RECORD_HEAD_SIZE = 2 * sizeof(uint32_t) + sizeof(int64_t) + sizeof(uint8_t);
+
+/*
+ * a binary log file is the magic followed by frames, each led by its LogFrame kind
+ * FORMAT: [u32 format id][u32 line][u32 size][file][u32 size][format string]
+ * RECORDS: [u32 size][records]
+ * a format is always framed before the first record referring to it
+ */
+constexpr char LOG_BINARY_MAGIC[] = {"TURTLOG1"};
+constexpr size_t LOG_BINARY_MAGIC_SIZE = sizeof(LOG_BINARY_MAGIC) - 1;
+
+enum class LogFrame : uint8_t { FORMAT = 'F', RECORDS = 'R' };
+
+/* one log per line, either plain text or a JSON object */
+enum class LogRenderMode { TEXT, JSON };
+
+/* the encoded size of an argument, which could be an integer, floating point, bool, char or string */
+template <typename T>
+auto LogArgSize(const T &arg) noexcept -> size_t {
+  if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+    return sizeof(LogArgTag) + sizeof(char);
+  } else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {  // NOLINT(readability/braces)
+    return sizeof(LogArgTag) + sizeof(uint64_t);
+  } else {
+    static_assert(std::is_convertible_v<const T &, std::string_view>, "unsupported type of log argument");
+    return sizeof(LogArgTag) + sizeof(uint32_t) + std::string_view(arg).size();
+  }
+}
+
+/* encode an argument at out, return the position right after it */
+template <typename T>
+auto EncodeLogArg(char *out, const T &arg) noexcept -> char * {
+  auto put = [&out](LogArgTag tag, const void *data, size_t size) {
+    *out++ = static_cast<char>(tag);
+    memcpy(out, data, size);
+    out += size;
+  };
+  if constexpr (std::is_same_v<T, bool>) {
+    char value = arg ? 1 : 0;
+    put(LogArgTag::BOOL, &value, sizeof(value));
+  } else if constexpr (std::is_same_v<T, char>) {
+    put(LogArgTag::CHAR, &arg, sizeof(arg));
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {  // NOLINT(readability/braces)
+    auto value = static_cast<int64_t>(arg);
+    put(LogArgTag::INT, &value, sizeof(value));
+  } else if constexpr (std::is_integral_v<T>) {  // NOLINT(readability/braces)
+    auto value = static_cast<uint64_t>(arg);
+    put(LogArgTag::UINT, &value, sizeof(value));
+  } else if constexpr (std::is_floating_point_v<T>) {  // NOLINT(readability/braces)
+    auto value = static_cast<double>(arg);
+    put(LogArgTag::DOUBLE, &value, sizeof(value));
+  } else {
+    std::string_view value(arg);
+    auto size = static_cast<uint32_t>(value.size());
+    put(LogArgTag::STRING, &size, sizeof(size));
+    memcpy(out, value.data(), size);
+    out += size;
+  }
+  return out;
+}
+
+/* encode the head of a record at out, return the position of its first argument */
+inline auto EncodeLogRecordHead(char *out, uint32_t size, uint32_t format_id, int64_t timestamp,
+                                LogLevel log_level) noexcept -> char * {
+  auto level = static_cast<uint8_t>(log_level);
+  memcpy(out, &size, sizeof(size));
+  memcpy(out + sizeof(size), &format_id, sizeof(format_id));
+  memcpy(out + sizeof(size) + sizeof(format_id), &timestamp, sizeof(timestamp));
+  memcpy(out + sizeof(size) + sizeof(format_id) + sizeof(timestamp), &level, sizeof(level));
+  return out + LOG_RECORD_HEAD_SIZE;
+}
+
+/* append a piece at the back of a LogBlock or a std::string alike */
+template <typename Out>
+void Append(Out &out, std::string_view piece) {  // NOLINT
+  out.insert(out.end(), piece.begin(), piece.end());
+}
+
+/* append the decimal of a number */
+template <typename Out, typename T>
+void AppendNumber(Out &out, T value) {  // NOLINT
+  char number[32];
+  Append(out, {number, static_cast<size_t>(std::to_chars(number, number + sizeof(number), value).ptr - number)});
+}
+
+/*
+ * the stamp in the strftime() Format of the local second a timestamp in microseconds falls in
+ * formatted only once per second on each thread for each format
+ */
+template <const char *Format>
+auto FormatSecond(int64_t timestamp) -> std::string_view {
+  struct SecondCache {
+    time_t second_{-1};
+    char stamp_[40]{};
+    size_t size_{0};
+  };
+  thread_local SecondCache cache;
+  auto second = static_cast<time_t>(timestamp / 1000000);
+  if (second != cache.second_) {
+    struct tm tm {};
+    localtime_r(&second, &tm);
+    cache.size_ = strftime(cache.stamp_, sizeof(cache.stamp_), Format, &tm);
+    cache.second_ = second;
+  }
+  return {cache.stamp_, cache.size_};
+}
+
+/* append the string quoted and escaped as a JSON string */
+void AppendJsonString(LogBlock &out, std::string_view str);  // NOLINT
+
+/**
+ * Render the records into lines appended to out, each "{}" in a format is substituted by the next argument
+ * return false if a record is malformed, the ones before it are still rendered
+ */
+auto RenderLogRecords(std::string_view records, const std::vector<LogFormat> &formats, LogRenderMode mode,
+                      LogBlock &out) -> bool;  // NOLINT
+
+/* append a FORMAT frame of the binary log file */
+void AppendFormatFrame(uint32_t format_id, const LogFormat &format, LogBlock &out);  // NOLINT
+
+/* append a RECORDS frame of the binary log file */
+void AppendRecordsFrame(std::string_view records, LogBlock &out);  // NOLINT
+
+/**
+ * Render a whole binary log file
+ * return false if it is not one or is truncated, the frames before the broken one are still rendered
+ */
+auto DecodeBinaryLog(std::string_view file, LogRenderMode mode, LogBlock &out) -> bool;  // NOLINT
+
+}  // namespace TURTLE_SERVER
+
+#endif  // SRC_INCLUDE_LOG_LOG_RECORD_H_
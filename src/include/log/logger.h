@@ -17,110 +17,211 @@
 #include <atomic>
 #include <chrono>              // NOLINT
 #include <condition_variable>  // NOLINT
-#include <deque>
+#include <cstdint>
 #include <functional>
-#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>  // NOLINT
-#include <sstream>
+#include <new>
 #include <string>
+#include <string_view>
 #include <thread>  // NOLINT
+#include <vector>
+#include "core/profiled_mutex.h"
 #include "core/utils.h"
+#include "log/log_record.h"
 
 namespace TURTLE_SERVER {
 
-enum class LogLevel { INFO, WARNING, ERROR, FATAL };
+/*
+ * the compile-time minimum level, the logs below it are compiled out entirely
+ * 0 ~ 3 for INFO ~ FATAL, and 4 for NOLOG, set by the LOG_LEVEL option in CMake
+ */
+#ifdef NOLOG
+#undef TURTLE_LOG_LEVEL
+#define TURTLE_LOG_LEVEL 4
+#endif
+#ifndef TURTLE_LOG_LEVEL
+#define TURTLE_LOG_LEVEL 0
+#endif
+
+/* a constant expression, so that a level compiled out is a constant false branch */
+constexpr auto IsLogCompiledIn(LogLevel log_level) noexcept -> bool {
+  return static_cast<int>(log_level) >= TURTLE_LOG_LEVEL;
+}
 
 /* threshold */
-constexpr int COUNT_THRESHOLD = 1000;
+constexpr size_t LOG_BLOCK_SIZE = 64 * 1024;
 constexpr std::chrono::duration REFRESH_THRESHOLD = std::chrono::microseconds(3000);
-
-/* log file name if used */
-const std::string LOG_PATH = std::string("TurtleLog");  // NOLINT
+constexpr std::chrono::duration IDLE_REFRESH_THRESHOLD = std::chrono::milliseconds(1000);
 
 /**
  * A simple asynchronous logger
  * All callers counts as frontend-producer and is non-blocking
  * a backend worker thread periodically flush the log to persistent storage
+ *
+ * Each producer thread appends into its own double-buffered LogBuffer, so the reactors never
+ * contend with each other. A log is recorded raw, as its timestamp, the id of its format string
+ * registered once per call site and its typed arguments, see log/log_record.h
+ * The records are formatted into text later on the writer thread, or in the binary mode written
+ * as they are, to be rendered offline by the turtle_logdecode tool
+ * A filled block is handed to the writer thread, which collects the partial ones as well
+ * at least every REFRESH_THRESHOLD while the logs keep coming
  */
 class Logger {
  public:
   /*
-   * public logging entry
+   * public logging entry, the format string takes "{}" as the placeholder of each argument
+   * the arguments could be integers, floating points, bools, chars and strings
+   * the format string must be a literal, registered as format_id once by its call site
+   * a record which could not be allocated is dropped, so that logging never throws
    */
-  static void LogMsg(LogLevel log_level, const std::string &msg) noexcept;
+  template <size_t N, typename... Args>
+  static void Log(LogLevel log_level, uint32_t format_id, const char (&)[N], const Args &...args) noexcept {
+    auto &logger = GetInstance();
+    auto now =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch());
+    auto size = static_cast<uint32_t>(LOG_RECORD_HEAD_SIZE + (LogArgSize(args) + ... + 0));
+    bool filled;
+    try {
+      filled = logger.GetLocalBuffer().Append(size, [&](char *out) {
+        out = EncodeLogRecordHead(out, size, format_id, now.count(), log_level);
+        ((out = EncodeLogArg(out, args)), ...);
+      });
+    } catch (const std::bad_alloc &) {
+      return;
+    }
+    logger.MaybeNotify(filled, now);
+  }
+
+  /* register the format string of a call site, return its id */
+  template <size_t N>
+  static auto RegisterFormat(const char (&fmt)[N], const char *file, uint32_t line) noexcept -> uint32_t {
+    return GetInstance().AddFormat(fmt, file, line);
+  }
+
+  /* the runtime minimum level, on top of the compile-time one */
+  static void SetLevel(LogLevel log_level) noexcept { level_.store(log_level, std::memory_order_relaxed); }
+
+  static auto IsEnabled(LogLevel log_level) noexcept -> bool {
+    return log_level >= level_.load(std::memory_order_relaxed);
+  }
 
   /*
    * Singleton Pattern access point
    */
   static auto GetInstance() noexcept -> Logger &;
 
+  /* how many thread buffers are registered, for inspection only */
+  static auto BufferCount() -> size_t;
+
   NON_COPYABLE_AND_MOVEABLE(Logger);
 
   /*
-   * Each individual Log message
-   * upon construction, the date time is prepended
+   * The per-thread buffer, only ever touched by its owner thread and the writer thread
+   * so its lock is practically uncontended
    */
-  struct Log {
-    std::string stamped_msg_;
+  class LogBuffer {
+   public:
+    LogBuffer();
 
     /*
-     stamp datetime and log level
-     not guaranteed to be output in the stamped time order, best effort approach
-    */
-    Log(LogLevel log_level, const std::string &log_msg) noexcept;
-
-    friend auto operator<<(std::ostream &os, const Log &log) -> std::ostream & {
-      os << log.stamped_msg_;
-      return os;
+     * append a record of the given size written in place by the writer function
+     * return true if a block is filled and ready to be written
+     */
+    template <typename Writer>
+    auto Append(size_t size, const Writer &write) -> bool {
+      UniqueLock<Mutex> lock(mtx_);
+      bool filled = MakeRoom(size);
+      auto offset = current_.size();
+      current_.resize(offset + size);
+      write(current_.data() + offset);
+      return filled;
     }
+
+    /* take the filled blocks and the partial one, for the writer thread */
+    void Collect(std::vector<LogBlock> &blocks);  // NOLINT
+
+    /* hand back the written blocks to be reused */
+    void Recycle(std::vector<LogBlock> &blocks);  // NOLINT
+
+    /* the owner thread has exited, so the buffer is to be dropped once drained */
+    void Orphan() noexcept;
+
+    auto IsOrphaned() noexcept -> bool;
+
+   private:
+    /* swap in a new block if the current one cannot take the size, return true if one is filled */
+    auto MakeRoom(size_t size) -> bool;
+
+    Mutex mtx_{"log_buffer"};
+    LogBlock current_;
+    std::vector<LogBlock> full_;
+    std::vector<LogBlock> spare_;
+    bool orphaned_{false};
   };
 
  private:
+  auto AddFormat(const char *fmt, const char *file, uint32_t line) noexcept -> uint32_t;
+
   /*
    * private constructor, takes in a logging strategy
    * upon ctor, launch backend worker thread
    */
-  explicit Logger(const std::function<void(const std::deque<Log> &logs)> &log_strategy);
+  Logger(const std::function<void(const std::vector<LogBlock> &blocks)> &log_strategy, bool binary);
 
   /*
    * signal and harvest backend thread
    */
   ~Logger();
 
+  /* the calling thread's buffer, registered upon its first log */
+  auto GetLocalBuffer() -> LogBuffer &;
+
   /*
-   * internal helper to push a log into the FIFO queue
-   * potentially notify the backend worker to swap and flush
-   * if threshold criteria is met
+   * a best effort notification to the worker thread
+   * if a block is filled or the last flush is stale
    */
-  void PushLog(Log &&log);
+  void MaybeNotify(bool block_filled, std::chrono::microseconds now) noexcept;
 
   /*
    * The thread routine for the backend log writer
    */
   void LogWriting();
 
-  std::function<void(const std::deque<Log> &)> log_strategy_;
+  std::function<void(const std::vector<LogBlock> &)> log_strategy_;
+  bool binary_;
   std::atomic<bool> done_ = false;
-  std::mutex mtx_;
-  std::condition_variable cv_;
-  std::deque<Log> queue_;
+  std::atomic<bool> notified_ = false;
+  Mutex mtx_{"logger"};
+  ConditionVariable cv_;
+  std::vector<std::shared_ptr<LogBuffer>> buffers_;
   std::thread log_writer_;
-  std::chrono::microseconds last_flush_;
+  std::atomic<int64_t> last_flush_;
+  std::mutex formats_mtx_;
+  std::vector<LogFormat> formats_;
+  static inline std::atomic<LogLevel> level_{LogLevel::INFO};
 };
 
-/* macro definitions for 4 levels of logging */
-#ifdef NOLOG
-#define LOG_INFO(x) {};
-#define LOG_WARNING(x) {};
-#define LOG_ERROR(x) {};
-#define LOG_FATAL(x) {};
-#else
-#define LOG_INFO(x) TURTLE_SERVER::Logger::LogMsg(TURTLE_SERVER::LogLevel::INFO, (x));
-#define LOG_WARNING(x) TURTLE_SERVER::Logger::LogMsg(TURTLE_SERVER::LogLevel::WARNING, (x));
-#define LOG_ERROR(x) TURTLE_SERVER::Logger::LogMsg(TURTLE_SERVER::LogLevel::ERROR, (x));
-#define LOG_FATAL(x) TURTLE_SERVER::Logger::LogMsg(TURTLE_SERVER::LogLevel::FATAL, (x));
-#endif
+/*
+ * macro definitions for 4 levels of logging, i.e. LOG_INFO("client fd={} has exited", fd)
+ * the arguments are not even evaluated for a disabled level
+ * a level below TURTLE_LOG_LEVEL is compiled out
+ * each call site registers its format string upon its first log
+ */
+#define TURTLE_LOG_FORMAT(fmt, ...) fmt
+#define TURTLE_LOG(log_level, ...)                                                                      \
+  do {                                                                                                  \
+    if (TURTLE_SERVER::IsLogCompiledIn(log_level) && TURTLE_SERVER::Logger::IsEnabled(log_level)) {   \
+      static const uint32_t turtle_log_format_id =                                                      \
+          TURTLE_SERVER::Logger::RegisterFormat(TURTLE_LOG_FORMAT(__VA_ARGS__, 0), __FILE__, __LINE__); \
+      TURTLE_SERVER::Logger::Log(log_level, turtle_log_format_id, __VA_ARGS__);                         \
+    }                                                                                                   \
+  } while (0)
+#define LOG_INFO(...) TURTLE_LOG(TURTLE_SERVER::LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) TURTLE_LOG(TURTLE_SERVER::LogLevel::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...) TURTLE_LOG(TURTLE_SERVER::LogLevel::ERROR, __VA_ARGS__)
+#define LOG_FATAL(...) TURTLE_LOG(TURTLE_SERVER::LogLevel::FATAL, __VA_ARGS__)
 }  // namespace TURTLE_SERVER
 
 #endif  // SRC_INCLUDE_LOG_LOGGER_H_
@@ -0,0 +1,158 @@
+/**
+ * @file log_file.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the rotating log file
+ * written by the backend thread of the Logger
+ */
+
+#include "log/log_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <utility>
+
+namespace TURTLE_SERVER {
+
+/* the name of a new file, sortable by its creation time */
+static auto MakeFileName(const std::string &path, const std::string &suffix, uint32_t sequence) -> std::string {
+  auto t = std::time(nullptr);
+  struct tm tm {};
+  localtime_r(&t, &tm);
+  char stamp[32];
+  auto size = strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+  char number[16];
+  snprintf(number, sizeof(number), "_%03u", sequence);
+  return path + "_" + std::string(stamp, size) + number + suffix;
+}
+
+LogFile::LogFile(std::string suffix, std::function<void(LogBlock &)> header, LogFileOptions options)
+    : suffix_(std::move(suffix)), header_(std::move(header)), options_(std::move(options)) {
+  options_.write_size_ = std::max<size_t>(options_.write_size_, 1);
+  options_.retained_files_ = std::max<size_t>(options_.retained_files_, 1);
+  // the files left by the previous runs count towards the retention as well
+  std::filesystem::path prefix(options_.path_ + "_");
+  auto directory = prefix.has_parent_path() ? prefix.parent_path() : std::filesystem::path(".");
+  auto prefix_name = prefix.filename().string();
+  std::error_code error;
+  std::vector<std::string> existing;
+  for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+    auto name = entry.path().filename().string();
+    if (entry.is_regular_file(error) && name.size() > prefix_name.size() + suffix_.size() &&
+        name.compare(0, prefix_name.size(), prefix_name) == 0 &&
+        name.compare(name.size() - suffix_.size(), suffix_.size(), suffix_) == 0) {
+      existing.push_back(prefix.has_parent_path() ? entry.path().string() : name);
+    }
+  }
+  std::sort(existing.begin(), existing.end());
+  files_.assign(existing.begin(), existing.end());
+}
+
+LogFile::~LogFile() { Close(); }
+
+void LogFile::Write(const std::vector<LogBlock> &blocks) {
+  auto now = std::chrono::steady_clock::now();
+  for (const auto &block : blocks) {
+    if (block.empty()) {
+      continue;
+    }
+    size_t size = offset_ + staged_.size();
+    if (fd_ == -1) {
+      Open(now);
+    } else if (size > 0 &&
+               (size + block.size() > options_.rotate_size_ || now - opened_at_ >= options_.rotate_interval_)) {
+      Close();
+      Open(now);
+    }
+    staged_.insert(staged_.end(), block.begin(), block.end());
+    if (!pending_) {
+      pending_ = true;
+      pending_since_ = now;
+    }
+    size_t full = staged_.size() / options_.write_size_ * options_.write_size_;
+    if (full > 0) {
+      WriteAt(staged_.data(), full, offset_);
+      offset_ += full;
+      staged_.erase(staged_.begin(), staged_.begin() + full);
+      pending_ = !staged_.empty();
+      pending_since_ = now;
+    }
+  }
+  if (pending_ && now - pending_since_ >= options_.flush_interval_) {
+    Flush();
+  }
+}
+
+void LogFile::Flush() {
+  if (fd_ != -1 && !staged_.empty()) {
+    WriteAt(staged_.data(), staged_.size(), offset_);
+  }
+  pending_ = false;
+}
+
+auto LogFile::GetFiles() const noexcept -> const std::deque<std::string> & { return files_; }
+
+void LogFile::Open(std::chrono::steady_clock::time_point now) {
+  std::string name;
+  do {
+    name = MakeFileName(options_.path_, suffix_, sequence_++);
+    fd_ = open(name.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  } while (fd_ == -1 && errno == EEXIST);
+  if (fd_ == -1) {
+    return;
+  }
+#ifdef OS_LINUX
+  // reserve the space upfront without changing the file size, so the readers never see a zero tail
+  fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, options_.rotate_size_);
+#endif
+  files_.push_back(name);
+  while (files_.size() > options_.retained_files_) {
+    unlink(files_.front().c_str());
+    files_.pop_front();
+  }
+  opened_at_ = now;
+  offset_ = 0;
+  staged_.clear();
+  if (header_ != nullptr) {
+    header_(staged_);
+  }
+}
+
+void LogFile::Close() {
+  if (fd_ == -1) {
+    return;
+  }
+  Flush();
+  // give back the preallocated space not written to
+  ftruncate(fd_, offset_ + staged_.size());
+  close(fd_);
+  fd_ = -1;
+  offset_ = 0;
+  staged_.clear();
+}
+
+void LogFile::WriteAt(const char *data, size_t size, size_t offset) noexcept {
+  while (size > 0) {
+    ssize_t written = pwrite(fd_, data, size, offset);
+    if (written == -1 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+}
+
+}  // namespace TURTLE_SERVER
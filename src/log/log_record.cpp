@@ -0,0 +1,271 @@
+/**
+ * @file log_record.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is an implementation file implementing the renderers of the log records
+ * and the framing of the binary log file
+ */
+
+#include "log/log_record.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace TURTLE_SERVER {
+
+/* mapping LogLevel enum to string representation */
+constexpr std::string_view LOG_LEVEL_NAMES[] = {"INFO", "WARNING", "ERROR", "FATAL"};
+
+static constexpr char UNKNOWN_FORMAT[] = {"<unknown format>"};
+
+template <typename T>
+static void Write(LogBlock &out, const T &value) {  // NOLINT
+  Append(out, {reinterpret_cast<const char *>(&value), sizeof(value)});
+}
+
+/* read a value and advance, false if not enough bytes are left */
+template <typename T>
+static auto Read(const char *&pos, const char *end, T &value) -> bool {  // NOLINT
+  if (static_cast<size_t>(end - pos) < sizeof(T)) {
+    return false;
+  }
+  memcpy(&value, pos, sizeof(T));
+  pos += sizeof(T);
+  return true;
+}
+
+/* the datetime stamp leading each text line */
+static constexpr char LOG_TIMESTAMP_FORMAT[] = {"[%d %b %Y %H:%M:%S]"};
+
+void AppendJsonString(LogBlock &out, std::string_view str) {  // NOLINT
+  out.push_back('"');
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      Append(out, {escaped, static_cast<size_t>(snprintf(escaped, sizeof(escaped), "\\u%04x", c))});
+    } else {
+      out.push_back(c);
+    }
+  }
+  out.push_back('"');
+}
+
+/* render the next argument and advance, chars and strings are quoted in JSON, false if malformed */
+static auto RenderArg(const char *&arg, const char *end, LogRenderMode mode, LogBlock &out) -> bool {  // NOLINT
+  uint8_t tag;
+  if (!Read(arg, end, tag)) {
+    return false;
+  }
+  switch (static_cast<LogArgTag>(tag)) {
+    case LogArgTag::INT: {
+      int64_t value;
+      if (!Read(arg, end, value)) {
+        return false;
+      }
+      AppendNumber(out, value);
+      return true;
+    }
+    case LogArgTag::UINT: {
+      uint64_t value;
+      if (!Read(arg, end, value)) {
+        return false;
+      }
+      AppendNumber(out, value);
+      return true;
+    }
+    case LogArgTag::DOUBLE: {
+      double value;
+      if (!Read(arg, end, value)) {
+        return false;
+      }
+      if (mode == LogRenderMode::JSON && !std::isfinite(value)) {
+        Append(out, "null");
+        return true;
+      }
+      char number[32];
+      Append(out, {number, static_cast<size_t>(snprintf(number, sizeof(number), "%g", value))});
+      return true;
+    }
+    case LogArgTag::BOOL: {
+      char value;
+      if (!Read(arg, end, value)) {
+        return false;
+      }
+      Append(out, value != 0 ? "true" : "false");
+      return true;
+    }
+    case LogArgTag::CHAR: {
+      char value;
+      if (!Read(arg, end, value)) {
+        return false;
+      }
+      mode == LogRenderMode::JSON ? AppendJsonString(out, {&value, 1}) : out.push_back(value);
+      return true;
+    }
+    case LogArgTag::STRING: {
+      uint32_t size;
+      if (!Read(arg, end, size) || static_cast<size_t>(end - arg) < size) {
+        return false;
+      }
+      mode == LogRenderMode::JSON ? AppendJsonString(out, {arg, size}) : Append(out, {arg, size});
+      arg += size;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* substitute each placeholder by the next argument, the extra placeholders are kept as is */
+static auto RenderMessage(std::string_view fmt, const char *arg, const char *end, LogBlock &out) -> bool {  // NOLINT
+  for (size_t i = 0; i < fmt.size(); i++) {
+    if (fmt[i] == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}' && arg < end) {
+      if (!RenderArg(arg, end, LogRenderMode::TEXT, out)) {
+        return false;
+      }
+      i++;
+      continue;
+    }
+    out.push_back(fmt[i]);
+  }
+  return true;
+}
+
+auto RenderLogRecords(std::string_view records, const std::vector<LogFormat> &formats, LogRenderMode mode,
+                      LogBlock &out) -> bool {  // NOLINT
+  const char *pos = records.data();
+  const char *records_end = records.data() + records.size();
+  LogBlock message;
+  while (pos < records_end) {
+    const char *head = pos;
+    uint32_t size;
+    uint32_t format_id = 0;
+    int64_t timestamp = 0;
+    uint8_t level = 0;
+    if (!Read(pos, records_end, size) || size < LOG_RECORD_HEAD_SIZE ||
+        size > static_cast<size_t>(records_end - head)) {
+      return false;
+    }
+    const char *end = head + size;
+    Read(pos, end, format_id);
+    Read(pos, end, timestamp);
+    Read(pos, end, level);
+    if (level > static_cast<uint8_t>(LogLevel::FATAL)) {
+      return false;
+    }
+    const LogFormat *format = format_id < formats.size() ? &formats[format_id] : nullptr;
+    std::string_view fmt = format != nullptr ? std::string_view(format->fmt_) : UNKNOWN_FORMAT;
+    if (mode == LogRenderMode::TEXT) {
+      Append(out, FormatSecond<LOG_TIMESTAMP_FORMAT>(timestamp));
+      Append(out, LOG_LEVEL_NAMES[level]);
+      Append(out, ": ");
+      if (!RenderMessage(fmt, pos, end, out)) {
+        return false;
+      }
+      out.push_back('\n');
+    } else {
+      message.clear();
+      if (!RenderMessage(fmt, pos, end, message)) {
+        return false;
+      }
+      Append(out, R"({"time_us":)");
+      AppendNumber(out, timestamp);
+      Append(out, R"(,"level":)");
+      AppendJsonString(out, LOG_LEVEL_NAMES[level]);
+      Append(out, R"(,"file":)");
+      AppendJsonString(out, format != nullptr ? format->file_ : "");
+      Append(out, R"(,"line":)");
+      AppendNumber(out, format != nullptr ? format->line_ : 0);
+      Append(out, R"(,"format":)");
+      AppendJsonString(out, fmt);
+      Append(out, R"(,"message":)");
+      AppendJsonString(out, {message.data(), message.size()});
+      Append(out, R"(,"args":[)");
+      for (const char *arg = pos; arg < end;) {
+        if (arg != pos) {
+          out.push_back(',');
+        }
+        if (!RenderArg(arg, end, LogRenderMode::JSON, out)) {
+          return false;
+        }
+      }
+      Append(out, "]}\n");
+    }
+    pos = end;
+  }
+  return true;
+}
+
+void AppendFormatFrame(uint32_t format_id, const LogFormat &format, LogBlock &out) {  // NOLINT
+  Write(out, LogFrame::FORMAT);
+  Write(out, format_id);
+  Write(out, format.line_);
+  Write(out, static_cast<uint32_t>(format.file_.size()));
+  Append(out, format.file_);
+  Write(out, static_cast<uint32_t>(format.fmt_.size()));
+  Append(out, format.fmt_);
+}
+
+void AppendRecordsFrame(std::string_view records, LogBlock &out) {  // NOLINT
+  Write(out, LogFrame::RECORDS);
+  Write(out, static_cast<uint32_t>(records.size()));
+  Append(out, records);
+}
+
+auto DecodeBinaryLog(std::string_view file, LogRenderMode mode, LogBlock &out) -> bool {  // NOLINT
+  if (file.substr(0, LOG_BINARY_MAGIC_SIZE) != std::string_view(LOG_BINARY_MAGIC, LOG_BINARY_MAGIC_SIZE)) {
+    return false;
+  }
+  std::vector<LogFormat> formats;
+  const char *pos = file.data() + LOG_BINARY_MAGIC_SIZE;
+  const char *end = file.data() + file.size();
+  auto read_string = [&pos, end](std::string &str) {
+    uint32_t size;
+    if (!Read(pos, end, size) || static_cast<size_t>(end - pos) < size) {
+      return false;
+    }
+    str.assign(pos, size);
+    pos += size;
+    return true;
+  };
+  while (pos < end) {
+    LogFrame kind;
+    if (!Read(pos, end, kind)) {
+      return false;
+    }
+    if (kind == LogFrame::FORMAT) {
+      uint32_t format_id;
+      LogFormat format;
+      if (!Read(pos, end, format_id) || !Read(pos, end, format.line_) || !read_string(format.file_) ||
+          !read_string(format.fmt_)) {
+        return false;
+      }
+      // the ids are framed in order, each one at most once past the known ones
+      if (format_id > formats.size()) {
+        return false;
+      }
+      if (format_id == formats.size()) {
+        formats.push_back(std::move(format));
+      } else {
+        formats[format_id] = std::move(format);
+      }
+    } else if (kind == LogFrame::RECORDS) {
+      uint32_t size;
+      if (!Read(pos, end, size) || static_cast<size_t>(end - pos) < size ||
+          !RenderLogRecords({pos, size}, formats, mode, out)) {
+        return false;
+      }
+      pos += size;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace TURTLE_SERVER
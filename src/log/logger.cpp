@@ -10,80 +10,96 @@
  */
 
 #include "log/logger.h"
-#include <filesystem>
-#include <fstream>
+
+#include <iterator>
+
+#include "log/log_file.h"
 
 namespace TURTLE_SERVER {
 
-/* mapping LogLevel enum to string representation */
-const char *log_level_names[] = {"INFO: ", "WARNING: ", "ERROR: ", "FATAL: "};
+/* at most this many written blocks are kept for reuse by each thread, the double buffering */
+constexpr size_t MAX_SPARE_BLOCKS = 2;
 
-/* helper function to get current time since epoch in milliseconds */
-auto GetCurrentTime() -> std::chrono::milliseconds {
+/* helper function to get current time since epoch in microseconds */
+auto GetCurrentTime() -> std::chrono::microseconds {
   using namespace std::chrono;  // NOLINT
-  return duration_cast<milliseconds>(system_clock::now().time_since_epoch());
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch());
 }
 
-/* helper function to get current datetime in format DDMMYYYY */
-auto GetCurrentDate() -> std::string {
-  auto t = std::time(nullptr);
-  auto tm = *std::localtime(&t);
-  std::ostringstream stream;
-  stream << std::put_time(&tm, "%d%b%Y");
-  return stream.str();
+/* simple printing to stdout logging strategy, caller should ensure thread-safe access */
+void PrintToScreen(const std::vector<LogBlock> &blocks) {
+  std::for_each(blocks.begin(), blocks.end(), [](const auto &block) { std::cout.write(block.data(), block.size()); });
+  std::cout.flush();
 }
 
-/* simple printing to stdout logging strategy, caller should ensure thread-safe access */
-void PrintToScreen(const std::deque<Logger::Log> &logs) {
-  std::for_each(logs.begin(), logs.end(), [](const auto &log) { std::cout << log; });
+/* writing to the rotating log files strategy, the header starts each file */
+auto PrintToFile(const std::string &suffix, const std::function<void(LogBlock &)> &header = nullptr)
+    -> std::function<void(const std::vector<LogBlock> &)> {
+  auto log_file = std::make_shared<LogFile>(suffix, header);
+  return [log_file](const std::vector<LogBlock> &blocks) { log_file->Write(blocks); };
 }
 
-/* opened log stream during the lifetime of the entire server */
-struct StreamWriter {
-  std::fstream f_;
+Logger::LogBuffer::LogBuffer() { current_.reserve(LOG_BLOCK_SIZE); }
 
-  explicit StreamWriter(const std::string &path = LOG_PATH) {
-    f_.open(path + "_" + GetCurrentDate(), std::fstream::out | std::fstream::trunc);
+auto Logger::LogBuffer::MakeRoom(size_t size) -> bool {
+  if (current_.size() + size <= current_.capacity()) {
+    return false;
   }
+  // swap in a spare block, an oversized log gets a block large enough of its own
+  bool filled = false;
+  if (!current_.empty()) {
+    full_.push_back(std::move(current_));
+    filled = true;
+  }
+  current_ = LogBlock{};
+  if (!spare_.empty()) {
+    current_ = std::move(spare_.back());
+    spare_.pop_back();
+  }
+  current_.reserve(std::max(LOG_BLOCK_SIZE, size));
+  return filled;
+}
 
-  ~StreamWriter() {
-    if (f_.is_open()) {
-      f_.flush();
-      f_.close();
+void Logger::LogBuffer::Collect(std::vector<LogBlock> &blocks) {
+  UniqueLock<Mutex> lock(mtx_);
+  std::move(full_.begin(), full_.end(), std::back_inserter(blocks));
+  full_.clear();
+  if (!current_.empty()) {
+    blocks.push_back(std::move(current_));
+    current_ = LogBlock{};
+    if (!spare_.empty()) {
+      current_ = std::move(spare_.back());
+      spare_.pop_back();
     }
+    current_.reserve(LOG_BLOCK_SIZE);
   }
+}
 
-  void WriteLogs(const std::deque<Logger::Log> &logs) {
-    std::for_each(logs.begin(), logs.end(), [this](auto &log) { f_ << log; });
-    f_.flush();
+void Logger::LogBuffer::Recycle(std::vector<LogBlock> &blocks) {
+  UniqueLock<Mutex> lock(mtx_);
+  for (auto &block : blocks) {
+    if (spare_.size() >= MAX_SPARE_BLOCKS) {
+      break;
+    }
+    block.clear();
+    spare_.push_back(std::move(block));
   }
-};
+}
 
-/* simple printing to a file logging strategy, caller should ensure thread-safe access */
-void PrintToFile(const std::deque<Logger::Log> &logs) {
-  static StreamWriter stream_writer;
-  stream_writer.WriteLogs(logs);
+void Logger::LogBuffer::Orphan() noexcept {
+  UniqueLock<Mutex> lock(mtx_);
+  orphaned_ = true;
 }
 
-/*
- stamp datetime and log level
- not guaranteed to be output in the stamped time order, best effort approach
-*/
-Logger::Log::Log(LogLevel log_level, const std::string &log_msg) noexcept {
-  auto t = std::time(nullptr);
-  auto tm = *std::localtime(&t);
-  std::ostringstream stream;
-  stream << std::put_time(&tm, "[%d %b %Y %H:%M:%S]") << log_level_names[static_cast<int>(log_level)] << log_msg
-         << std::endl;
-  stamped_msg_ = stream.str();
+auto Logger::LogBuffer::IsOrphaned() noexcept -> bool {
+  UniqueLock<Mutex> lock(mtx_);
+  return orphaned_;
 }
 
-/*
- * static public logging entry
- */
-void Logger::LogMsg(LogLevel log_level, const std::string &msg) noexcept {
-  auto log = Logger::Log(log_level, msg);
-  GetInstance().PushLog(std::move(log));
+auto Logger::AddFormat(const char *fmt, const char *file, uint32_t line) noexcept -> uint32_t {
+  std::unique_lock<std::mutex> lock(formats_mtx_);
+  formats_.push_back({fmt, file, line});
+  return formats_.size() - 1;
 }
 
 /*
@@ -93,17 +109,33 @@ auto Logger::GetInstance() noexcept -> Logger & {
   // insert your logging strategy here in ctor
   // instead of the default one for customization
   // see example of 'PrintToScreen' and 'PrintToFile'
-  static Logger single_logger{PrintToFile};
+#ifdef LOG_BINARY
+  // each binary file starts with the magic and every format registered so far
+  static Logger single_logger{PrintToFile(LOG_BINARY_SUFFIX,
+                                          [](LogBlock &header) {
+                                            header.insert(header.end(), LOG_BINARY_MAGIC,
+                                                          LOG_BINARY_MAGIC + LOG_BINARY_MAGIC_SIZE);
+                                            auto &logger = GetInstance();
+                                            std::unique_lock<std::mutex> lock(logger.formats_mtx_);
+                                            for (size_t id = 0; id < logger.formats_.size(); id++) {
+                                              AppendFormatFrame(id, logger.formats_[id], header);
+                                            }
+                                          }),
+                              true};
+#else
+  static Logger single_logger{PrintToFile(LOG_TEXT_SUFFIX), false};
+#endif
   return single_logger;
 }
 
 /*
- * private constructor, takes in a logging strategy
+ * private constructor, takes in a logging strategy and whether it writes the binary log
  * upon ctor, launch backend worker thread
  */
-Logger::Logger(const std::function<void(const std::deque<Log> &logs)> &log_strategy) {
+Logger::Logger(const std::function<void(const std::vector<LogBlock> &blocks)> &log_strategy, bool binary) {
   log_strategy_ = log_strategy;
-  last_flush_ = GetCurrentTime();
+  binary_ = binary;
+  last_flush_ = GetCurrentTime().count();
   log_writer_ = std::thread(&Logger::LogWriting, this);
 }
 
@@ -111,31 +143,52 @@ Logger::Logger(const std::function<void(const std::deque<Log> &logs)> &log_strat
  * signal and harvest backend thread
  */
 Logger::~Logger() {
-  done_ = true;
+  {
+    UniqueLock<Mutex> lock(mtx_);
+    done_ = true;
+  }
   cv_.notify_one();
   if (log_writer_.joinable()) {
     log_writer_.join();
   }
 }
 
-/*
- * internal helper to push a log into the FIFO queue
- * potentially notify the backend worker to swap and flush
- * if threshold criteria is met
- */
-void Logger::PushLog(Logger::Log &&log) {
-  using std::chrono::milliseconds;
-  bool should_notify = false;
-  {
-    std::unique_lock<std::mutex> lock(mtx_);
-    queue_.push_back(std::move(log));
-    milliseconds now = GetCurrentTime();
-    if ((now - last_flush_) > REFRESH_THRESHOLD || queue_.size() > COUNT_THRESHOLD) {
-      should_notify = true;
+auto Logger::GetLocalBuffer() -> LogBuffer & {
+  // the buffer outlives its thread till the writer drains it
+  struct LocalBuffer {
+    std::shared_ptr<LogBuffer> buffer_;
+    ~LocalBuffer() {
+      if (buffer_ != nullptr) {
+        buffer_->Orphan();
+      }
     }
+  };
+  thread_local LocalBuffer local;
+  if (local.buffer_ == nullptr) {
+    // kept only once registered, so a failed registration is retried upon the next log
+    auto buffer = std::make_shared<LogBuffer>();
+    {
+      UniqueLock<Mutex> lock(mtx_);
+      buffers_.push_back(buffer);
+    }
+    local.buffer_ = std::move(buffer);
   }
-  // a best effort notification to worker thread, not guarantee flush soon
-  if (should_notify) {
+  return *local.buffer_;
+}
+
+auto Logger::BufferCount() -> size_t {
+  auto &logger = GetInstance();
+  UniqueLock<Mutex> lock(logger.mtx_);
+  return logger.buffers_.size();
+}
+
+void Logger::MaybeNotify(bool block_filled, std::chrono::microseconds now) noexcept {
+  if (!block_filled && now.count() - last_flush_.load(std::memory_order_relaxed) <= REFRESH_THRESHOLD.count()) {
+    return;
+  }
+  if (!notified_.exchange(true)) {
+    // pass through the lock, so that the notification never slips in before the writer waits
+    { UniqueLock<Mutex> lock(mtx_); }
     cv_.notify_one();
   }
 }
@@ -144,22 +197,63 @@ void Logger::PushLog(Logger::Log &&log) {
  * The thread routine for the backend log writer
  */
 void Logger::LogWriting() {
-  std::deque<Logger::Log> writer_queue;
+  std::vector<std::shared_ptr<LogBuffer>> buffers;
+  std::vector<LogBlock> blocks;
+  std::vector<size_t> counts;
+  std::vector<LogBlock> texts(1);
+  std::vector<LogFormat> formats;
   while (true) {
-    std::unique_lock<std::mutex> lock(mtx_);
-    cv_.wait(lock, [this]() {
-      return done_ || queue_.size() > COUNT_THRESHOLD || GetCurrentTime() - last_flush_ > REFRESH_THRESHOLD;
-    });
-    // either the flush criteria is met or is about to exit
-    // need to record the remaining log in either case
-    if (!queue_.empty()) {
-      writer_queue.swap(queue_);
-      lock.unlock();  // producer may continue
-      log_strategy_(writer_queue);
-      last_flush_ = GetCurrentTime();
-      writer_queue.clear();
+    bool done;
+    {
+      UniqueLock<Mutex> lock(mtx_);
+      cv_.wait_for(lock, IDLE_REFRESH_THRESHOLD, [this]() { return done_ || notified_; });
+      done = done_;
+      buffers = buffers_;
+      // a buffer orphaned before being drained receives nothing more, and is dropped after this round
+      buffers_.erase(
+          std::remove_if(buffers_.begin(), buffers_.end(), [](const auto &buffer) { return buffer->IsOrphaned(); }),
+          buffers_.end());
+    }
+    notified_ = false;
+    for (auto &buffer : buffers) {
+      auto before = blocks.size();
+      buffer->Collect(blocks);
+      counts.push_back(blocks.size() - before);
+    }
+    auto &out = texts.front();
+    if (!blocks.empty()) {
+      // every format referred to by the collected records is registered by now
+      auto known = formats.size();
+      {
+        std::unique_lock<std::mutex> lock(formats_mtx_);
+        formats.insert(formats.end(), formats_.begin() + known, formats_.end());
+      }
+      for (auto id = known; binary_ && id < formats.size(); id++) {
+        AppendFormatFrame(id, formats[id], out);
+      }
+      for (const auto &block : blocks) {
+        if (binary_) {
+          AppendRecordsFrame({block.data(), block.size()}, out);
+        } else {
+          RenderLogRecords({block.data(), block.size()}, formats, LogRenderMode::TEXT, out);
+        }
+      }
+    }
+    // called even with nothing new, so that the strategy could write out what it holds back
+    log_strategy_(texts);
+    out.clear();
+    last_flush_ = GetCurrentTime().count();
+    // hand back the written blocks to the buffers they came from
+    auto block_it = blocks.begin();
+    for (size_t i = 0; i < buffers.size(); i++) {
+      std::vector<LogBlock> written(std::make_move_iterator(block_it), std::make_move_iterator(block_it + counts[i]));
+      buffers[i]->Recycle(written);
+      block_it += counts[i];
     }
-    if (done_) {
+    buffers.clear();
+    blocks.clear();
+    counts.clear();
+    if (done) {
       // exit this background thread
       return;
     }
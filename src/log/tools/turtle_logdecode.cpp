@@ -0,0 +1,46 @@
+/**
+ * @file turtle_logdecode.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the offline decoder rendering a binary log file, as written by the
+ * Logger built with LOG_BINARY, into text or JSON lines on stdout
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "log/log_record.h"
+
+int main(int argc, char *argv[]) {
+  const std::string usage =
+      "Usage: \n"
+      "./turtle_logdecode [optional: --json] [binary log file] \n";
+  if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[1]) != "--json")) {
+    std::cout << "argument error\n";
+    std::cout << usage;
+    exit(EXIT_FAILURE);
+  }
+  auto mode = argc == 3 ? TURTLE_SERVER::LogRenderMode::JSON : TURTLE_SERVER::LogRenderMode::TEXT;
+  std::ifstream in(argv[argc - 1], std::ios::binary);
+  if (!in.is_open()) {
+    std::cout << "fail to open " << argv[argc - 1] << "\n";
+    exit(EXIT_FAILURE);
+  }
+  std::string file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  TURTLE_SERVER::LogBlock out;
+  bool complete = TURTLE_SERVER::DecodeBinaryLog(file, mode, out);
+  std::cout.write(out.data(), out.size());
+  std::cout.flush();
+  if (!complete) {
+    // a server killed in the middle of a write leaves a truncated tail
+    std::cerr << "not a binary log file, or truncated after the logs above\n";
+    exit(EXIT_FAILURE);
+  }
+  return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file alloc_tracker_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for core/AllocationScope class
+ */
+
+#include "core/alloc_tracker.h"
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/buffer.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::ALLOC_TRACKING_ENABLED;
+using TURTLE_SERVER::AllocationScope;
+using TURTLE_SERVER::Buffer;
+
+TEST_CASE("[core/alloc_tracker]") {
+  SECTION("a scope counts the allocations and deallocations made on its thread since") {
+    AllocationScope scope;
+    {
+      auto numbers = std::make_unique<std::vector<int>>(100);
+      // the allocations of another thread are its own
+      std::thread([]() { std::string other(1000, 'x'); }).join();
+    }
+    auto allocated = scope.Get();
+    if constexpr (!ALLOC_TRACKING_ENABLED) {
+      CHECK(allocated.allocations_ == 0);
+      CHECK(allocated.bytes_ == 0);
+      return;
+    }
+    // the state of the thread is allocated on this thread, but freed on the thread itself
+    CHECK(allocated.allocations_ >= 3);
+    CHECK(allocated.allocations_ <= 4);
+    CHECK(allocated.bytes_ >= 100 * sizeof(int));
+    CHECK(allocated.bytes_ < 1000);
+    CHECK(allocated.deallocations_ == allocated.allocations_ - 1);
+  }
+
+  SECTION("an allocation budget, a buffer appended within its capacity allocates nothing") {
+    Buffer buffer(1024);
+    AllocationScope scope;
+    for (int i = 0; i < 100; i++) {
+      buffer.Append("0123456789");
+    }
+    CHECK(scope.Get().allocations_ == 0);
+  }
+}
@@ -59,4 +59,12 @@ TEST_CASE("[core/buffer]") {
     CHECK((op_str.has_value() && op_str.value() == msg));
     CHECK(buf.ToStringView() == next_msg);
   }
+
+  SECTION("pop bytes from the head") {
+    buf.Append("partially sent");
+    buf.PopHead(std::string("partially ").size());
+    CHECK(buf.ToStringView() == "sent");
+    buf.PopHead(100);
+    CHECK(buf.Size() == 0);
+  }
 }
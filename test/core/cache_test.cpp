@@ -10,6 +10,8 @@
 
 #include "core/cache.h"
 
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "catch2/catch_test_macros.hpp"
@@ -50,4 +52,17 @@ TEST_CASE("[core/cache]") {
     bool load_success = cache.TryLoad("url1", read_buf);
     CHECK(!load_success);
   }
+
+  SECTION("a resource expires once older than the time to live") {
+    Cache expiring_cache(capacity, 100);
+    std::vector<unsigned char> read_buf;
+    CHECK(expiring_cache.TryInsert("url", data));
+    CHECK(!expiring_cache.TryInsert("url", data));
+    CHECK(expiring_cache.TryLoad("url", read_buf));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK(!expiring_cache.TryLoad("url", read_buf));
+    CHECK(expiring_cache.GetOccupancy() == 0);
+    CHECK(expiring_cache.TryInsert("url", data));
+    CHECK(expiring_cache.GetOccupancy() == data_size);
+  }
 }
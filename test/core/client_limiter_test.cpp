@@ -0,0 +1,87 @@
+/**
+ * @file client_limiter_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for core/ClientLimiter class
+ */
+
+#include "core/client_limiter.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::ClientLimiter;
+using TURTLE_SERVER::ClientLimits;
+
+TEST_CASE("[core/client_limiter]") {
+  ClientLimits limits;
+  limits.max_connections_per_ip_ = 2;
+  limits.requests_per_second_ = 100;
+  limits.request_burst_ = 5;
+  const std::string client = "10.0.0.1";
+  const std::string other_client = "10.0.0.2";
+
+  SECTION("connections of one address are capped, independent of the other addresses") {
+    ClientLimiter limiter(limits);
+    CHECK(limiter.TryConnect(client));
+    CHECK(limiter.TryConnect(client));
+    CHECK_FALSE(limiter.TryConnect(client));
+    CHECK(limiter.TryConnect(other_client));
+    CHECK(limiter.GetConnectionCount(client) == 2);
+    limiter.Disconnect(client);
+    CHECK(limiter.TryConnect(client));
+  }
+
+  SECTION("requests beyond the burst are refused till the bucket refills") {
+    ClientLimiter limiter(limits);
+    for (int i = 0; i < 5; i++) {
+      CHECK(limiter.TryRequest(client));
+    }
+    CHECK_FALSE(limiter.TryRequest(client));
+    CHECK(limiter.TryRequest(other_client));
+    // 100 per second refills one token every 10 milliseconds
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(limiter.TryRequest(client));
+  }
+
+  SECTION("the loopback addresses are exempted unless asked otherwise") {
+    ClientLimiter limiter(limits);
+    for (int i = 0; i < 10; i++) {
+      CHECK(limiter.TryConnect("127.0.0.1"));
+      CHECK(limiter.TryRequest("::1"));
+    }
+    limits.exempt_loopback_ = false;
+    ClientLimiter strict_limiter(limits);
+    CHECK(strict_limiter.TryConnect("127.0.0.1"));
+    CHECK(strict_limiter.TryConnect("127.0.0.1"));
+    CHECK_FALSE(strict_limiter.TryConnect("127.0.0.1"));
+  }
+
+  SECTION("many reactors share the limiter concurrently") {
+    limits.max_connections_per_ip_ = 1000;
+    ClientLimiter limiter(limits);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+      threads.emplace_back([&limiter, t]() {
+        for (int i = 0; i < 100; i++) {
+          auto ip = "10.1." + std::to_string(t) + "." + std::to_string(i);
+          limiter.TryConnect(ip);
+          limiter.TryRequest(ip);
+          limiter.TryConnect("10.2.0.1");
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    CHECK(limiter.GetConnectionCount("10.2.0.1") == 800);
+    CHECK(limiter.GetConnectionCount("10.1.7.99") == 1);
+  }
+}
@@ -10,11 +10,14 @@
 
 #include "core/connection.h"
 
+#include <sys/socket.h>
 #include <unistd.h>
+#include <cstdio>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "catch2/catch_test_macros.hpp"
 #include "core/net_address.h"
@@ -88,4 +91,100 @@ TEST_CASE("[core/connection]") {
     connected_conn.Send();
     sleep(1);
   }
+
+  SECTION("a slow reader pauses the connection at the high watermark, and resumes it at the low") {
+    int pair_fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fds) == 0);
+    auto sock = std::make_unique<Socket>(pair_fds[0]);
+    sock->SetNonBlocking();
+    Connection conn(std::move(sock));
+    int highs = 0;
+    int lows = 0;
+    conn.SetWatermarks(64 * 1024, 16 * 1024);
+    conn.SetHighWatermarkCallback([&](Connection *) { highs++; });
+    conn.SetLowWatermarkCallback([&](Connection *) { lows++; });
+    // the socket buffer fills up, and the rest is kept instead of spinning on it
+    conn.WriteToWriteBuffer(std::vector<unsigned char>(4 * 1024 * 1024, 'x'));
+    conn.Send();
+    CHECK(conn.GetWriteBufferSize() > 0);
+    CHECK(conn.IsReadPaused());
+    CHECK(highs == 1);
+    CHECK(lows == 0);
+    // the reader catches up
+    char buf[4096];
+    while (conn.GetWriteBufferSize() > 0) {
+      while (read(pair_fds[1], buf, sizeof(buf)) == sizeof(buf) && conn.GetWriteBufferSize() > 0) {
+        conn.Send();
+      }
+      conn.Send();
+    }
+    CHECK_FALSE(conn.IsReadPaused());
+    CHECK(highs == 1);
+    CHECK(lows == 1);
+    close(pair_fds[1]);
+  }
+
+  SECTION("a file slice the socket could not take is sent from its fd, in order, never read into memory") {
+    int pair_fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fds) == 0);
+    auto sock = std::make_unique<Socket>(pair_fds[0]);
+    sock->SetNonBlocking();
+    Connection conn(std::move(sock));
+    conn.SetWatermarks(64 * 1024, 16 * 1024);
+    const size_t file_size = 4 * 1024 * 1024;
+    std::string content(file_size, 'f');
+    for (size_t i = 0; i < file_size; i += 4096) {
+      content[i] = static_cast<char>('a' + (i / 4096) % 26);
+    }
+    FILE *file = tmpfile();
+    REQUIRE(file != nullptr);
+    REQUIRE(fwrite(content.data(), 1, content.size(), file) == content.size());
+    fflush(file);
+    conn.WriteToWriteBuffer("head");
+    CHECK(conn.SendFile(fileno(file), 0, file_size));
+    // the caller is free to close its fd right away
+    fclose(file);
+    conn.WriteToWriteBuffer("tail");
+    CHECK(conn.GetWriteBufferSize() == 4);
+    CHECK(conn.GetPendingSize() > 4);
+    CHECK(conn.GetBytesOut() == file_size + 8);
+    // the file tail counts toward the watermarks
+    CHECK(conn.IsReadPaused());
+    std::string received;
+    char buf[4096];
+    while (received.size() < file_size + 8) {
+      ssize_t got;
+      while ((got = recv(pair_fds[1], buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        received.append(buf, got);
+      }
+      conn.Send();
+    }
+    CHECK(conn.GetPendingSize() == 0);
+    CHECK(received == "head" + content + "tail");
+    CHECK_FALSE(conn.IsReadPaused());
+    close(pair_fds[1]);
+  }
+
+  SECTION("a file slice neither sent nor queued drops whatever pending and closes the connection") {
+    int pair_fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fds) == 0);
+    auto sock = std::make_unique<Socket>(pair_fds[0]);
+    sock->SetNonBlocking();
+    Connection conn(std::move(sock));
+    // nothing pending, so the bad fd fails sendfile() right away
+    CHECK_FALSE(conn.SendFile(-1, 0, 16));
+    CHECK(conn.IsClosing());
+    CHECK(conn.GetPendingSize() == 0);
+    // something pending, so the bad fd fails to be kept as a file tail
+    Connection full_conn(std::make_unique<Socket>(pair_fds[1]));
+    full_conn.GetSocket()->SetNonBlocking();
+    full_conn.WriteToWriteBuffer(std::string(4 * 1024 * 1024, 'x'));
+    full_conn.Send();
+    REQUIRE(full_conn.GetPendingSize() > 0);
+    auto bytes_out = full_conn.GetBytesOut();
+    CHECK_FALSE(full_conn.SendFile(-1, 0, 16));
+    CHECK(full_conn.IsClosing());
+    CHECK(full_conn.GetPendingSize() == 0);
+    CHECK(full_conn.GetBytesOut() == bytes_out);
+  }
 }
@@ -10,16 +10,20 @@
 
 #include "core/looper.h"
 
+#include <sys/socket.h>
 #include <unistd.h>
 
 #include <atomic>
+#include <chrono>  // NOLINT
 #include <memory>
+#include <string>
 #include <numeric>
 #include <thread>  // NOLINT
 #include <vector>
 
 #include "catch2/catch_test_macros.hpp"
 #include "core/connection.h"
+#include "core/metrics.h"
 #include "core/net_address.h"
 #include "core/poller.h"
 #include "core/socket.h"
@@ -27,6 +31,7 @@
 /* for convenience reason */
 using TURTLE_SERVER::Connection;
 using TURTLE_SERVER::Looper;
+using TURTLE_SERVER::MetricsRegistry;
 using TURTLE_SERVER::NetAddress;
 using TURTLE_SERVER::POLL_ADD;
 using TURTLE_SERVER::POLL_ET;
@@ -81,4 +86,92 @@ TEST_CASE("[core/looper]") {
       threads[i].join();
     }
   }
+
+  SECTION("a connection missing its deadline is kicked out, unless the deadline is cleared") {
+    int pipe_fds[2];
+    REQUIRE(pipe(pipe_fds) == 0);
+    int kicked_fd = pipe_fds[0];
+    auto kicked_conn = std::make_unique<Connection>(std::make_unique<Socket>(kicked_fd));
+    kicked_conn->SetEvents(POLL_READ);
+    kicked_conn->SetCallback([](Connection *) {});
+    looper.AddConnection(std::move(kicked_conn));
+    int kept_fd = pipe_fds[1];
+    auto kept_conn = std::make_unique<Connection>(std::make_unique<Socket>(kept_fd));
+    kept_conn->SetCallback([](Connection *) {});
+    looper.AddConnection(std::move(kept_conn));
+    looper.SetDeadline(kicked_fd, 100);
+    looper.SetDeadline(kept_fd, 100);
+    looper.ClearDeadline(kept_fd);
+
+    std::thread runner([&]() { looper.Loop(); });
+    sleep(1);
+    looper.SetExit();
+    runner.join();
+    CHECK(looper.FindConnection(kicked_fd) == nullptr);
+    CHECK(looper.FindConnection(kept_fd) != nullptr);
+  }
+
+  SECTION("pending writes are flushed once writable, before a closing connection is deleted") {
+    int pair_fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fds) == 0);
+    int server_fd = pair_fds[0];
+    auto server_sock = std::make_unique<Socket>(server_fd);
+    server_sock->SetNonBlocking();
+    auto server_conn = std::make_unique<Connection>(std::move(server_sock));
+    auto *server_raw = server_conn.get();
+    server_conn->SetEvents(POLL_READ | POLL_ET);
+    server_conn->SetCallback([](Connection *) {});
+    server_conn->SetLooper(&looper);
+    looper.AddConnection(std::move(server_conn));
+    // far more than the socket buffer could take at once
+    const size_t total = 4 * 1024 * 1024;
+    server_raw->WriteToWriteBuffer(std::vector<unsigned char>(total, 'x'));
+    server_raw->Send();
+    CHECK(server_raw->GetWriteBufferSize() > 0);
+    looper.CloseConnection(server_fd);
+    CHECK(looper.FindConnection(server_fd) != nullptr);
+
+    std::thread runner([&]() { looper.Loop(); });
+    size_t received = 0;
+    char buf[4096];
+    ssize_t got;
+    while ((got = read(pair_fds[1], buf, sizeof(buf))) > 0) {
+      received += got;
+    }
+    looper.SetExit();
+    runner.join();
+    close(pair_fds[1]);
+    CHECK(received == total);
+    CHECK(looper.FindConnection(server_fd) == nullptr);
+  }
+
+  SECTION("a slow callback is logged and counted, and the slowest one exposed with its fd") {
+    int pipe_fds[2];
+    REQUIRE(pipe(pipe_fds) == 0);
+    int slow_fd = pipe_fds[0];
+    auto slow_conn = std::make_unique<Connection>(std::make_unique<Socket>(slow_fd));
+    slow_conn->SetEvents(POLL_READ);
+    slow_conn->SetCallback([](Connection *conn) {
+      char byte;
+      CHECK(read(conn->GetFd(), &byte, 1) == 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    looper.AddConnection(std::move(slow_conn));
+    looper.SetSlowCallbackThreshold(5000);
+    REQUIRE(write(pipe_fds[1], "x", 1) == 1);
+
+    std::thread runner([&]() { looper.Loop(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    looper.SetExit();
+    runner.join();
+    close(pipe_fds[1]);
+    // declared again with the same labels, the same metrics of this looper
+    auto &registry = MetricsRegistry::GetInstance();
+    auto labels = "looper=\"" + std::to_string(looper.GetId()) + "\"";
+    CHECK(registry.Read(registry.AddCounter("turtle_looper_slow_callbacks_total", "", labels)) == 1);
+    CHECK(registry.Read(registry.AddGauge("turtle_looper_slowest_callback_us", "", labels)) >= 20000);
+    CHECK(registry.Read(registry.AddGauge("turtle_looper_slowest_callback_fd", "", labels)) == slow_fd);
+    CHECK(registry.Read(registry.AddCounter("turtle_looper_ready_events_total", "", labels)) >= 1);
+    CHECK(registry.Read(registry.AddCounter("turtle_looper_busy_us_total", "", labels)) >= 20000);
+  }
 }
@@ -0,0 +1,97 @@
+/**
+ * @file metrics_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for core/MetricsRegistry class
+ */
+
+#include "core/metrics.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::HISTOGRAM_BUCKETS;
+using TURTLE_SERVER::HistogramBucket;
+using TURTLE_SERVER::HistogramBucketUpperBound;
+using TURTLE_SERVER::MetricsRegistry;
+
+TEST_CASE("[core/metrics]") {
+  auto &registry = MetricsRegistry::GetInstance();
+
+  SECTION("each bucket holds the values up to its upper bound, within 1/16 of them") {
+    CHECK(HistogramBucket(0) == 0);
+    CHECK(HistogramBucket(15) == 15);
+    CHECK(HistogramBucket(16) == 16);
+    CHECK(HistogramBucket(UINT64_MAX) == HISTOGRAM_BUCKETS - 1);
+    CHECK(HistogramBucketUpperBound(HISTOGRAM_BUCKETS - 1) == UINT64_MAX);
+    for (uint64_t value : {uint64_t{1}, uint64_t{17}, uint64_t{1000}, uint64_t{123456789}, uint64_t{1} << 40}) {
+      auto bucket = HistogramBucket(value);
+      CHECK(HistogramBucketUpperBound(bucket) >= value);
+      CHECK(HistogramBucketUpperBound(bucket) - value <= value / 16);
+      CHECK(HistogramBucketUpperBound(bucket - 1) < value);
+    }
+  }
+
+  SECTION("the per-thread values are merged upon a read") {
+    auto counter = registry.AddCounter("test_merged_total", "test counter");
+    auto gauge = registry.AddGauge("test_merged_gauge", "test gauge");
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      threads.emplace_back([counter, gauge]() {
+        for (int j = 0; j < 1000; j++) {
+          counter.Inc();
+        }
+        gauge.Inc();
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    // a gauge could go down on another thread than where it went up
+    gauge.Add(-5);
+    CHECK(registry.Read(counter) == 4000);
+    CHECK(registry.Read(gauge) == -1);
+    // declared again, the same one
+    CHECK(registry.Read(registry.AddCounter("test_merged_total", "test counter")) == 4000);
+  }
+
+  SECTION("the histogram quantiles are within a bucket of the exact ones") {
+    auto histogram = registry.AddHistogram("test_latency_us", "test histogram");
+    for (uint64_t i = 1; i <= 1000; i++) {
+      histogram.Record(i);
+    }
+    auto snapshot = registry.Read(histogram);
+    CHECK(snapshot.count_ == 1000);
+    CHECK(snapshot.sum_ == 500500);
+    CHECK(snapshot.Quantile(0.5) >= 500);
+    CHECK(snapshot.Quantile(0.5) <= 500 + 500 / 16);
+    CHECK(snapshot.Quantile(0.99) >= 990);
+    CHECK(snapshot.Quantile(1.0) >= 1000);
+  }
+
+  SECTION("the exposition is grouped by name with the labels, and the histogram buckets are cumulative") {
+    registry.AddCounter("test_requests_total", "test requests", "status=\"200\"").Inc(3);
+    registry.AddCounter("test_requests_total", "test requests", "status=\"404\"").Inc();
+    auto histogram = registry.AddHistogram("test_batch_size", "test batch", "", 4);
+    histogram.Record(0);
+    histogram.Record(3);
+    histogram.Record(100);
+    std::string out;
+    registry.Expose(out);
+    CHECK(out.find("# HELP test_requests_total test requests\n# TYPE test_requests_total counter\n"
+                   "test_requests_total{status=\"200\"} 3\ntest_requests_total{status=\"404\"} 1\n") !=
+          std::string::npos);
+    CHECK(out.find("# TYPE test_batch_size histogram\n"
+                   "test_batch_size_bucket{le=\"0\"} 1\ntest_batch_size_bucket{le=\"1\"} 1\n"
+                   "test_batch_size_bucket{le=\"3\"} 2\ntest_batch_size_bucket{le=\"7\"} 2\n"
+                   "test_batch_size_bucket{le=\"15\"} 2\ntest_batch_size_bucket{le=\"+Inf\"} 3\n"
+                   "test_batch_size_sum 103\ntest_batch_size_count 3\n") != std::string::npos);
+  }
+}
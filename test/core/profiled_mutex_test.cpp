@@ -0,0 +1,83 @@
+/**
+ * @file profiled_mutex_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for core/ProfiledMutex class
+ */
+
+#include "core/profiled_mutex.h"
+
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
+#include <shared_mutex>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/metrics.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::LockProfiler;
+using TURTLE_SERVER::MetricsRegistry;
+using TURTLE_SERVER::ProfiledMutex;
+
+TEST_CASE("[core/profiled_mutex]") {
+  SECTION("every acquisition is counted, and the waits behind a holder are contended") {
+    ProfiledMutex<std::mutex> mtx("test_exclusive");
+    auto *profile = LockProfiler::GetInstance().GetProfile("test_exclusive");
+    std::thread holder;
+    {
+      std::unique_lock<ProfiledMutex<std::mutex>> lock(mtx);
+      holder = std::thread([&mtx]() { std::unique_lock<ProfiledMutex<std::mutex>> lock(mtx); });
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    holder.join();
+    CHECK(profile->acquisitions_ == 2);
+    CHECK(profile->contended_ == 1);
+    CHECK(profile->wait_.sum_ >= 40'000'000);
+    CHECK(profile->hold_.sum_ >= 50'000'000);
+    // declared again by the same name, the same profile
+    ProfiledMutex<std::mutex> same("test_exclusive");
+    same.lock();
+    same.unlock();
+    CHECK(profile->acquisitions_ == 3);
+  }
+
+  SECTION("a shared mutex is profiled for both the exclusive and the shared acquisitions") {
+    ProfiledMutex<std::shared_mutex> mtx("test_shared");
+    auto *profile = LockProfiler::GetInstance().GetProfile("test_shared");
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; i++) {
+      readers.emplace_back([&mtx]() {
+        for (int j = 0; j < 1000; j++) {
+          std::shared_lock<ProfiledMutex<std::shared_mutex>> lock(mtx);
+        }
+      });
+    }
+    for (int j = 0; j < 1000; j++) {
+      std::unique_lock<ProfiledMutex<std::shared_mutex>> lock(mtx);
+    }
+    for (auto &reader : readers) {
+      reader.join();
+    }
+    CHECK(profile->acquisitions_ == 5000);
+    CHECK(profile->contended_ <= 5000);
+  }
+
+  SECTION("the profiles are exposed along with the metrics") {
+    ProfiledMutex<std::mutex> mtx("test_exposed");
+    mtx.lock();
+    mtx.unlock();
+    std::string out;
+    MetricsRegistry::GetInstance().Expose(out);
+    CHECK(out.find("# TYPE turtle_lock_acquisitions_total counter\n") != std::string::npos);
+    CHECK(out.find("turtle_lock_acquisitions_total{lock=\"test_exposed\"} 1\n") != std::string::npos);
+    CHECK(out.find("turtle_lock_contended_total{lock=\"test_exposed\"} 0\n") != std::string::npos);
+    CHECK(out.find("turtle_lock_wait_ns_bucket{lock=\"test_exposed\",le=\"0\"} 1\n") != std::string::npos);
+    CHECK(out.find("turtle_lock_hold_ns_count{lock=\"test_exposed\"} 1\n") != std::string::npos);
+  }
+}
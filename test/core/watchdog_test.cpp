@@ -0,0 +1,85 @@
+/**
+ * @file watchdog_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for core/Watchdog class
+ */
+
+#include "core/watchdog.h"
+
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/poller.h"
+#include "core/socket.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::Connection;
+using TURTLE_SERVER::Looper;
+using TURTLE_SERVER::MetricsRegistry;
+using TURTLE_SERVER::POLL_READ;
+using TURTLE_SERVER::Socket;
+using TURTLE_SERVER::Watchdog;
+
+/* the stalls reported of a looper so far */
+auto ReadStalls(const Looper &looper) -> uint64_t {
+  auto labels = "looper=\"" + std::to_string(looper.GetId()) + "\"";
+  return MetricsRegistry::GetInstance().Read(
+      MetricsRegistry::GetInstance().AddCounter("turtle_looper_stalls_total", "", labels));
+}
+
+TEST_CASE("[core/watchdog]") {
+  Looper looper;
+  int pipe_fds[2];
+  REQUIRE(pipe(pipe_fds) == 0);
+  int blocked_fd = pipe_fds[0];
+  auto blocked_conn = std::make_unique<Connection>(std::make_unique<Socket>(blocked_fd));
+  blocked_conn->SetEvents(POLL_READ);
+  blocked_conn->SetCallback([](Connection *conn) {
+    char byte;
+    CHECK(read(conn->GetFd(), &byte, 1) == 1);
+    // blocking the looper, and interrupted by the watchdog for a backtrace in the middle
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  });
+  looper.AddConnection(std::move(blocked_conn));
+
+  SECTION("a looper blocked beyond the threshold is reported once per stall") {
+    {
+      Watchdog watchdog(std::chrono::milliseconds(50));
+      watchdog.Watch(&looper);
+      std::thread runner([&]() { looper.Loop(); });
+      REQUIRE(write(pipe_fds[1], "x", 1) == 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      REQUIRE(write(pipe_fds[1], "x", 1) == 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      looper.SetExit();
+      runner.join();
+    }
+    CHECK(ReadStalls(looper) == 2);
+    CHECK(looper.GetHeartbeat().busy_since_ == 0);
+  }
+
+  SECTION("an idle looper, or one within the threshold, is never reported") {
+    {
+      Watchdog watchdog(std::chrono::milliseconds(1000));
+      watchdog.Watch(&looper);
+      std::thread runner([&]() { looper.Loop(); });
+      REQUIRE(write(pipe_fds[1], "x", 1) == 1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      looper.SetExit();
+      runner.join();
+    }
+    CHECK(ReadStalls(looper) == 0);
+  }
+  close(pipe_fds[1]);
+}
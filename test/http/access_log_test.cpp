@@ -0,0 +1,118 @@
+/**
+ * @file access_log_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/AccessLog class
+ */
+
+#include "http/access_log.h"
+
+#include <algorithm>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::LogBlock;
+using TURTLE_SERVER::HTTP::AccessLog;
+using TURTLE_SERVER::HTTP::AccessLogFormat;
+using TURTLE_SERVER::HTTP::AccessRecord;
+using TURTLE_SERVER::HTTP::FormatAccessRecord;
+using TURTLE_SERVER::HTTP::Method;
+using TURTLE_SERVER::HTTP::Version;
+
+auto MakeRecord(const std::string &path) -> AccessRecord {
+  AccessRecord record;
+  record.SetClient("127.0.0.1");
+  record.SetRequest(Method::GET, Version::HTTP_1_1, path, "", "curl/8.0");
+  record.timestamp_ = 1000000;
+  record.status_ = 200;
+  record.bytes_ = 1234;
+  record.latency_ = 56;
+  return record;
+}
+
+auto Format(const AccessRecord &record, AccessLogFormat format) -> std::string {
+  LogBlock out;
+  FormatAccessRecord(record, format, out);
+  return {out.begin(), out.end()};
+}
+
+/* the line with its timestamp cut out, which depends on the local timezone */
+auto StripTimestamp(const std::string &line) -> std::string {
+  return line.substr(0, line.find('[')) + line.substr(line.find(']') + 1);
+}
+
+TEST_CASE("[http/access_log]") {
+  SECTION("a record is formatted in the common, combined and JSON format") {
+    auto record = MakeRecord("/index.html");
+    CHECK(StripTimestamp(Format(record, AccessLogFormat::COMMON)) ==
+          "127.0.0.1 - -  \"GET /index.html HTTP/1.1\" 200 1234\n");
+    CHECK(StripTimestamp(Format(record, AccessLogFormat::COMBINED)) ==
+          "127.0.0.1 - -  \"GET /index.html HTTP/1.1\" 200 1234 \"-\" \"curl/8.0\"\n");
+    CHECK(Format(record, AccessLogFormat::JSON) ==
+          R"({"time_us":1000000,"client":"127.0.0.1","method":"GET","path":"/index.html","status":200,)"
+          R"("bytes":1234,"latency_us":56,"referer":"","user_agent":"curl/8.0"})"
+          "\n");
+  }
+
+  SECTION("the request line carries the version of the request itself") {
+    AccessRecord record;
+    record.SetRequest(Method::HEAD, Version::UNSUPPORTED, "/", "", "");
+    record.status_ = 400;
+    CHECK(StripTimestamp(Format(record, AccessLogFormat::COMMON)) == "- - -  \"HEAD / UNSUPPORTED\" 400 -\n");
+  }
+
+  SECTION("a rejected request has no request line, and the unsafe bytes are escaped") {
+    AccessRecord rejected;
+    rejected.status_ = 431;
+    CHECK(StripTimestamp(Format(rejected, AccessLogFormat::COMMON)) == "- - -  \"-\" 431 -\n");
+    auto record = MakeRecord("/a\"b\x01");
+    CHECK(Format(record, AccessLogFormat::COMMON).find(R"("GET /a\x22b\x01 HTTP/1.1")") != std::string::npos);
+    CHECK(Format(record, AccessLogFormat::JSON).find(R"("path":"/a\"b\u0001")") != std::string::npos);
+  }
+
+  SECTION("the fields too long are truncated") {
+    auto record = MakeRecord(std::string(1000, 'a'));
+    CHECK(std::string(record.path_).size() == TURTLE_SERVER::HTTP::ACCESS_PATH_SIZE - 1);
+  }
+
+  SECTION("the records of all threads reach the sink, and a full ring drops instead of blocking") {
+    std::mutex mtx;
+    std::string written;
+    uint64_t dropped = 0;
+    {
+      AccessLog access_log(
+          AccessLogFormat::COMMON,
+          [&](const std::vector<LogBlock> &blocks) {
+            std::unique_lock<std::mutex> lock(mtx);
+            for (const auto &block : blocks) {
+              written.append(block.begin(), block.end());
+            }
+          },
+          8);
+      std::vector<std::thread> threads;
+      for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&access_log]() {
+          for (int j = 0; j < 1000; j++) {
+            access_log.Record(MakeRecord("/" + std::to_string(j)));
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      dropped = access_log.GetDropped();
+    }
+    // whatever was recorded is written out upon destruction
+    auto lines = static_cast<uint64_t>(std::count(written.begin(), written.end(), '\n'));
+    CHECK(lines > 0);
+    CHECK(lines + dropped == 4000);
+  }
+}
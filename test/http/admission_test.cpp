@@ -0,0 +1,57 @@
+/**
+ * @file admission_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/Admission module
+ */
+
+#include "http/admission.h"
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/poller.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::LooperLoad;
+using TURTLE_SERVER::HTTP::AdmissionLimits;
+using TURTLE_SERVER::HTTP::IsOverloaded;
+
+TEST_CASE("[http/admission]") {
+  AdmissionLimits limits;
+  limits.max_connections_ = 100;
+  limits.max_ready_backlog_ = 10;
+  limits.max_round_time_ = 50;
+  limits.max_outstanding_work_ = 4;
+
+  SECTION("a looper within every threshold is not overloaded") {
+    CHECK_FALSE(IsOverloaded(LooperLoad{}, limits));
+    CHECK_FALSE(IsOverloaded(LooperLoad{100, 10, 50, 4}, limits));
+  }
+
+  SECTION("a looper over any single threshold is overloaded") {
+    CHECK(IsOverloaded(LooperLoad{101, 0, 0, 0}, limits));
+    CHECK(IsOverloaded(LooperLoad{0, 11, 0, 0}, limits));
+    CHECK(IsOverloaded(LooperLoad{0, 0, 51, 0}, limits));
+    CHECK(IsOverloaded(LooperLoad{0, 0, 0, 5}, limits));
+  }
+
+  SECTION("a threshold of 0 disables its check") {
+    limits.max_connections_ = 0;
+    CHECK_FALSE(IsOverloaded(LooperLoad{1000000, 0, 0, 0}, limits));
+  }
+
+  SECTION("an idle looper reports no load") {
+    TURTLE_SERVER::Looper looper;
+    looper.BeginWork();
+    auto load = looper.GetLoad();
+    CHECK(load.connections_ == 0);
+    CHECK(load.ready_backlog_ == 0);
+    CHECK(load.outstanding_work_ == 1);
+    looper.EndWork();
+    CHECK(looper.GetLoad().outstanding_work_ == 0);
+  }
+}
@@ -0,0 +1,174 @@
+/**
+ * @file cgi_pool_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/CgiWorkerPool class
+ */
+
+#include "http/cgi_pool.h"
+
+#include <chrono>  // NOLINT
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/poller.h"
+#include "http/cgier.h"
+#include "http/http_utils.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::Looper;
+using TURTLE_SERVER::HTTP::Cgier;
+using TURTLE_SERVER::HTTP::CgiWorkerPool;
+using TURTLE_SERVER::HTTP::DEFAULT_CGI_TIMEOUT;
+using TURTLE_SERVER::HTTP::IsFileExists;
+
+using Output = std::optional<std::vector<unsigned char>>;
+
+/* run the program in an idle worker, and loop till its output arrives */
+auto RunOnLooper(CgiWorkerPool &pool, const std::string &path, const std::vector<std::string> &arguments)  // NOLINT
+    -> std::string {
+  Looper looper;
+  std::string ret_str;
+  REQUIRE(pool.RunAsync(
+      &looper, path, arguments,
+      [&](Output &&result) {
+        REQUIRE(result.has_value());
+        ret_str = std::string(result->begin(), result->end());
+        looper.SetExit();
+      },
+      DEFAULT_CGI_TIMEOUT));
+  looper.Loop();
+  return ret_str;
+}
+
+TEST_CASE("[http/cgi_pool]") {
+  // the workers are forked before the test spawns any thread
+  CgiWorkerPool pool{2};
+  REQUIRE(pool.Size() == 2);
+
+  SECTION("workers run the sample cgi programs") {
+    REQUIRE(IsFileExists("./add"));
+    REQUIRE(IsFileExists("./helloworld"));
+    CHECK(RunOnLooper(pool, "./add", {"1", "2"}) == "cgi program add(1, 2) = 3\n");
+    CHECK(RunOnLooper(pool, "./helloworld", {}) == "Hello World from no argument cgi program\n");
+  }
+
+  SECTION("RunAsync reads the reply on a looper and keeps the worker busy till then") {
+    Looper looper;
+    std::string add_str;
+    std::string hello_str;
+    int completed = 0;
+    REQUIRE(pool.RunAsync(
+        &looper, "./add", {"5", "6"},
+        [&](Output &&result) {
+          add_str = result.has_value() ? std::string(result->begin(), result->end()) : "";
+          if (++completed == 2) {
+            looper.SetExit();
+          }
+        },
+        DEFAULT_CGI_TIMEOUT));
+    Cgier cgier("./helloworld", {});
+    REQUIRE(cgier.RunAsync(&pool, &looper, [&](Output &&result) {
+      hello_str = result.has_value() ? std::string(result->begin(), result->end()) : "";
+      if (++completed == 2) {
+        looper.SetExit();
+      }
+    }));
+    // both workers are leased till their replies are read
+    CHECK(!pool.RunAsync(&looper, "./add", {"7", "8"}, [](Output &&) {}, DEFAULT_CGI_TIMEOUT));
+    looper.Loop();
+    CHECK(add_str == "cgi program add(5, 6) = 11\n");
+    CHECK(hello_str == "Hello World from no argument cgi program\n");
+    CHECK(pool.Size() == 2);
+    CgiWorkerPool empty_pool{0};
+    CHECK(!empty_pool.RunAsync(&looper, "./add", {"5", "6"}, [](Output &&) {}, DEFAULT_CGI_TIMEOUT));
+  }
+
+  SECTION("a missing program gives empty output and keeps the worker alive") {
+    CHECK(RunOnLooper(pool, "./no-such-program", {}).empty());
+    CHECK(pool.Size() == 2);
+  }
+
+  SECTION("a stream of requests is multiplexed to the workers as they become idle") {
+    const int request_count = 12;
+    Looper looper;
+    int issued = 0;
+    int completed = 0;
+    int correct = 0;
+    std::function<void()> issue = [&]() {
+      while (issued < request_count) {
+        auto expected =
+            "cgi program add(" + std::to_string(issued) + ", 1) = " + std::to_string(issued + 1) + "\n";
+        bool taken = pool.RunAsync(
+            &looper, "./add", {std::to_string(issued), "1"},
+            [&, expected](Output &&result) {
+              if (result.has_value() && std::string(result->begin(), result->end()) == expected) {
+                correct++;
+              }
+              if (++completed == request_count) {
+                looper.SetExit();
+              }
+              // the worker is handed back as soon as its reply is read
+              issue();
+            },
+            DEFAULT_CGI_TIMEOUT);
+        if (!taken) {
+          return;
+        }
+        issued++;
+      }
+    };
+    issue();
+    CHECK(issued == 2);
+    looper.Loop();
+    CHECK(correct == request_count);
+  }
+
+  SECTION("a program running too long is killed along with its worker, which the launcher replaces") {
+    Looper looper;
+    bool timed_out = false;
+    auto started = std::chrono::steady_clock::now();
+    REQUIRE(pool.RunAsync(
+        &looper, "/bin/sleep", {"5"},
+        [&](Output &&result) {
+          timed_out = !result.has_value();
+          looper.SetExit();
+        },
+        100));
+    looper.Loop();
+    CHECK(timed_out);
+    CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(5));
+    // the killed worker is retired, and its replacement is taken once passed back
+    for (int i = 0; i < 200 && pool.Size() < 2; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(pool.Size() == 2);
+    Looper serving_looper;
+    int completed = 0;
+    int correct = 0;
+    for (int i = 0; i < 2; i++) {
+      REQUIRE(pool.RunAsync(
+          &serving_looper, "./add", {"1", "2"},
+          [&](Output &&result) {
+            if (result.has_value() && std::string(result->begin(), result->end()) == "cgi program add(1, 2) = 3\n") {
+              correct++;
+            }
+            if (++completed == 2) {
+              serving_looper.SetExit();
+            }
+          },
+          DEFAULT_CGI_TIMEOUT));
+    }
+    serving_looper.Loop();
+    CHECK(correct == 2);
+  }
+}
@@ -10,10 +10,19 @@
 
 #include "http/cgier.h"
 
+#include <chrono>  // NOLINT
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "catch2/catch_test_macros.hpp"
+#include "core/connection.h"
+#include "core/looper.h"
+#include "core/poller.h"
 #include "http/http_utils.h"
 
 /* for convenience reason */
+using TURTLE_SERVER::Looper;
 using TURTLE_SERVER::HTTP::Cgier;
 using TURTLE_SERVER::HTTP::IsFileExists;
 
@@ -45,4 +54,47 @@ TEST_CASE("[http/response]") {
 
     CHECK(ret_str == expected_str);
   }
+
+  SECTION("cgi program run asynchronously on a looper") {
+    Looper looper;
+    Cgier cgier("./add", {"2", "3"});
+    std::string ret_str;
+    REQUIRE(cgier.RunAsync(&looper, [&](std::optional<std::vector<unsigned char>> &&result) {
+      REQUIRE(result.has_value());
+      ret_str = std::string(result->begin(), result->end());
+      looper.SetExit();
+    }));
+    // the looper exits once the output is collected
+    looper.Loop();
+    CHECK(ret_str == "cgi program add(2, 3) = 5\n");
+  }
+
+  SECTION("the cache key tells apart the arguments") {
+    CHECK(Cgier("./add", {"1", "2"}).GetCacheKey() == "./add&1&2");
+    CHECK(Cgier("./add", {"12"}).GetCacheKey() != Cgier("./add", {"1", "2"}).GetCacheKey());
+  }
+
+  SECTION("a missing program fails to spawn") {
+    Looper looper;
+    Cgier cgier("./no-such-program", {});
+    CHECK(!cgier.RunAsync(&looper, [](std::optional<std::vector<unsigned char>> &&) {}));
+    CHECK(cgier.Run().empty());
+  }
+
+  SECTION("a program running too long is killed and completes without output") {
+    Looper looper;
+    Cgier cgier("/bin/sleep", {"5"});
+    bool timed_out = false;
+    auto started = std::chrono::steady_clock::now();
+    REQUIRE(cgier.RunAsync(
+        &looper,
+        [&](std::optional<std::vector<unsigned char>> &&result) {
+          timed_out = !result.has_value();
+          looper.SetExit();
+        },
+        100));
+    looper.Loop();
+    CHECK(timed_out);
+    CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(5));
+  }
 }
@@ -0,0 +1,97 @@
+/**
+ * @file compressor_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/Compressor class
+ */
+
+#include "http/compressor.h"
+
+#include <zlib.h>
+
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/cache.h"
+#include "http/file_meta.h"
+#include "http/http_utils.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::Cache;
+using TURTLE_SERVER::HTTP::Compress;
+using TURTLE_SERVER::HTTP::Compressor;
+using TURTLE_SERVER::HTTP::DeleteFile;
+using TURTLE_SERVER::HTTP::Encoding;
+using TURTLE_SERVER::HTTP::EncodingQuality;
+using TURTLE_SERVER::HTTP::FileMetaCache;
+using TURTLE_SERVER::HTTP::IsCompressibleMime;
+using TURTLE_SERVER::HTTP::NegotiateEncoding;
+
+TEST_CASE("[http/compressor]") {
+  SECTION("negotiate the content coding from Accept-Encoding") {
+    CHECK(NegotiateEncoding("") == Encoding::IDENTITY);
+    CHECK(NegotiateEncoding("gzip, deflate, br") == Encoding::GZIP);
+    CHECK(NegotiateEncoding("deflate") == Encoding::DEFLATE);
+    CHECK(NegotiateEncoding("gzip;q=0.5, deflate;q=0.8") == Encoding::DEFLATE);
+    CHECK(NegotiateEncoding("gzip;q=0, deflate;q=0") == Encoding::IDENTITY);
+    CHECK(NegotiateEncoding("*") == Encoding::GZIP);
+    CHECK(NegotiateEncoding("br, identity") == Encoding::IDENTITY);
+    CHECK(EncodingQuality("deflate, gzip;q=0.3", Encoding::GZIP) > 0);
+    CHECK(EncodingQuality("deflate, *;q=0", Encoding::GZIP) == 0);
+    CHECK(IsCompressibleMime("text/html"));
+    CHECK(!IsCompressibleMime("image/png"));
+  }
+
+  SECTION("gzip compressed content inflates back to the original") {
+    std::vector<unsigned char> source(8192, 'a');
+    std::vector<unsigned char> compressed;
+    REQUIRE(Compress(source, Encoding::GZIP, compressed));
+    CHECK(compressed.size() < source.size());
+    CHECK(compressed[0] == 0x1f);  // gzip magic number
+    CHECK(compressed[1] == 0x8b);
+
+    z_stream stream{};
+    REQUIRE(inflateInit2(&stream, 15 + 16) == Z_OK);
+    std::vector<unsigned char> inflated(source.size());
+    stream.next_in = compressed.data();
+    stream.avail_in = compressed.size();
+    stream.next_out = inflated.data();
+    stream.avail_out = inflated.size();
+    CHECK(inflate(&stream, Z_FINISH) == Z_STREAM_END);
+    inflateEnd(&stream);
+    CHECK(inflated == source);
+  }
+
+  SECTION("a missed variant is compressed in background and cached") {
+    const std::string file_name = "compressor_test.html";
+    {
+      std::ofstream file(file_name);
+      file << std::string(4096, 'x');
+    }
+    auto cache = std::make_shared<Cache>();
+    Compressor compressor(cache);
+    CHECK(compressor.ShouldCompress("text/html", 4096));
+    CHECK(!compressor.ShouldCompress("text/html", 10));
+
+    auto cache_key = file_name + FileMetaCache::Stat(file_name)->etag_;
+    std::vector<unsigned char> variant;
+    CHECK(!compressor.TryLoad(file_name, cache_key, Encoding::GZIP, variant));
+    bool hit = false;
+    for (int i = 0; i < 100 && !hit; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      hit = compressor.TryLoad(file_name, cache_key, Encoding::GZIP, variant);
+    }
+    CHECK(hit);
+    CHECK(!variant.empty());
+    CHECK(variant.size() < 4096);
+    DeleteFile(file_name);
+  }
+}
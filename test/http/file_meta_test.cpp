@@ -0,0 +1,91 @@
+/**
+ * @file file_meta_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/FileMetaCache class
+ */
+
+#include "http/file_meta.h"
+
+#include <fstream>
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+#include "http/http_utils.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::HTTP::DeleteFile;
+using TURTLE_SERVER::HTTP::FileMetaCache;
+using TURTLE_SERVER::HTTP::IsNotModified;
+using TURTLE_SERVER::HTTP::IsRangeFresh;
+using TURTLE_SERVER::HTTP::ParseHttpDate;
+using TURTLE_SERVER::HTTP::ToHttpDate;
+
+TEST_CASE("[http/file_meta]") {
+  const std::string file_name = "file_meta_test.txt";
+  {
+    std::ofstream file(file_name);
+    file << "hello!";
+  }
+  FileMetaCache metas;
+
+  SECTION("metadata and validators are derived from stat() and remembered") {
+    auto meta = metas.Lookup(file_name);
+    REQUIRE(meta->exists_);
+    CHECK(meta->size_ == 6);
+    CHECK(meta->etag_.front() == '"');
+    CHECK(meta->etag_.back() == '"');
+    CHECK(ParseHttpDate(meta->last_modified_) == meta->mtime_);
+    CHECK(metas.Lookup(file_name) == meta);
+    CHECK(metas.Size() == 1);
+
+    auto missing = metas.Lookup("no_such_file.txt");
+    CHECK(!missing->exists_);
+  }
+
+  SECTION("a modified file gets a different entity tag") {
+    auto before = FileMetaCache::Stat(file_name);
+    {
+      std::ofstream file(file_name, std::ios::app);
+      file << "more";
+    }
+    auto after = FileMetaCache::Stat(file_name);
+    CHECK(after->size_ == 10);
+    CHECK(before->etag_ != after->etag_);
+  }
+
+  SECTION("a precompressed sibling is remembered only if not older than the file") {
+    CHECK(metas.Lookup(file_name)->gzip_sibling_ == nullptr);
+    {
+      std::ofstream file(file_name + ".gz");
+      file << "gz";
+    }
+    auto meta = FileMetaCache::Stat(file_name);
+    REQUIRE(meta->gzip_sibling_ != nullptr);
+    CHECK(meta->gzip_sibling_->size_ == 2);
+    DeleteFile(file_name + ".gz");
+  }
+
+  SECTION("conditional GET preconditions") {
+    auto meta = metas.Lookup(file_name);
+    CHECK(IsNotModified(meta->etag_, std::nullopt, *meta));
+    CHECK(IsNotModified("\"abc\", W/" + meta->etag_, std::nullopt, *meta));
+    CHECK(IsNotModified("*", std::nullopt, *meta));
+    CHECK(!IsNotModified("\"abc\"", std::nullopt, *meta));
+    // If-None-Match takes precedence over If-Modified-Since
+    CHECK(!IsNotModified("\"abc\"", meta->last_modified_, *meta));
+    CHECK(IsNotModified(std::nullopt, meta->last_modified_, *meta));
+    CHECK(!IsNotModified(std::nullopt, ToHttpDate(meta->mtime_ - 1), *meta));
+    CHECK(!IsNotModified(std::nullopt, "not a date", *meta));
+    CHECK(!IsNotModified(std::nullopt, std::nullopt, *meta));
+
+    CHECK(IsRangeFresh(meta->etag_, *meta));
+    CHECK(!IsRangeFresh("W/" + meta->etag_, *meta));
+    CHECK(IsRangeFresh(meta->last_modified_, *meta));
+  }
+
+  DeleteFile(file_name);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file header_map_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/HeaderMap class
+ */
+
+#include "http/header_map.h"
+
+#include <string>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::HTTP::HEADER_MAP_INLINE_CAPACITY;
+using TURTLE_SERVER::HTTP::HeaderId;
+using TURTLE_SERVER::HTTP::HeaderMap;
+using TURTLE_SERVER::HTTP::ToHeaderId;
+
+TEST_CASE("[http/header_map]") {
+  SECTION("well-known header names are interned case insensitively") {
+    CHECK(ToHeaderId("Host") == HeaderId::HOST);
+    CHECK(ToHeaderId("accept-encoding") == HeaderId::ACCEPT_ENCODING);
+    CHECK(ToHeaderId("IF-NONE-MATCH") == HeaderId::IF_NONE_MATCH);
+    CHECK(ToHeaderId("X-Custom") == HeaderId::UNKNOWN);
+  }
+
+  SECTION("lookup by id or by name, the first one wins upon repeat") {
+    HeaderMap headers;
+    headers.Add("Host", "localhost");
+    headers.Add("X-Trace", "abc");
+    headers.Add("host", "ignored");
+    CHECK(headers.Size() == 3);
+    CHECK(headers.Get(HeaderId::HOST).value() == "localhost");
+    CHECK(headers.Get("HOST").value() == "localhost");
+    CHECK(headers.Get("x-trace").value() == "abc");
+    CHECK(!headers.Get(HeaderId::RANGE).has_value());
+    CHECK(!headers.Get("X-Missing").has_value());
+    CHECK(headers.At(1).name_ == "X-Trace");
+    headers.Clear();
+    CHECK(headers.Size() == 0);
+    CHECK(!headers.Get(HeaderId::HOST).has_value());
+  }
+
+  SECTION("headers beyond the inline capacity are still kept in order") {
+    HeaderMap headers;
+    std::vector<std::string> names;
+    for (size_t i = 0; i < HEADER_MAP_INLINE_CAPACITY + 5; i++) {
+      names.push_back("X-Header-" + std::to_string(i));
+    }
+    for (const auto &name : names) {
+      headers.Add(name, name);
+    }
+    headers.Add("Range", "bytes=0-1");
+    CHECK(headers.Size() == names.size() + 1);
+    CHECK(headers.Get(names.back()).value() == names.back());
+    CHECK(headers.At(names.size() - 1).name_ == names.back());
+    CHECK(headers.Get(HeaderId::RANGE).value() == "bytes=0-1");
+  }
+}
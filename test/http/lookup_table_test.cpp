@@ -0,0 +1,61 @@
+/**
+ * @file lookup_table_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/PerfectHashTable class and the lookups built on it
+ */
+
+#include "http/lookup_table.h"
+
+#include <string_view>
+
+#include "catch2/catch_test_macros.hpp"
+#include "http/http_utils.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::HTTP::ExtensionToMime;
+using TURTLE_SERVER::HTTP::Method;
+using TURTLE_SERVER::HTTP::MIME_OCTET;
+using TURTLE_SERVER::HTTP::PerfectHashTable;
+using TURTLE_SERVER::HTTP::ToMethod;
+using TURTLE_SERVER::HTTP::ToMime;
+using TURTLE_SERVER::HTTP::ToVersion;
+using TURTLE_SERVER::HTTP::Version;
+
+TEST_CASE("[http/lookup_table]") {
+  SECTION("the table is built at compile time and is case insensitive") {
+    static constexpr PerfectHashTable<int, 3> table{
+        std::array<std::pair<std::string_view, int>, 3>{{{"one", 1}, {"two", 2}, {"three", 3}}}};
+    static_assert(table.IsPerfect());
+    static_assert(table.Find("TWO").value() == 2);
+    CHECK(table.Find("one").value() == 1);
+    CHECK(table.Find("Three").value() == 3);
+    CHECK(!table.Find("four").has_value());
+    CHECK(!table.Find("").has_value());
+  }
+
+  SECTION("method and version lookups are space and case insensitive") {
+    CHECK(ToMethod("GET") == Method::GET);
+    CHECK(ToMethod(" head ") == Method::HEAD);
+    CHECK(ToMethod("POST") == Method::UNSUPPORTED);
+    CHECK(ToMethod("GE") == Method::UNSUPPORTED);
+    CHECK(ToVersion("http/1.1") == Version::HTTP_1_1);
+    CHECK(ToVersion("HTTP/1.0") == Version::UNSUPPORTED);
+  }
+
+  SECTION("extensions map to their MIME types") {
+    CHECK(ExtensionToMime("html") == "text/html");
+    CHECK(ExtensionToMime("JS") == "text/javascript");
+    CHECK(ExtensionToMime("woff2") == "font/woff2");
+    CHECK(ExtensionToMime("wasm") == "application/wasm");
+    CHECK(ExtensionToMime("Mp4") == "video/mp4");
+    CHECK(ExtensionToMime("unknown") == MIME_OCTET);
+    CHECK(ToMime("/dir/index.html") == "text/html");
+    CHECK(ToMime("/dir/pic.SVG") == "image/svg+xml");
+    CHECK(ToMime("/dir.v1/README") == MIME_OCTET);
+    CHECK(ToMime("/noextension") == MIME_OCTET);
+  }
+}
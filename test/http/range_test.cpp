@@ -0,0 +1,68 @@
+/**
+ * @file range_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/Range class
+ */
+
+#include "http/range.h"
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::HTTP::Range;
+using TURTLE_SERVER::HTTP::RangeStatus;
+
+TEST_CASE("[http/range]") {
+  const size_t resource_size = 1000;
+
+  SECTION("single slice in first-last, open and suffix form") {
+    auto range = Range::ParseRange("bytes=0-499", resource_size);
+    REQUIRE(range.GetStatus() == RangeStatus::SATISFIABLE);
+    REQUIRE(range.GetSlices().size() == 1);
+    CHECK(range.GetSlices()[0].first_ == 0);
+    CHECK(range.GetSlices()[0].Length() == 500);
+    CHECK(range.ContentRange(range.GetSlices()[0]) == "bytes 0-499/1000");
+    CHECK(!range.IsMultipart());
+
+    range = Range::ParseRange("bytes=900-", resource_size);
+    REQUIRE(range.GetStatus() == RangeStatus::SATISFIABLE);
+    CHECK(range.GetSlices()[0].first_ == 900);
+    CHECK(range.GetSlices()[0].last_ == 999);
+
+    range = Range::ParseRange("bytes=-100", resource_size);
+    REQUIRE(range.GetStatus() == RangeStatus::SATISFIABLE);
+    CHECK(range.GetSlices()[0].first_ == 900);
+    CHECK(range.GetSlices()[0].last_ == 999);
+
+    // last position beyond the resource is truncated
+    range = Range::ParseRange("bytes=500-5000", resource_size);
+    REQUIRE(range.GetStatus() == RangeStatus::SATISFIABLE);
+    CHECK(range.GetSlices()[0].last_ == 999);
+  }
+
+  SECTION("multiple slices are sorted and coalesced") {
+    auto range = Range::ParseRange("bytes=500-599, 0-99, 50-149, 150-199", resource_size);
+    REQUIRE(range.GetStatus() == RangeStatus::SATISFIABLE);
+    REQUIRE(range.GetSlices().size() == 2);
+    CHECK(range.GetSlices()[0].first_ == 0);
+    CHECK(range.GetSlices()[0].last_ == 199);
+    CHECK(range.GetSlices()[1].first_ == 500);
+    CHECK(range.IsMultipart());
+    CHECK(range.PartTrailer().find("--") != std::string::npos);
+  }
+
+  SECTION("malformed Range is ignored while out of bound Range is unsatisfiable") {
+    CHECK(Range::ParseRange("items=0-10", resource_size).GetStatus() == RangeStatus::IGNORED);
+    CHECK(Range::ParseRange("bytes=abc-10", resource_size).GetStatus() == RangeStatus::IGNORED);
+    CHECK(Range::ParseRange("bytes=10-5", resource_size).GetStatus() == RangeStatus::IGNORED);
+    CHECK(Range::ParseRange("bytes=", resource_size).GetStatus() == RangeStatus::IGNORED);
+
+    auto range = Range::ParseRange("bytes=1000-1100", resource_size);
+    CHECK(range.GetStatus() == RangeStatus::UNSATISFIABLE);
+    CHECK(range.UnsatisfiedContentRange() == "bytes */1000");
+  }
+}
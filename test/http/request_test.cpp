@@ -15,8 +15,12 @@
 #include "http/http_utils.h"
 
 /* for convenience reason */
+using TURTLE_SERVER::HTTP::CheckRequestLimits;
+using TURTLE_SERVER::HTTP::HeaderId;
 using TURTLE_SERVER::HTTP::Method;
 using TURTLE_SERVER::HTTP::Request;
+using TURTLE_SERVER::HTTP::RequestLimits;
+using TURTLE_SERVER::HTTP::Status;
 using TURTLE_SERVER::HTTP::Version;
 
 TEST_CASE("[http/request]") {
@@ -91,4 +95,49 @@ TEST_CASE("[http/request]") {
     Request request_6{request_6_str};
     CHECK(!request_6.ShouldClose());
   }
+
+  SECTION("headers are looked up case insensitively with their values trimmed") {
+    std::string request_str =
+        "GET /dir/ HTTP/1.1\r\n"
+        "Host:  localhost:20080 \r\n"
+        "Accept-Encoding: gzip, deflate\r\n"
+        "X-Custom:value\r\n"
+        "\r\n";
+    Request request{request_str};
+    REQUIRE(request.IsValid());
+    CHECK(request.GetResourceUrl() == "/dir/index.html");
+    CHECK(request.GetHeader(HeaderId::HOST).value() == "localhost:20080");
+    CHECK(request.GetHeader("accept-encoding").value() == "gzip, deflate");
+    CHECK(request.GetHeader("x-custom").value() == "value");
+    CHECK(!request.GetHeader(HeaderId::RANGE).has_value());
+    CHECK(request.GetHeaders().size() == 3);
+
+    /* a header line without colon */
+    std::string invalid_str =
+        "GET /dir/ HTTP/1.1\r\n"
+        "Host localhost\r\n"
+        "\r\n";
+    Request invalid_request{invalid_str};
+    CHECK(!invalid_request.IsValid());
+  }
+
+  SECTION("request heads exceeding the limits are rejected") {
+    RequestLimits limits;
+    limits.max_request_line_ = 32;
+    limits.max_header_bytes_ = 128;
+    limits.max_header_count_ = 2;
+    std::string head =
+        "GET /index.html HTTP/1.1\r\n"
+        "Host: localhost\r\n"
+        "Connection: Keep-Alive\r\n"
+        "\r\n";
+    CHECK(!CheckRequestLimits(head, limits).has_value());
+    /* a partial head is checked as well */
+    CHECK(!CheckRequestLimits(head.substr(0, 30), limits).has_value());
+    CHECK(CheckRequestLimits("GET /" + std::string(40, 'a'), limits) == Status::URI_TOO_LONG);
+    CHECK(CheckRequestLimits("GET / HTTP/1.1\r\nCookie: " + std::string(120, 'a'), limits) ==
+          Status::REQUEST_HEADER_FIELDS_TOO_LARGE);
+    CHECK(CheckRequestLimits("GET / HTTP/1.1\r\nA: 1\r\nB: 2\r\nC: 3\r\n\r\n", limits) ==
+          Status::REQUEST_HEADER_FIELDS_TOO_LARGE);
+  }
 }
@@ -10,20 +10,33 @@
 
 #include "http/response.h"
 
+#include <memory>
+
 #include "catch2/catch_test_macros.hpp"
+#include "core/buffer.h"
+#include "core/connection.h"
+#include "core/socket.h"
 #include "http/header.h"
 #include "http/http_utils.h"
 
 /* for convenience reason */
+using TURTLE_SERVER::Buffer;
+using TURTLE_SERVER::Connection;
+using TURTLE_SERVER::NO_RESPONSE_STATUS;
+using TURTLE_SERVER::Socket;
 using TURTLE_SERVER::HTTP::Header;
 using TURTLE_SERVER::HTTP::HEADER_CONTENT_LENGTH;
+using TURTLE_SERVER::HTTP::HEADER_CONTENT_TYPE;
+using TURTLE_SERVER::HTTP::MIME_MULTIPART_BYTERANGES;
+using TURTLE_SERVER::HTTP::MIME_PROMETHEUS_TEXT;
+using TURTLE_SERVER::HTTP::MULTIPART_BOUNDARY;
 using TURTLE_SERVER::HTTP::Response;
-using TURTLE_SERVER::HTTP::RESPONSE_OK;
+using TURTLE_SERVER::HTTP::Status;
 
 TEST_CASE("[http/response]") {
   SECTION("response should be able to modify header on the fly") {
     std::string status = "200 Success";
-    Response response{RESPONSE_OK, false, std::string("nonexistent-file.txt")};
+    Response response{Status::OK, false, std::string("nonexistent-file.txt")};
     auto headers = response.GetHeaders();
     bool find = false;
     for (auto &h : headers) {
@@ -46,4 +59,81 @@ TEST_CASE("[http/response]") {
     CHECK(find);
     CHECK(value == new_val);
   }
+
+  SECTION("response should emit status line and common headers directly into a buffer") {
+    Response response{Status::NOT_FOUND, true, std::string("nonexistent-file.txt")};
+    Buffer buf;
+    response.Serialize(buf);
+    auto head = std::string(buf.ToStringView());
+    CHECK(head.rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+    CHECK(head.find("\r\nServer: Turtle/1.0\r\n") != std::string::npos);
+    CHECK(head.find("\r\nDate: ") != std::string::npos);
+    CHECK(head.find("\r\nConnection: Close\r\n") != std::string::npos);
+    CHECK(head.find("\r\nContent-Length: 0\r\n") != std::string::npos);
+    CHECK(head.size() > 4);
+    CHECK(head.substr(head.size() - 4) == "\r\n\r\n");
+  }
+
+  SECTION("the content type refers to a static MIME string, and a changed one is kept on its own") {
+    Response response{Status::OK, false, MIME_PROMETHEUS_TEXT, 0};
+    std::vector<unsigned char> buf;
+    response.Serialize(buf);
+    CHECK(std::string(buf.begin(), buf.end()).find("\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n") !=
+          std::string::npos);
+    CHECK(response.ChangeHeader(HEADER_CONTENT_TYPE, std::string("text/html")));
+    buf.clear();
+    response.Serialize(buf);
+    auto head = std::string(buf.begin(), buf.end());
+    CHECK(head.find("\r\nContent-Type: text/html\r\n") != std::string::npos);
+    CHECK(head.find("text/plain") == std::string::npos);
+    // the multipart type is joined with the boundary the parts are delimited by
+    CHECK(MIME_MULTIPART_BYTERANGES == std::string("multipart/byteranges; boundary=") + MULTIPART_BOUNDARY);
+  }
+
+  SECTION("response should keep the order of many extra headers beyond the inline storage") {
+    auto response = Response::Make304Response(false);
+    std::string long_value(200, 'x');
+    response.AddHeader("X-First", long_value);
+    response.AddHeader("X-Second", long_value);
+    response.AddHeader("X-Third", "3");
+    CHECK(response.ChangeHeader("X-Second", "2"));
+    CHECK_FALSE(response.ChangeHeader(HEADER_CONTENT_LENGTH, "1024"));
+    std::vector<unsigned char> buf;
+    response.Serialize(buf);
+    auto head = std::string(buf.begin(), buf.end());
+    CHECK(head.find("Content-Length") == std::string::npos);
+    auto first = head.find("X-First: " + long_value + "\r\n");
+    auto second = head.find("X-Second: 2\r\n");
+    auto third = head.find("X-Third: 3\r\n");
+    CHECK(first != std::string::npos);
+    CHECK(second != std::string::npos);
+    CHECK(third != std::string::npos);
+    CHECK((first < second && second < third));
+  }
+
+  SECTION("the overload and rate limit responses ask the client to retry later and close the connection") {
+    Buffer buf;
+    Response::Make503Response(3).Serialize(buf);
+    auto head = std::string(buf.ToStringView());
+    CHECK(head.rfind("HTTP/1.1 503 Service Unavailable\r\n", 0) == 0);
+    CHECK(head.find("\r\nRetry-After: 3\r\n") != std::string::npos);
+    CHECK(head.find("\r\nConnection: Close\r\n") != std::string::npos);
+    buf.Clear();
+    Response::Make429Response(1).Serialize(buf);
+    head = std::string(buf.ToStringView());
+    CHECK(head.rfind("HTTP/1.1 429 Too Many Requests\r\n", 0) == 0);
+    CHECK(head.find("\r\nRetry-After: 1\r\n") != std::string::npos);
+    CHECK(head.find("\r\nConnection: Close\r\n") != std::string::npos);
+  }
+
+  SECTION("a response serialized into a connection notes its status there for the request") {
+    Connection conn(std::make_unique<Socket>());
+    CHECK(conn.GetResponseStatus() == NO_RESPONSE_STATUS);
+    Response::Make404Response().Serialize(&conn);
+    CHECK(conn.GetResponseStatus() == static_cast<int>(Status::NOT_FOUND));
+    CHECK(std::string(conn.GetWriteBuffer()->ToStringView()).rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+    // the last one written to the request is the one taken
+    Response::Make429Response(1).Serialize(&conn);
+    CHECK(conn.GetResponseStatus() == static_cast<int>(Status::TOO_MANY_REQUESTS));
+  }
 }
@@ -0,0 +1,114 @@
+/**
+ * @file router_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for http/Router class
+ */
+
+#include "http/router.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "catch2/catch_test_macros.hpp"
+#include "core/buffer.h"
+#include "core/connection.h"
+#include "core/socket.h"
+#include "http/http_utils.h"
+#include "http/request.h"
+
+/* for convenience reason */
+using TURTLE_SERVER::Connection;
+using TURTLE_SERVER::Socket;
+using TURTLE_SERVER::HTTP::Method;
+using TURTLE_SERVER::HTTP::MOUNT_PARAM;
+using TURTLE_SERVER::HTTP::Request;
+using TURTLE_SERVER::HTTP::RouteHandler;
+using TURTLE_SERVER::HTTP::RouteParams;
+using TURTLE_SERVER::HTTP::Router;
+using TURTLE_SERVER::HTTP::Status;
+
+/* a handler that is told apart by whether it asks to close the connection */
+static auto MakeHandler(bool tag) -> RouteHandler {
+  return [tag](const Request &, const RouteParams &, Connection *) { return tag; };
+}
+
+/* run the matched handler to tell which one it is */
+static auto MatchTag(const Router &router, Method method, std::string_view path, RouteParams &params)  // NOLINT
+    -> std::optional<bool> {
+  const auto *handler = router.Match(method, path, params);
+  if (handler == nullptr) {
+    return std::nullopt;
+  }
+  Request request{std::string("GET / HTTP/1.1\r\n\r\n")};
+  return (*handler)(request, params, nullptr);
+}
+
+TEST_CASE("[http/router]") {
+  SECTION("static routes share the prefix in the trie and match exactly") {
+    Router router;
+    router.Get("/api/users", MakeHandler(true)).Get("/api/uptime", MakeHandler(false));
+    RouteParams params;
+    CHECK(MatchTag(router, Method::GET, "/api/users", params) == true);
+    CHECK(MatchTag(router, Method::GET, "/api/uptime", params) == false);
+    CHECK(!MatchTag(router, Method::GET, "/api/u", params).has_value());
+    CHECK(!MatchTag(router, Method::GET, "/api/users/1", params).has_value());
+    CHECK(!MatchTag(router, Method::HEAD, "/api/users", params).has_value());
+    CHECK(MatchTag(router, Method::GET, "/api/users?verbose=1", params) == true);
+  }
+
+  SECTION("parameters capture one segment, and static segments take priority") {
+    Router router;
+    router.Get("/users/:id/posts/:post", MakeHandler(false)).Get("/users/me/posts/:post", MakeHandler(true));
+    RouteParams params;
+    CHECK(MatchTag(router, Method::GET, "/users/42/posts/7", params) == false);
+    CHECK(params.Get("id").value() == "42");
+    CHECK(params.Get("post").value() == "7");
+    RouteParams me_params;
+    CHECK(MatchTag(router, Method::GET, "/users/me/posts/7", me_params) == true);
+    CHECK(!me_params.Get("id").has_value());
+    CHECK(me_params.Get("post").value() == "7");
+    RouteParams empty_params;
+    CHECK(!MatchTag(router, Method::GET, "/users//posts/7", empty_params).has_value());
+    CHECK(empty_params.Size() == 0);
+  }
+
+  SECTION("mounts capture the rest of the path and are the last resort") {
+    Router router;
+    router.Mount("/", MakeHandler(false)).Mount("/cgi-bin", MakeHandler(true)).Get("/health", MakeHandler(true));
+    RouteParams params;
+    CHECK(MatchTag(router, Method::GET, "/cgi-bin/add&1&2", params) == true);
+    CHECK(params.Get(MOUNT_PARAM).value() == "add&1&2");
+    RouteParams static_params;
+    CHECK(MatchTag(router, Method::HEAD, "/css/main.css", static_params) == false);
+    CHECK(static_params.Get(MOUNT_PARAM).value() == "css/main.css");
+    RouteParams health_params;
+    CHECK(MatchTag(router, Method::GET, "/health", health_params) == true);
+    RouteParams fallback_params;
+    CHECK(MatchTag(router, Method::GET, "/healthz", fallback_params) == false);
+  }
+
+  SECTION("malformed and conflicting routes are rejected at registration") {
+    Router router;
+    router.Get("/items/:id", MakeHandler(true));
+    CHECK_THROWS_AS(router.Get("/items/:id", MakeHandler(true)), std::logic_error);
+    CHECK_THROWS_AS(router.Get("/items/:name/detail", MakeHandler(true)), std::logic_error);
+    CHECK_THROWS_AS(router.Get("no-slash", MakeHandler(true)), std::logic_error);
+    CHECK_THROWS_AS(router.Get("/files/*", MakeHandler(true)), std::logic_error);
+  }
+
+  SECTION("an unmatched request is answered 404, whose status is noted on the connection") {
+    Router router;
+    router.Mount("/", MakeHandler(false));
+    Connection conn(std::make_unique<Socket>());
+    Request request{std::string("GET no-slash HTTP/1.1\r\n\r\n")};
+    CHECK(router.Dispatch(request, &conn));
+    CHECK(conn.GetResponseStatus() == static_cast<int>(Status::NOT_FOUND));
+    CHECK(std::string(conn.GetWriteBuffer()->ToStringView()).rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file log_file_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for log/LogFile class
+ */
+
+#include "log/log_file.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::LogBlock;
+using TURTLE_SERVER::LogFile;
+using TURTLE_SERVER::LogFileOptions;
+
+auto ReadWhole(const std::string &path) -> std::string {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+auto FileSize(const std::string &path) -> size_t {
+  struct stat st {};
+  stat(path.c_str(), &st);
+  return st.st_size;
+}
+
+TEST_CASE("[log/log_file]") {
+  char directory[] = "/tmp/turtle_log_file_XXXXXX";
+  REQUIRE(mkdtemp(directory) != nullptr);
+  LogFileOptions options;
+  options.path_ = std::string(directory) + "/TestLog";
+  options.rotate_size_ = 16 * 1024;
+  options.write_size_ = 4096;
+  options.retained_files_ = 3;
+  options.flush_interval_ = std::chrono::milliseconds(50);
+  const LogBlock line(1000, 'x');
+
+  SECTION("the logs are held back till a batch is full or the partial one is stale") {
+    LogFile log_file(".log", nullptr, options);
+    log_file.Write({line});
+    REQUIRE(log_file.GetFiles().size() == 1);
+    auto path = log_file.GetFiles().back();
+    CHECK(FileSize(path) == 0);
+    log_file.Write({line, line, line, line});
+    CHECK(FileSize(path) == 4096);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    log_file.Write({});
+    CHECK(FileSize(path) == 5000);
+    // the partial batch is rewritten in full at the same offset
+    log_file.Write({line, line, line, line});
+    CHECK(FileSize(path) == 8192);
+  }
+
+  SECTION("files are rotated by size with a header each, and only the latest ones are retained") {
+    std::vector<std::string> created;
+    {
+      LogFile log_file(".bin", [](LogBlock &header) { header.push_back('#'); }, options);
+      for (int i = 0; i < 100; i++) {
+        log_file.Write({line});
+        if (created.empty() || created.back() != log_file.GetFiles().back()) {
+          created.push_back(log_file.GetFiles().back());
+        }
+      }
+      CHECK(log_file.GetFiles().size() == 3);
+    }
+    // 16 lines per file after the 1-byte header
+    REQUIRE(created.size() == 7);
+    for (size_t i = 0; i < created.size(); i++) {
+      CHECK(std::filesystem::exists(created[i]) == (i + 3 >= created.size()));
+    }
+    auto content = ReadWhole(created.back());
+    CHECK(content.size() == 1 + 4 * 1000);
+    CHECK(content.front() == '#');
+    CHECK(ReadWhole(created[created.size() - 2]).size() == 1 + 16 * 1000);
+  }
+
+  SECTION("the files left by a previous run count towards the retention") {
+    std::string first;
+    {
+      LogFile log_file(".log", nullptr, options);
+      log_file.Write({line});
+      first = log_file.GetFiles().back();
+    }
+    CHECK(ReadWhole(first).size() == 1000);
+    LogFile log_file(".log", nullptr, options);
+    CHECK(log_file.GetFiles().size() == 1);
+    CHECK(log_file.GetFiles().front() == first);
+  }
+
+  std::filesystem::remove_all(directory);
+}
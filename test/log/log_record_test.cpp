@@ -0,0 +1,114 @@
+/**
+ * @file log_record_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for the log/log_record encoding and rendering
+ */
+
+#include "log/log_record.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::AppendFormatFrame;
+using TURTLE_SERVER::AppendRecordsFrame;
+using TURTLE_SERVER::DecodeBinaryLog;
+using TURTLE_SERVER::LOG_BINARY_MAGIC;
+using TURTLE_SERVER::LOG_BINARY_MAGIC_SIZE;
+using TURTLE_SERVER::LOG_RECORD_HEAD_SIZE;
+using TURTLE_SERVER::LogBlock;
+using TURTLE_SERVER::LogFormat;
+using TURTLE_SERVER::LogLevel;
+using TURTLE_SERVER::LogRenderMode;
+using TURTLE_SERVER::RenderLogRecords;
+
+/* encode a record the same way as the Logger */
+template <typename... Args>
+void AppendRecord(LogBlock &records, uint32_t format_id, LogLevel level, const Args &...args) {  // NOLINT
+  auto size = static_cast<uint32_t>(LOG_RECORD_HEAD_SIZE + (TURTLE_SERVER::LogArgSize(args) + ... + 0));
+  auto offset = records.size();
+  records.resize(offset + size);
+  char *out = TURTLE_SERVER::EncodeLogRecordHead(records.data() + offset, size, format_id, 1000000, level);
+  ((out = TURTLE_SERVER::EncodeLogArg(out, args)), ...);
+  REQUIRE(out == records.data() + records.size());
+}
+
+/* the rendered text after the timestamp, which depends on the local timezone */
+auto StripTimestamp(const LogBlock &out) -> std::string {
+  std::string text(out.begin(), out.end());
+  std::string stripped;
+  for (size_t pos = 0; pos < text.size();) {
+    auto line_end = text.find('\n', pos);
+    stripped += text.substr(text.find(']', pos) + 1, line_end + 1 - text.find(']', pos) - 1);
+    pos = line_end + 1;
+  }
+  return stripped;
+}
+
+TEST_CASE("[log/log_record]") {
+  std::vector<LogFormat> formats{{"client fd={} maps to reactor {}", "acceptor.cpp", 70},
+                                 {"{} {} {} {} {}", "test.cpp", 1}};
+  LogBlock records;
+  AppendRecord(records, 0, LogLevel::INFO, 14, size_t{1});
+  AppendRecord(records, 1, LogLevel::ERROR, std::string("a\"b"), 'c', true, 0.5, -3);
+
+  SECTION("records are rendered into text lines with the placeholders substituted") {
+    LogBlock out;
+    REQUIRE(RenderLogRecords({records.data(), records.size()}, formats, LogRenderMode::TEXT, out));
+    CHECK(StripTimestamp(out) == "INFO: client fd=14 maps to reactor 1\nERROR: a\"b c true 0.5 -3\n");
+  }
+
+  SECTION("records are rendered into JSON lines with escaped strings") {
+    LogBlock out;
+    REQUIRE(RenderLogRecords({records.data(), records.size()}, formats, LogRenderMode::JSON, out));
+    std::string json(out.begin(), out.end());
+    CHECK(json.find(R"({"time_us":1000000,"level":"INFO","file":"acceptor.cpp","line":70,)") == 0);
+    CHECK(json.find(R"("message":"client fd=14 maps to reactor 1","args":[14,1]})") != std::string::npos);
+    CHECK(json.find(R"("args":["a\"b","c",true,0.5,-3]})") != std::string::npos);
+  }
+
+  SECTION("a binary log file is decoded back, and a truncated one up to where it breaks") {
+    LogBlock file(LOG_BINARY_MAGIC, LOG_BINARY_MAGIC + LOG_BINARY_MAGIC_SIZE);
+    AppendFormatFrame(0, formats[0], file);
+    AppendFormatFrame(1, formats[1], file);
+    AppendRecordsFrame({records.data(), records.size()}, file);
+    LogBlock out;
+    REQUIRE(DecodeBinaryLog({file.data(), file.size()}, LogRenderMode::TEXT, out));
+    CHECK(StripTimestamp(out) == "INFO: client fd=14 maps to reactor 1\nERROR: a\"b c true 0.5 -3\n");
+
+    AppendRecordsFrame({records.data(), records.size()}, file);
+    out.clear();
+    CHECK_FALSE(DecodeBinaryLog({file.data(), file.size() - 1}, LogRenderMode::TEXT, out));
+    CHECK(StripTimestamp(out) == "INFO: client fd=14 maps to reactor 1\nERROR: a\"b c true 0.5 -3\n");
+
+    out.clear();
+    CHECK_FALSE(DecodeBinaryLog("not a log", LogRenderMode::TEXT, out));
+    CHECK(out.empty());
+  }
+
+  SECTION("a format frame with an id out of order is rejected as corrupted") {
+    for (uint32_t format_id : {uint32_t{0xFFFFFFFF}, uint32_t{1u << 30}, uint32_t{1}}) {
+      LogBlock file(LOG_BINARY_MAGIC, LOG_BINARY_MAGIC + LOG_BINARY_MAGIC_SIZE);
+      AppendFormatFrame(format_id, formats[0], file);
+      LogBlock out;
+      CHECK_FALSE(DecodeBinaryLog({file.data(), file.size()}, LogRenderMode::TEXT, out));
+      CHECK(out.empty());
+    }
+    // an id framed again is redefined in place
+    LogBlock file(LOG_BINARY_MAGIC, LOG_BINARY_MAGIC + LOG_BINARY_MAGIC_SIZE);
+    AppendFormatFrame(0, formats[1], file);
+    AppendFormatFrame(1, formats[1], file);
+    AppendFormatFrame(0, formats[0], file);
+    AppendRecordsFrame({records.data(), records.size()}, file);
+    LogBlock out;
+    REQUIRE(DecodeBinaryLog({file.data(), file.size()}, LogRenderMode::TEXT, out));
+    CHECK(StripTimestamp(out) == "INFO: client fd=14 maps to reactor 1\nERROR: a\"b c true 0.5 -3\n");
+  }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file logger_test.cpp
+ * @author Yukun J
+ * @expectation this implementation file should be compatible to compile in C++
+ * program on Linux
+ * @init_date Oct 19 2026
+ *
+ * This is the unit test file for log/Logger class and its per-thread LogBuffer
+ */
+
+#include "log/logger.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "catch2/catch_test_macros.hpp"
+
+/* for convenience reason */
+using TURTLE_SERVER::IsLogCompiledIn;
+using TURTLE_SERVER::LOG_BLOCK_SIZE;
+using TURTLE_SERVER::LogBlock;
+using TURTLE_SERVER::Logger;
+using TURTLE_SERVER::LogLevel;
+
+/* append a record of the given size filled with the given byte */
+auto AppendFilled(Logger::LogBuffer &buffer, size_t size, char fill) -> bool {  // NOLINT
+  return buffer.Append(size, [&](char *out) { memset(out, fill, size); });
+}
+
+TEST_CASE("[log/logger]") {
+  SECTION("a level disabled at runtime never evaluates its arguments") {
+    int evaluated = 0;
+    auto touch = [&evaluated]() { return ++evaluated; };
+    Logger::SetLevel(LogLevel::ERROR);
+    LOG_INFO("not evaluated {}", touch());
+    LOG_WARNING("not evaluated {}", touch());
+    CHECK(evaluated == 0);
+    LOG_ERROR("evaluated {}", touch());
+    CHECK(evaluated == (IsLogCompiledIn(LogLevel::ERROR) ? 1 : 0));
+    Logger::SetLevel(LogLevel::INFO);
+  }
+
+  SECTION("the buffer hands over the filled blocks and the partial one, and reuses them once recycled") {
+    Logger::LogBuffer buffer;
+    const size_t record_size = 1024;
+    size_t appended = 0;
+    while (!AppendFilled(buffer, record_size, 'a')) {
+      appended++;
+    }
+    // the record filling the block goes into a fresh one
+    CHECK(appended == LOG_BLOCK_SIZE / record_size);
+    std::vector<LogBlock> blocks;
+    buffer.Collect(blocks);
+    REQUIRE(blocks.size() == 2);
+    CHECK(blocks[0].size() == LOG_BLOCK_SIZE);
+    CHECK(blocks[1].size() == record_size);
+    CHECK(std::all_of(blocks[0].begin(), blocks[0].end(), [](char c) { return c == 'a'; }));
+    // nothing more till the next log
+    std::vector<LogBlock> none;
+    buffer.Collect(none);
+    CHECK(none.empty());
+    std::vector<const char *> recycled{blocks[0].data(), blocks[1].data()};
+    buffer.Recycle(blocks);
+    while (!AppendFilled(buffer, record_size, 'b')) {
+    }
+    std::vector<LogBlock> reused;
+    buffer.Collect(reused);
+    REQUIRE(reused.size() == 2);
+    // the block swapped in once the current one is filled is a recycled one, not a new allocation
+    CHECK(std::find(recycled.begin(), recycled.end(), reused[1].data()) != recycled.end());
+    CHECK(std::all_of(reused[1].begin(), reused[1].end(), [](char c) { return c == 'b'; }));
+  }
+
+  SECTION("an oversized record gets a block large enough of its own") {
+    Logger::LogBuffer buffer;
+    AppendFilled(buffer, 16, 'a');
+    CHECK(AppendFilled(buffer, 2 * LOG_BLOCK_SIZE, 'b'));
+    std::vector<LogBlock> blocks;
+    buffer.Collect(blocks);
+    REQUIRE(blocks.size() == 2);
+    CHECK(blocks[1].size() == 2 * LOG_BLOCK_SIZE);
+  }
+
+  SECTION("the buffer of an exited thread is drained, then dropped") {
+    Logger::LogBuffer buffer;
+    AppendFilled(buffer, 16, 'a');
+    buffer.Orphan();
+    CHECK(buffer.IsOrphaned());
+    std::vector<LogBlock> blocks;
+    buffer.Collect(blocks);
+    REQUIRE(blocks.size() == 1);
+    CHECK(blocks[0].size() == 16);
+    if (IsLogCompiledIn(LogLevel::ERROR)) {
+      // this thread's own buffer is registered first
+      LOG_ERROR("logger_test registers the main thread");
+      auto before = Logger::BufferCount();
+      std::thread([]() { LOG_ERROR("logger_test logs from a short-lived thread {}", 1); }).join();
+      // the writer drops it in the same round it collects it, at most IDLE_REFRESH_THRESHOLD later
+      for (int i = 0; i < 300 && Logger::BufferCount() > before; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      CHECK(Logger::BufferCount() == before);
+    }
+  }
+}